@@ -1,4 +1,3 @@
-
 #version 330 core
 out vec4 FragColor;
   
@@ -8,13 +7,60 @@ uniform sampler2D scene;
 uniform sampler2D bloomBlur;
 uniform float exposure;
 
+// the frame was rendered into the lower left renderScale part of the targets
+uniform vec2 renderScale = vec2(1.0);
+
+// Catmull-Rom filter in 9 bilinear taps, sharper than plain bilinear when upscaling.
+// Every tap is clamped to [uvMin, uvMax] so the 4x4 footprint never reaches past the rendered part
+vec3 sampleBicubic(sampler2D image, vec2 uv, vec2 uvMin, vec2 uvMax)
+{
+    vec2 size = vec2(textureSize(image, 0));
+    vec2 samplePosition = uv * size;
+    vec2 texPos1 = floor(samplePosition - 0.5) + 0.5;
+    vec2 f = samplePosition - texPos1;
+
+    vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+    vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+    vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+    vec2 w3 = f * f * (-0.5 + 0.5 * f);
+
+    vec2 w12 = w1 + w2;
+    vec2 offset12 = w2 / w12;
+
+    vec2 texPos0 = clamp((texPos1 - 1.0) / size, uvMin, uvMax);
+    vec2 texPos3 = clamp((texPos1 + 2.0) / size, uvMin, uvMax);
+    vec2 texPos12 = clamp((texPos1 + offset12) / size, uvMin, uvMax);
+
+    vec3 result = vec3(0.0);
+    result += texture(image, vec2(texPos0.x, texPos0.y)).rgb * w0.x * w0.y;
+    result += texture(image, vec2(texPos12.x, texPos0.y)).rgb * w12.x * w0.y;
+    result += texture(image, vec2(texPos3.x, texPos0.y)).rgb * w3.x * w0.y;
+
+    result += texture(image, vec2(texPos0.x, texPos12.y)).rgb * w0.x * w12.y;
+    result += texture(image, vec2(texPos12.x, texPos12.y)).rgb * w12.x * w12.y;
+    result += texture(image, vec2(texPos3.x, texPos12.y)).rgb * w3.x * w12.y;
+
+    result += texture(image, vec2(texPos0.x, texPos3.y)).rgb * w0.x * w3.y;
+    result += texture(image, vec2(texPos12.x, texPos3.y)).rgb * w12.x * w3.y;
+    result += texture(image, vec2(texPos3.x, texPos3.y)).rgb * w3.x * w3.y;
+
+    // the negative lobes can undershoot next to very bright pixels
+    return max(result, vec3(0.0));
+}
+
 void main()
 {             
-    vec3 hdrColor = texture(scene, v_TexCoords).rgb;      
-    vec3 bloomColor = texture(bloomBlur, v_TexCoords).rgb;
+    // stay inside the rendered part, the rest of the targets holds stale pixels
+    vec2 texel = 1.0 / vec2(textureSize(scene, 0));
+    vec2 uvMin = texel * 0.5;
+    vec2 uvMax = renderScale - texel * 0.5;
+    vec2 uv = clamp(v_TexCoords * renderScale, uvMin, uvMax);
+
+    vec3 hdrColor = renderScale.x < 1.0 ? sampleBicubic(scene, uv, uvMin, uvMax) : texture(scene, uv).rgb;
+    vec3 bloomColor = texture(bloomBlur, uv).rgb;
     hdrColor += bloomColor;
   
     // vec3 result = vec3(1.0) - exp(-hdrColor * exposure);
 
     FragColor = vec4(hdrColor, 1.0);
-}  
\ No newline at end of file
+}
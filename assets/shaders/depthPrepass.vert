@@ -0,0 +1,15 @@
+#version 330 core
+
+layout(location = 0) in vec3 position;
+
+#include "drawData.glsl"
+uniform mat4 viewProjMatrix;
+
+// must match the forward shaders bit for bit, the color pass tests with GL_EQUAL
+invariant gl_Position;
+
+void main()
+{
+    vec4 pos_world = modelMatrix * vec4(position, 1.0);
+    gl_Position = viewProjMatrix * pos_world;
+}
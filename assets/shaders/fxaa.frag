@@ -0,0 +1,49 @@
+#version 430 core
+// FXAA on the tone mapped image, run as the last full screen pass
+
+out vec4 FragColor;
+
+in vec2 v_TexCoords;
+
+uniform sampler2D image;
+uniform vec2 inverseScreenSize;
+
+#define FXAA_REDUCE_MIN (1.0 / 128.0)
+#define FXAA_REDUCE_MUL (1.0 / 8.0)
+#define FXAA_SPAN_MAX 8.0
+
+float luma(vec3 color)
+{
+    return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+void main()
+{
+    vec3 rgbM = texture(image, v_TexCoords).rgb;
+    float lumaNW = luma(texture(image, v_TexCoords + vec2(-1.0, -1.0) * inverseScreenSize).rgb);
+    float lumaNE = luma(texture(image, v_TexCoords + vec2(1.0, -1.0) * inverseScreenSize).rgb);
+    float lumaSW = luma(texture(image, v_TexCoords + vec2(-1.0, 1.0) * inverseScreenSize).rgb);
+    float lumaSE = luma(texture(image, v_TexCoords + vec2(1.0, 1.0) * inverseScreenSize).rgb);
+    float lumaM = luma(rgbM);
+
+    float lumaMin = min(lumaM, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+    float lumaMax = max(lumaM, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+
+    // blur direction runs along the edge, perpendicular to the luma gradient
+    vec2 direction;
+    direction.x = -((lumaNW + lumaNE) - (lumaSW + lumaSE));
+    direction.y = ((lumaNW + lumaSW) - (lumaNE + lumaSE));
+
+    float directionReduce = max((lumaNW + lumaNE + lumaSW + lumaSE) * (0.25 * FXAA_REDUCE_MUL), FXAA_REDUCE_MIN);
+    float inverseDirectionMin = 1.0 / (min(abs(direction.x), abs(direction.y)) + directionReduce);
+    direction = clamp(direction * inverseDirectionMin, vec2(-FXAA_SPAN_MAX), vec2(FXAA_SPAN_MAX)) * inverseScreenSize;
+
+    vec3 rgbA = 0.5 * (texture(image, v_TexCoords + direction * (1.0 / 3.0 - 0.5)).rgb +
+                       texture(image, v_TexCoords + direction * (2.0 / 3.0 - 0.5)).rgb);
+    vec3 rgbB = rgbA * 0.5 + 0.25 * (texture(image, v_TexCoords + direction * -0.5).rgb +
+                                     texture(image, v_TexCoords + direction * 0.5).rgb);
+
+    // the wider tap set crossed the edge, fall back to the narrow one
+    float lumaB = luma(rgbB);
+    FragColor = vec4((lumaB < lumaMin || lumaB > lumaMax) ? rgbA : rgbB, 1.0);
+}
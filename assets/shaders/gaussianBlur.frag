@@ -6,26 +6,30 @@ in vec2 v_TexCoords;
 uniform sampler2D image;
   
 uniform bool horizontal;
+// the frame was rendered into the lower left renderScale part of the targets
+uniform vec2 renderScale = vec2(1.0);
 uniform float weight[5] = float[] (0.227027, 0.1945946, 0.1216216, 0.054054, 0.016216);
 
 void main()
 {             
     vec2 tex_offset = 1.0 / textureSize(image, 0); 
-    vec3 result = texture(image, v_TexCoords).rgb * weight[0]; 
+    vec2 uv = v_TexCoords * renderScale;
+    vec2 uvMax = renderScale - tex_offset * 0.5;
+    vec3 result = texture(image, uv).rgb * weight[0]; 
     if(horizontal)
     {
         for(int i = 1; i < 5; ++i)
         {
-            result += texture(image, v_TexCoords + vec2(tex_offset.x * i, 0.0)).rgb * weight[i];
-            result += texture(image, v_TexCoords - vec2(tex_offset.x * i, 0.0)).rgb * weight[i];
+            result += texture(image, min(uv + vec2(tex_offset.x * i, 0.0), uvMax)).rgb * weight[i];
+            result += texture(image, uv - vec2(tex_offset.x * i, 0.0)).rgb * weight[i];
         }
     }
     else
     {
         for(int i = 1; i < 5; ++i)
         {
-            result += texture(image, v_TexCoords + vec2(0.0, tex_offset.y * i)).rgb * weight[i];
-            result += texture(image, v_TexCoords - vec2(0.0, tex_offset.y * i)).rgb * weight[i];
+            result += texture(image, min(uv + vec2(0.0, tex_offset.y * i), uvMax)).rgb * weight[i];
+            result += texture(image, uv - vec2(0.0, tex_offset.y * i)).rgb * weight[i];
         }
     }
     FragColor = vec4(result, 1.0);
@@ -0,0 +1,51 @@
+// Clustered point lights, see ClusteredLighting
+struct PointLight {
+    vec4 positionRange;  // xyz = position, w = cut-off range
+    vec4 color;
+    vec4 attenuation;    // x = constant, y = linear, z = quadratic
+};
+layout(std430, binding = 2) readonly buffer LightBuffer { PointLight lights[]; };
+layout(std430, binding = 3) readonly buffer ClusterBuffer { uvec2 clusters[]; }; // offset, count
+layout(std430, binding = 4) readonly buffer LightIndexBuffer { uint lightIndices[]; };
+
+const uvec3 CLUSTER_DIMS = uvec3(16, 9, 24); // must match ClusteredLighting
+uniform vec2 clusterTileSize;
+uniform float clusterNear;
+uniform float clusterFar;
+
+uint getClusterIndex() {
+    float ndcDepth = gl_FragCoord.z * 2.0 - 1.0;
+    float viewDepth = 2.0 * clusterNear * clusterFar / (clusterFar + clusterNear - ndcDepth * (clusterFar - clusterNear));
+    float slice = log(viewDepth / clusterNear) * float(CLUSTER_DIMS.z) / log(clusterFar / clusterNear);
+    uint z = min(uint(max(slice, 0.0)), CLUSTER_DIMS.z - 1u);
+    uvec2 tile = min(uvec2(gl_FragCoord.xy / clusterTileSize), CLUSTER_DIMS.xy - 1u);
+    return tile.x + CLUSTER_DIMS.x * (tile.y + CLUSTER_DIMS.y * z);
+}
+
+// accumulates the Phong terms of all point lights in the fragment's cluster
+void addClusteredPointLights(vec3 position, vec3 norm, vec3 viewDir, vec3 coefficients, float alpha,
+                             inout vec3 diffuseP, inout vec3 specularP) {
+    uvec2 cluster = clusters[getClusterIndex()];
+    for (uint i = 0u; i < cluster.y; ++i) {
+        PointLight light = lights[lightIndices[cluster.x + i]];
+
+        vec3 pointVec = light.positionRange.xyz - position;
+        float dist = length(pointVec);
+        vec3 pointDir = pointVec / dist;
+        float att = 1.0 / (
+        light.attenuation.x +
+        light.attenuation.y * dist +
+        light.attenuation.z * dist * dist
+        );
+        // fade out towards the cut-off range so cluster borders stay invisible
+        float fade = clamp(1.0 - pow(dist / light.positionRange.w, 4.0), 0.0, 1.0);
+        att *= fade * fade;
+
+        float diffP = max(dot(norm, pointDir), 0.0);
+        diffuseP += coefficients.y * diffP * light.color.rgb * att;
+
+        vec3 reflectDirP = reflect(-pointDir, norm);
+        float specP = pow(max(dot(viewDir, reflectDirP), 0.0), alpha);
+        specularP += coefficients.z * specP * light.color.rgb * att;
+    }
+}
@@ -0,0 +1,14 @@
+// The default dithered shadow: slope scaled bias, 5x5 PCF, softened and dithered edge
+#include "shadow.glsl"
+
+float calculateDitheredShadow(vec4 lightSpacePos, vec3 normal, vec3 lightDir) {
+    vec3 projCoords = getShadowCoords(lightSpacePos);
+    if (isOutsideShadowMap(projCoords))
+        return 1.0;
+
+    float bias = max(0.002 * (1.0 - dot(normal, lightDir)), 0.0003);
+    float shadow = sampleShadowPCF(projCoords, bias, 2);
+    shadow = smoothstep(0.2, 0.8, shadow);
+
+    return ditherShadow(shadow);
+}
@@ -0,0 +1,6 @@
+// per-draw values, written once per frame by DrawDataBuffer and bound with glBindBufferRange
+layout(std140) uniform DrawData {
+    mat4 modelMatrix;
+    mat3 normalMatrix;
+    uint materialIndex; // row of the MaterialTable
+};
@@ -0,0 +1,39 @@
+// Fog that hides the edges of the level, x and z fade out over fadingDistance past the playable area
+float getPlaneFogAmount(vec3 pos) {
+    float xNeg = -3.0;
+    float xPos = 30.0;
+    float zNeg = -10.0;
+    float zPos = 30.0;
+    float fadingDistance = 5.0;
+
+    float xFade;
+    if (pos.x < 0.0) {
+        float start = xNeg;
+        float end = xNeg - fadingDistance;
+        xFade = clamp((pos.x - start) / (end - start), 0.0, 1.0);
+    } else {
+        float start = xPos;
+        float end = xPos + fadingDistance;
+        xFade = clamp((pos.x - start) / (end - start), 0.0, 1.0);
+    }
+
+    float zFade;
+    if (pos.z < 0.0) {
+        float start = zNeg;
+        float end = zNeg - fadingDistance;
+        zFade = clamp((pos.z - start) / (end - start), 0.0, 1.0);
+    } else {
+        float start = zPos;
+        float end = zPos + fadingDistance;
+        zFade = clamp((pos.z - start) / (end - start), 0.0, 1.0);
+    }
+
+    return max(xFade, zFade);
+}
+
+// symmetric variant around the origin
+float getPlaneFogAmount(vec3 pos, float innerRadius, float outerRadius) {
+    float xFade = clamp((abs(pos.x) - innerRadius) / (outerRadius - innerRadius), 0.0, 1.0);
+    float zFade = clamp((abs(pos.z) - innerRadius) / (outerRadius - innerRadius), 0.0, 1.0);
+    return max(xFade, zFade);
+}
@@ -0,0 +1,5 @@
+struct DirectionalLight {
+    vec3 color;
+    vec3 direction;
+};
+uniform DirectionalLight dirL;
@@ -0,0 +1,47 @@
+#include "drawData.glsl"
+
+// one row per material, uploaded once by MaterialTable
+struct MaterialRecord {
+    vec4 colorAlpha;     // rgb = color, a = shininess
+    vec4 coefficients;   // x = ambient, y = diffuse, z = specular
+    uvec4 textureLayers; // x/y = diffuse bucket/layer, z/w = normal bucket/layer
+    uvec4 textureHandles; // xy = diffuse, zw = normal bindless handle
+};
+
+layout(std430, binding = 5) readonly buffer MaterialTable {
+    MaterialRecord materials[];
+};
+
+// the material index comes from a uniform block, so these reads are uniform across the draw
+#define materialColor (materials[materialIndex].colorAlpha.rgb)
+#define specularAlpha (materials[materialIndex].colorAlpha.a)
+#define materialCoefficients (materials[materialIndex].coefficients.xyz)
+
+#define MATERIAL_TEXTURE_NONE 0xFFFFFFFFu
+#define MATERIAL_TEXTURE_BUCKETS 8
+
+#ifndef BINDLESS_TEXTURES
+// size-bucketed texture arrays, bucket i is bound to texture unit MaterialTable::FIRST_ARRAY_UNIT + i
+uniform sampler2DArray materialTextureArrays[MATERIAL_TEXTURE_BUCKETS];
+#endif
+
+// a material without the texture reads black like the unbound texture unit it used to sample
+vec4 sampleMaterialTexture(uint bucket, uint layer, uvec2 handle, vec2 uv) {
+    if (layer == MATERIAL_TEXTURE_NONE)
+        return vec4(0.0, 0.0, 0.0, 1.0);
+#ifdef BINDLESS_TEXTURES
+    return texture(sampler2D(handle), uv);
+#else
+    return texture(materialTextureArrays[bucket], vec3(uv, float(layer)));
+#endif
+}
+
+vec4 sampleDiffuse(vec2 uv) {
+    MaterialRecord material = materials[materialIndex];
+    return sampleMaterialTexture(material.textureLayers.x, material.textureLayers.y, material.textureHandles.xy, uv);
+}
+
+vec4 sampleNormalMap(vec2 uv) {
+    MaterialRecord material = materials[materialIndex];
+    return sampleMaterialTexture(material.textureLayers.z, material.textureLayers.w, material.textureHandles.zw, uv);
+}
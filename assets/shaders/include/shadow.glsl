@@ -0,0 +1,38 @@
+// Shadow map helpers, the including shader declares `uniform sampler2D shadowMap`
+#include "bayer.glsl"
+
+vec3 getShadowCoords(vec4 lightSpacePos) {
+    lightSpacePos /= lightSpacePos.w;
+    return lightSpacePos.xyz * 0.5 + 0.5;
+}
+
+bool isOutsideShadowMap(vec3 projCoords) {
+    return projCoords.z > 1.0 || projCoords.x < 0.0 || projCoords.x > 1.0 || projCoords.y < 0.0 || projCoords.y > 1.0;
+}
+
+// fraction of the (2 * radius + 1)^2 PCF taps that are lit
+float sampleShadowPCF(vec3 projCoords, float bias, int radius) {
+    float shadow = 0.0;
+    vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
+    int count = 0;
+
+    for (int x = -radius; x <= radius; ++x) {
+        for (int y = -radius; y <= radius; ++y) {
+            vec2 offset = vec2(x, y) * texelSize;
+            float closestDepth = texture(shadowMap, projCoords.xy + offset).r;
+            shadow += projCoords.z > closestDepth + bias ? 0.0 : 1.0;
+            count++;
+        }
+    }
+
+    return shadow / float(count);
+}
+
+// turns the soft PCF edge into an ordered dither pattern
+float ditherShadow(float shadow) {
+    if (shadow > 0.0 && shadow < 1.0) {
+        float threshold = getBayerThreshold();
+        shadow = smoothstep(threshold - 0.1, threshold + 0.1, shadow);
+    }
+    return shadow;
+}
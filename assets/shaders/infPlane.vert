@@ -4,9 +4,9 @@ layout(location = 0) in vec3 position;
 layout(location = 1) in vec3 normal;
 layout(location = 2) in vec2 uv;
 
-uniform mat4 modelMatrix;
+#include "drawData.glsl"
 uniform mat4 viewProjMatrix;
-uniform mat3 normalMatrix;  
+invariant gl_Position;
 
 uniform mat4 lightSpaceMatrix;
 
@@ -10,9 +10,9 @@ out vec3 position_world;
 out vec3 normal_world;
 
 // Uniforms für Transformationen
-uniform mat4 modelMatrix;     
+#include "drawData.glsl"
 uniform mat4 viewProjMatrix;   
-uniform mat3 normalMatrix;     
+invariant gl_Position;
 
 void main() {
     // **Normale transformieren** (falls das Modell skaliert wurde)
@@ -0,0 +1,38 @@
+#version 430 core
+// Robust contrast adaptive sharpening (after AMD FidelityFX FSR 1 RCAS), restores the detail
+// the upscale in the composite pass softens
+
+out vec4 FragColor;
+
+in vec2 v_TexCoords;
+
+uniform sampler2D image;
+// 0 = off, 1 = strongest
+uniform float sharpness;
+
+// keeps the negative lobe from ringing
+#define RCAS_LIMIT (0.25 - 1.0 / 16.0)
+
+void main()
+{
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    // texelFetch outside the image is undefined, the border rows and columns repeat themselves
+    ivec2 last = textureSize(image, 0) - 1;
+    vec3 b = texelFetch(image, clamp(p + ivec2(0, -1), ivec2(0), last), 0).rgb;
+    vec3 d = texelFetch(image, clamp(p + ivec2(-1, 0), ivec2(0), last), 0).rgb;
+    vec3 e = texelFetch(image, p, 0).rgb;
+    vec3 f = texelFetch(image, clamp(p + ivec2(1, 0), ivec2(0), last), 0).rgb;
+    vec3 h = texelFetch(image, clamp(p + ivec2(0, 1), ivec2(0), last), 0).rgb;
+
+    vec3 minRing = min(min(b, d), min(f, h));
+    vec3 maxRing = max(max(b, d), max(f, h));
+
+    // largest lobe that keeps the result inside the neighbourhood's range
+    vec3 hitMin = min(minRing, e) / (4.0 * maxRing + 1e-5);
+    vec3 hitMax = (1.0 - max(maxRing, e)) / (4.0 * minRing - 4.0 - 1e-5);
+    vec3 lobeRGB = max(-hitMin, hitMax);
+    float lobe = max(-RCAS_LIMIT, min(max(lobeRGB.r, max(lobeRGB.g, lobeRGB.b)), 0.0)) * sharpness;
+
+    vec3 color = (lobe * (b + d + f + h) + e) / (4.0 * lobe + 1.0);
+    FragColor = vec4(color, 1.0);
+}
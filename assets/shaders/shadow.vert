@@ -3,7 +3,7 @@
 layout (location = 0) in vec3 Position;  
 
 uniform mat4 lightSpaceMatrix;  
-uniform mat4 modelMatrix;
+#include "drawData.glsl"
 
 void main()
 {
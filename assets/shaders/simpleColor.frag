@@ -6,133 +6,41 @@ layout(location = 1) in vec3 te_normal_world;
 uniform sampler2D shadowMap; 
 uniform mat4 lightSpaceMatrix;
 
-uniform vec3 materialCoefficients;  
-uniform float specularAlpha;
-uniform vec3 materialColor;
-
-struct DirectionalLight {
-    vec3 color;
-    vec3 direction;
-};
-uniform DirectionalLight dirL;
-
-struct PointLight {
-    vec3 color;
-    vec3 position;
-    vec3 attenuation;
-};
-uniform PointLight pointL;
-
+#include "materials.glsl"
 uniform vec3 camera_world;
 
 layout (location = 0) out vec4 FragColor;
 layout (location = 1) out vec4 BrightColor;  
 
-const float bayerMatrix8x8[64] = float[64](
-    0.0/64.0, 48.0/64.0, 12.0/64.0, 60.0/64.0,  3.0/64.0, 51.0/64.0, 15.0/64.0, 63.0/64.0,
-    32.0/64.0, 16.0/64.0, 44.0/64.0, 28.0/64.0, 35.0/64.0, 19.0/64.0, 47.0/64.0, 31.0/64.0,
-    8.0/64.0, 56.0/64.0,  4.0/64.0, 52.0/64.0, 11.0/64.0, 59.0/64.0,  7.0/64.0, 55.0/64.0,
-    40.0/64.0, 24.0/64.0, 36.0/64.0, 20.0/64.0, 43.0/64.0, 27.0/64.0, 39.0/64.0, 23.0/64.0,
-    2.0/64.0, 50.0/64.0, 14.0/64.0, 62.0/64.0,  1.0/64.0, 49.0/64.0, 13.0/64.0, 61.0/64.0,
-    34.0/64.0, 18.0/64.0, 46.0/64.0, 30.0/64.0, 33.0/64.0, 17.0/64.0, 45.0/64.0, 29.0/64.0,
-    10.0/64.0, 58.0/64.0,  6.0/64.0, 54.0/64.0,  9.0/64.0, 57.0/64.0,  5.0/64.0, 53.0/64.0,
-    42.0/64.0, 26.0/64.0, 38.0/64.0, 22.0/64.0, 41.0/64.0, 25.0/64.0, 37.0/64.0, 21.0/64.0
-);
-
-float hash(vec2 p) {
-    return fract(sin(dot(p, vec2(127.1, 311.7))) * 43758.5453);
-}
-
+#include "lights.glsl"
+#include "clusteredLights.glsl"
+#include "shadow.glsl"
+#include "fog.glsl"
+#include "hash.glsl"
 
+// dithered shadow with a flat bias that only grows on steep slopes
 float calculateDitheredShadow(vec4 lightSpacePos, vec3 normal, vec3 lightDir) {
-    // normalize
-    lightSpacePos /= lightSpacePos.w;
-    vec3 projCoords = lightSpacePos.xyz * 0.5 + 0.5;
-
-    // clip everything around shadowMap
-    if (projCoords.z > 1.0 || projCoords.x < 0.0 || projCoords.x > 1.0 || projCoords.y < 0.0 || projCoords.y > 1.0)
+    vec3 projCoords = getShadowCoords(lightSpacePos);
+    if (isOutsideShadowMap(projCoords))
         return 1.0;
 
     float NdotL = clamp(dot(normal, lightDir), 0.0, 1.0);
     float slope = 1.0 - NdotL;
     float bias;
     if (slope < 0.5) {
-        bias = 0.0001;   
+        bias = 0.0001;
     }
     else {
-        
-        const float biasFlat  = 0.0002;  
-        const float biasSlope = 0.02;   
+        const float biasFlat  = 0.0002;
+        const float biasSlope = 0.02;
         bias = biasFlat + biasSlope * slope;
-        bias = clamp(bias, biasFlat, biasFlat + biasSlope); 
-        
+        bias = clamp(bias, biasFlat, biasFlat + biasSlope);
     }
 
-    // PCF 5×5
-    float shadow = 0.0;
-    vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
-    const int radius = 2;
-    int count = 0;
-
-    for (int x = -radius; x <= radius; ++x) {
-        for (int y = -radius; y <= radius; ++y) {
-            vec2 offset = vec2(x, y) * texelSize;
-            float closestDepth = texture(shadowMap, projCoords.xy + offset).r;
-            shadow += projCoords.z > closestDepth + bias ? 0.0 : 1.0;
-            count++;
-        }
-    }
-
-    shadow /= float(count);
-
-    // smoother gradiant
+    float shadow = sampleShadowPCF(projCoords, bias, 2);
     shadow = smoothstep(0.2, 0.8, shadow);
 
-    // dithering
-    int px = int(gl_FragCoord.x) % 8;
-    int py = int(gl_FragCoord.y) % 8;
-    float threshold = bayerMatrix8x8[py * 8 + px];
-
-    if (shadow > 0.0 && shadow < 1.0) {
-    int px = int(gl_FragCoord.x) % 8;
-    int py = int(gl_FragCoord.y) % 8;
-    float threshold = bayerMatrix8x8[py * 8 + px];
-
-    shadow = smoothstep(threshold - 0.1, threshold + 0.1, shadow);
-}
-
-    return shadow;
-}
-float getPlaneFogAmount(vec3 pos) {
-    float xNeg = -3.0;
-    float xPos = 30.0;
-    float zNeg = -10.0;
-    float zPos = 30.0;
-    float fadingDistance = 5.0;
-
-    float xFade;
-    if (pos.x < 0.0) {
-        float start = xNeg;
-        float end = xNeg - fadingDistance;
-        xFade = clamp((pos.x - start) / (end - start), 0.0, 1.0);
-    } else {
-        float start = xPos;
-        float end = xPos + fadingDistance;
-        xFade = clamp((pos.x - start) / (end - start), 0.0, 1.0);
-    }
-
-    float zFade;
-    if (pos.z < 0.0) {
-        float start = zNeg;
-        float end = zNeg - fadingDistance;
-        zFade = clamp((pos.z - start) / (end - start), 0.0, 1.0);
-    } else {
-        float start = zPos;
-        float end = zPos + fadingDistance;
-        zFade = clamp((pos.z - start) / (end - start), 0.0, 1.0);
-    }
-
-    return max(xFade, zFade);
+    return ditherShadow(shadow);
 }
 
 void main() {
@@ -148,22 +56,10 @@ void main() {
     float specD = pow(max(dot(viewDir, reflectDirD), 0.0), specularAlpha);
     vec3 specularD = materialCoefficients.z * specD * dirL.color;
 
-    // Point light
-    vec3 pointVec = pointL.position - te_position_world;
-    vec3 pointDir = normalize(pointVec);
-    float dist = length(pointVec);
-    float att = 1.0 / (
-    pointL.attenuation.x +
-    pointL.attenuation.y * dist +
-    pointL.attenuation.z * dist * dist
-    );
-
-    float diffP = max(dot(norm, pointDir), 0.0);
-    vec3 diffuseP = materialCoefficients.y * diffP * pointL.color * att;
-
-    vec3 reflectDirP = reflect(-pointDir, norm);
-    float specP = pow(max(dot(viewDir, reflectDirP), 0.0), specularAlpha);
-    vec3 specularP = materialCoefficients.z * specP * pointL.color * att;
+    // Point lights of this fragment's cluster
+    vec3 diffuseP = vec3(0.0);
+    vec3 specularP = vec3(0.0);
+    addClusteredPointLights(te_position_world, norm, viewDir, materialCoefficients, specularAlpha, diffuseP, specularP);
 
     // Final light components
     vec3 ambient = materialCoefficients.x * dirL.color;
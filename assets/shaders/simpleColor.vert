@@ -6,9 +6,9 @@ layout(location = 1) in vec3 normal;
 layout(location = 0) out vec3 v_position_world;
 layout(location = 1) out vec3 v_normal_world;
 
-uniform mat4 modelMatrix;     
+#include "drawData.glsl"
 uniform mat4 viewProjMatrix;   
-uniform mat3 normalMatrix;     
+invariant gl_Position;
 
 void main() {
     vec4 pos_world = modelMatrix * vec4(position, 1.0);
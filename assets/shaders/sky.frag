@@ -5,11 +5,8 @@ layout (location = 1) out vec4 BrightColor;
 
 uniform vec3 fogColor;
 uniform vec3 skyColor;
-uniform bool addNoise;
 
-float hash(vec2 p) {
-    return fract(sin(dot(p, vec2(127.1, 311.7))) * 43758.5453);
-}
+#include "hash.glsl"
 
 void main()
 {
@@ -17,11 +14,11 @@ void main()
     float t = smoothstep(0.0, 0.6, dir.y); 
     vec3 color = mix(fogColor, skyColor, t);
 
-    if(addNoise){
-        vec2 noiseUV = gl_FragCoord.xy / 512.0; 
-        float n = hash(noiseUV);
-        color += (n - 0.5) * 0.1; 
-    }   
+#ifdef BLOOMY_WORLD
+    vec2 noiseUV = gl_FragCoord.xy / 512.0; 
+    float n = hash(noiseUV);
+    color += (n - 0.5) * 0.1; 
+#endif
 
     FragColor = vec4(color, 1.0);
      BrightColor = vec4(0.0, 0.0, 0.0, 1.0);
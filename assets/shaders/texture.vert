@@ -18,6 +18,7 @@ out VertexData {
 uniform mat4 modelMatrix;
 uniform mat4 viewProjMatrix;
 uniform mat3 normalMatrix;
+invariant gl_Position;
 
 void main() {
 	vert.normal_world = normalMatrix * normal;
@@ -14,9 +14,9 @@ layout(location = 2) out vec2 v_texcoord;
 layout(location = 3) out vec3 v_color;
 layout(location = 4) out vec3 v_tangent_world;
 
-uniform mat4 modelMatrix;
+#include "drawData.glsl"
 uniform mat4 viewProjMatrix;
-uniform mat3 normalMatrix;
+invariant gl_Position;
 
 void main() {
     vec4 pos_world = modelMatrix * vec4(position, 1.0);
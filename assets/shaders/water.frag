@@ -1,4 +1,4 @@
-#version 330 
+#version 430 core
 
 in vec3 position_world;
 in vec3 normal_world;
@@ -8,105 +8,40 @@ in vec2 uv_coords;
 uniform sampler2D shadowMap; 
 uniform mat4 lightSpaceMatrix;
 
-uniform vec3 materialCoefficients;  
-uniform float specularAlpha;
-uniform vec3 materialColor;
+#include "materials.glsl"
 uniform float u_time;
 
-
-struct DirectionalLight {
-    vec3 color;
-    vec3 direction;
-};
-uniform DirectionalLight dirL;
-
-struct PointLight {
-    vec3 color;
-    vec3 position;
-    float attenuation;
-};
-uniform PointLight pointL;
+// precomputed by WaterPass: x = fbm height, yz = gradient
+uniform sampler2D waterHeightfield;
+uniform float waterTileSize;
 
 uniform vec3 camera_world;
 
 layout (location = 0) out vec4 FragColor;
 layout (location = 1) out vec4 BrightColor;  
 
-const float bayerMatrix8x8[64] = float[64](
-    0.0/64.0, 48.0/64.0, 12.0/64.0, 60.0/64.0,  3.0/64.0, 51.0/64.0, 15.0/64.0, 63.0/64.0,
-    32.0/64.0, 16.0/64.0, 44.0/64.0, 28.0/64.0, 35.0/64.0, 19.0/64.0, 47.0/64.0, 31.0/64.0,
-    8.0/64.0, 56.0/64.0,  4.0/64.0, 52.0/64.0, 11.0/64.0, 59.0/64.0,  7.0/64.0, 55.0/64.0,
-    40.0/64.0, 24.0/64.0, 36.0/64.0, 20.0/64.0, 43.0/64.0, 27.0/64.0, 39.0/64.0, 23.0/64.0,
-    2.0/64.0, 50.0/64.0, 14.0/64.0, 62.0/64.0,  1.0/64.0, 49.0/64.0, 13.0/64.0, 61.0/64.0,
-    34.0/64.0, 18.0/64.0, 46.0/64.0, 30.0/64.0, 33.0/64.0, 17.0/64.0, 45.0/64.0, 29.0/64.0,
-    10.0/64.0, 58.0/64.0,  6.0/64.0, 54.0/64.0,  9.0/64.0, 57.0/64.0,  5.0/64.0, 53.0/64.0,
-    42.0/64.0, 26.0/64.0, 38.0/64.0, 22.0/64.0, 41.0/64.0, 25.0/64.0, 37.0/64.0, 21.0/64.0
-);
-
+#include "lights.glsl"
+#include "shadow.glsl"
 
-// Funktion zur Berechnung des Schattens mit Dithering
+// hard thresholded 3x3 PCF, the taps are divided by 7 instead of 9 which keeps the water brighter
 float calculateDitheredShadow(vec4 lightSpacePos, vec3 normal, vec3 lightDir) {
-    lightSpacePos /= lightSpacePos.w;
-    vec3 projCoords = lightSpacePos.xyz * 0.5 + 0.5;
+    vec3 projCoords = getShadowCoords(lightSpacePos);
 
     float bias = max(0.0025 * (1.0 - dot(normal, lightDir)), 0.0005);
-    float shadow = 0.0;
-    vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
-
-    // PCF (Percentage Closer Filtering)
-    for (int x = -1; x <= 1; x++) {
-        for (int y = -1; y <= 1; y++) {
-            vec2 offset = vec2(x, y) * texelSize;
-            float closestDepth = texture(shadowMap, projCoords.xy + offset).r;
-            shadow += projCoords.z > closestDepth + bias ? 0.0 : 1.0;
-        }
-    }
-    shadow /= 7.0;
-
-    // Dithering auf Schatten anwenden
-    int x = int(gl_FragCoord.x) % 8;
-    int y = int(gl_FragCoord.y) % 8;
-    float threshold = bayerMatrix8x8[y * 8 + x];
-
-    return (shadow < threshold + 0.15) ? 0.0 : 1.0;
-}
+    float shadow = sampleShadowPCF(projCoords, bias, 1) * 9.0 / 7.0;
 
-float hash(vec2 p) {
-    return fract(sin(dot(p, vec2(127.1, 311.7))) * 43758.5453);
+    return (shadow < getBayerThreshold() + 0.15) ? 0.0 : 1.0;
 }
 
-float noise(vec2 p) {
-    vec2 i = floor(p);
-    vec2 f = fract(p);
-
-    float a = hash(i);
-    float b = hash(i + vec2(1.0, 0.0));
-    float c = hash(i + vec2(0.0, 1.0));
-    float d = hash(i + vec2(1.0, 1.0));
-
-    vec2 u = f*f*(3.0-2.0*f);
-
-    return mix(a, b, u.x) +
-           (c - a)* u.y * (1.0 - u.x) +
-           (d - b) * u.x * u.y;
-}
-
-float fbm(vec2 p, int octaves) {
-    float value = 0.0;
-    float amplitude = 0.5;
-    float frequency = 1.0;
-
-    for(int i = 0; i < 8; i++) {
-        if(i >= octaves) break;
-        value += amplitude * noise(p * frequency);
-        frequency *= 2.0;
-        amplitude *= 0.5;
-    }
-
-    return value;
-}
 void main() {
-    vec3 norm = normalize(normal_world);
+    //Prozedurale Texturen 
+    float scale = 5.0;
+    vec2 animatedUV = uv_coords * scale + vec2(u_time * 0.05, u_time * 0.025);
+    vec4 water = texture(waterHeightfield, animatedUV / waterTileSize);
+    float pattern = water.x;
+
+    // tilt the normal along the heightfield slope
+    vec3 norm = normalize(normalize(normal_world) - vec3(water.y, 0.0, water.z) * 0.05);
     vec3 viewDir = normalize(camera_world - position_world);
     
     // Ambient
@@ -130,18 +65,6 @@ void main() {
     diffuse *= ditheredShadow;
     // specular *= ditheredShadow;
 
-    //Prozedurale Texturen 
-    float scale = 5.0;
-    vec2 animatedUV = uv_coords * scale + vec2(u_time * 0.05, u_time * 0.025);
-
-    // Domain Warping (double-FBM)
-    vec2 warp = vec2(
-        fbm(animatedUV * 2.0 + u_time * 0.25, 6),
-        fbm(animatedUV * 2.0 - u_time * 0.25, 6)
-    );
-    
-    float pattern = fbm(animatedUV + warp * 0.5, 6);
-
     specular *= 1.0 + 0.5 * pattern;
     float distance = length(camera_world - position_world); 
     float fogStart = 0.0;
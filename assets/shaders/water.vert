@@ -13,45 +13,13 @@ out vec2 uv_coords;
 
 
 // Uniforms für Transformationen
-uniform mat4 modelMatrix;     
+#include "drawData.glsl"
 uniform mat4 viewProjMatrix;   
-uniform mat3 normalMatrix;     
 uniform float u_time;
 
-float hash(vec2 p) {
-    return fract(sin(dot(p, vec2(127.1, 311.7))) * 43758.5453);
-}
-
-float noise(vec2 p) {
-    vec2 i = floor(p);
-    vec2 f = fract(p);
-
-    float a = hash(i);
-    float b = hash(i + vec2(1.0, 0.0));
-    float c = hash(i + vec2(0.0, 1.0));
-    float d = hash(i + vec2(1.0, 1.0));
-
-    vec2 u = f*f*(3.0-2.0*f);
-
-    return mix(a, b, u.x) +
-           (c - a)* u.y * (1.0 - u.x) +
-           (d - b) * u.x * u.y;
-}
-
-float fbm(vec2 p, int octaves) {
-    float value = 0.0;
-    float amplitude = 0.5;
-    float frequency = 1.0;
-
-    for(int i = 0; i < 8; i++) {
-        if(i >= octaves) break;
-        value += amplitude * noise(p * frequency);
-        frequency *= 2.0;
-        amplitude *= 0.5;
-    }
-
-    return value;
-}
+// precomputed by WaterPass: x = fbm height, yz = gradient
+uniform sampler2D waterHeightfield;
+uniform float waterTileSize;
 
 float directionalWave(vec2 uv, vec2 dir, float speed, float frequency, float amplitude, float time) {
     float wave = sin(dot(uv, dir) * frequency + time * speed);
@@ -64,13 +32,9 @@ void main() {
     normal_world = normalize(normalMatrix * normal);
      float scale = 100.0;
     vec2 animatedUV = uv * scale + vec2(u_time * 0.05, u_time * 0.025);
-    vec2 warp = vec2(
-        fbm(animatedUV * 2.0 + u_time * 0.25, 6),
-        fbm(animatedUV * 2.0 - u_time * 0.25, 6)
-    );
     float amplitude =0.5;
 
-    float raw = fbm(animatedUV + warp * 0.5, 6);
+    float raw = textureLod(waterHeightfield, animatedUV / waterTileSize, 0.0).x;
     float displacement = (raw - 0.5) * amplitude * 2.0;  
 
     vec2 dir1 = normalize(vec2(1.0, 0.5));
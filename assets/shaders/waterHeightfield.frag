@@ -0,0 +1,67 @@
+#version 330 core
+
+in vec2 v_texcoord;
+
+// x = fbm height, yz = its gradient in wave space
+layout(location = 0) out vec4 heightfield;
+
+uniform float u_time;
+// size of one tile in wave space, a whole number so the noise lattice wraps around
+uniform float waterTileSize;
+uniform float waterResolution;
+
+float hash(vec2 p, float period) {
+    p = mod(p, period);
+    return fract(sin(dot(p, vec2(127.1, 311.7))) * 43758.5453);
+}
+
+float noise(vec2 p, float period) {
+    vec2 i = floor(p);
+    vec2 f = fract(p);
+
+    float a = hash(i, period);
+    float b = hash(i + vec2(1.0, 0.0), period);
+    float c = hash(i + vec2(0.0, 1.0), period);
+    float d = hash(i + vec2(1.0, 1.0), period);
+
+    vec2 u = f*f*(3.0-2.0*f);
+
+    return mix(a, b, u.x) +
+           (c - a)* u.y * (1.0 - u.x) +
+           (d - b) * u.x * u.y;
+}
+
+float fbm(vec2 p, int octaves, float period) {
+    float value = 0.0;
+    float amplitude = 0.5;
+    float frequency = 1.0;
+
+    for(int i = 0; i < 8; i++) {
+        if(i >= octaves) break;
+        value += amplitude * noise(p * frequency, period * frequency);
+        frequency *= 2.0;
+        amplitude *= 0.5;
+    }
+
+    return value;
+}
+
+// domain warped fbm, the same pattern water.vert and water.frag used to evaluate per vertex and fragment
+float waterHeight(vec2 p) {
+    vec2 warp = vec2(
+        fbm(p * 2.0 + u_time * 0.25, 6, waterTileSize * 2.0),
+        fbm(p * 2.0 - u_time * 0.25, 6, waterTileSize * 2.0)
+    );
+    return fbm(p + warp * 0.5, 6, waterTileSize);
+}
+
+void main() {
+    vec2 p = v_texcoord * waterTileSize;
+    float texel = waterTileSize / waterResolution;
+
+    float height = waterHeight(p);
+    float dx = waterHeight(p + vec2(texel, 0.0)) - height;
+    float dy = waterHeight(p + vec2(0.0, texel)) - height;
+
+    heightfield = vec4(height, dx / texel, dy / texel, 0.0);
+}
@@ -0,0 +1,500 @@
+#include "CollisionProxy.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+struct Bounds
+{
+    glm::vec3 min = glm::vec3(INFINITY);
+    glm::vec3 max = glm::vec3(-INFINITY);
+
+    void add(const glm::vec3 &point)
+    {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+    float volume() const
+    {
+        // flat parts still count, otherwise every split of a plane would look free
+        glm::vec3 size = glm::max(max - min, glm::vec3(1e-4f));
+        return size.x * size.y * size.z;
+    }
+};
+
+Bounds getBounds(const std::vector<glm::vec3> &points)
+{
+    Bounds bounds;
+    for (const glm::vec3 &point : points)
+        bounds.add(point);
+    return bounds;
+}
+} // namespace
+
+CollisionProxy CollisionProxy::build(const GeometryData &data, const Settings &settings)
+{
+    CollisionProxy proxy;
+    std::vector<glm::vec3> points = uniquePoints(data.positions);
+    if (points.empty())
+        return proxy;
+
+    Type wanted = settings.type;
+    if (wanted == Type::AUTO || wanted == Type::BOX || wanted == Type::SPHERE || wanted == Type::CAPSULE)
+    {
+        float boxError, sphereError, capsuleError;
+        Part box = fitBox(points, boxError);
+        Part sphere = fitSphere(points, sphereError);
+        Part capsule = fitCapsule(points, capsuleError);
+
+        if (wanted == Type::AUTO)
+        {
+            float best = std::min({boxError, sphereError, capsuleError});
+            if (best <= settings.tolerance)
+                wanted = best == boxError ? Type::BOX : best == sphereError ? Type::SPHERE : Type::CAPSULE;
+            else
+                wanted = Type::DECOMPOSITION;
+        }
+
+        if (wanted != Type::DECOMPOSITION)
+        {
+            proxy.type = wanted;
+            proxy.parts.push_back(wanted == Type::BOX ? box : wanted == Type::SPHERE ? sphere : capsule);
+            return proxy;
+        }
+    }
+
+    if (wanted == Type::DECOMPOSITION)
+    {
+        decompose(data, settings, proxy.parts);
+        proxy.type = proxy.parts.size() > 1 ? Type::DECOMPOSITION : Type::CONVEX_HULL;
+        if (!proxy.parts.empty())
+            return proxy;
+    }
+
+    proxy.type = Type::CONVEX_HULL;
+    proxy.parts.push_back(makeHull(std::move(points)));
+    return proxy;
+}
+
+const char *CollisionProxy::getTypeName(Type type)
+{
+    switch (type)
+    {
+    case Type::AUTO:
+        return "auto";
+    case Type::BOX:
+        return "box";
+    case Type::SPHERE:
+        return "sphere";
+    case Type::CAPSULE:
+        return "capsule";
+    case Type::CONVEX_HULL:
+        return "convex hull";
+    case Type::DECOMPOSITION:
+        return "convex decomposition";
+    case Type::HEIGHTFIELD:
+        return "height field";
+    }
+    return "unknown";
+}
+
+std::vector<glm::vec3> CollisionProxy::uniquePoints(const std::vector<glm::vec3> &points)
+{
+    // render meshes repeat positions for every normal and uv seam
+    std::vector<glm::vec3> unique = points;
+    auto less = [](const glm::vec3 &a, const glm::vec3 &b)
+    {
+        if (a.x != b.x)
+            return a.x < b.x;
+        if (a.y != b.y)
+            return a.y < b.y;
+        return a.z < b.z;
+    };
+    std::sort(unique.begin(), unique.end(), less);
+    unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+    return unique;
+}
+
+// The fits cover every vertex. Their error is the mean distance of the vertices to the
+// primitive's surface relative to its size, vertices on the surface of a box shaped mesh give 0
+
+CollisionProxy::Part CollisionProxy::fitBox(const std::vector<glm::vec3> &points, float &error)
+{
+    Bounds bounds = getBounds(points);
+    Part part;
+    part.type = Type::BOX;
+    part.center = (bounds.min + bounds.max) * 0.5f;
+    part.halfExtents = glm::max((bounds.max - bounds.min) * 0.5f, glm::vec3(1e-3f));
+
+    double sum = 0.0;
+    for (const glm::vec3 &point : points)
+    {
+        glm::vec3 inside = part.halfExtents - glm::abs(point - part.center);
+        sum += std::min({inside.x, inside.y, inside.z});
+    }
+    float size = std::max({part.halfExtents.x, part.halfExtents.y, part.halfExtents.z});
+    error = static_cast<float>(sum / points.size()) / size;
+    return part;
+}
+
+CollisionProxy::Part CollisionProxy::fitSphere(const std::vector<glm::vec3> &points, float &error)
+{
+    Bounds bounds = getBounds(points);
+    Part part;
+    part.type = Type::SPHERE;
+    part.center = (bounds.min + bounds.max) * 0.5f;
+
+    float radius = 1e-3f;
+    for (const glm::vec3 &point : points)
+        radius = std::max(radius, glm::length(point - part.center));
+    part.halfExtents = glm::vec3(radius);
+
+    double sum = 0.0;
+    for (const glm::vec3 &point : points)
+        sum += radius - glm::length(point - part.center);
+    error = static_cast<float>(sum / points.size()) / radius;
+    return part;
+}
+
+CollisionProxy::Part CollisionProxy::fitCapsule(const std::vector<glm::vec3> &points, float &error)
+{
+    Bounds bounds = getBounds(points);
+    glm::vec3 size = bounds.max - bounds.min;
+    int axis = size.x >= size.y && size.x >= size.z ? 0 : size.y >= size.z ? 1 : 2;
+
+    Part part;
+    part.type = Type::CAPSULE;
+    part.center = (bounds.min + bounds.max) * 0.5f;
+
+    // radius from the distance to the axis, the half height so that the end caps still hold every vertex
+    float radius = 1e-3f;
+    for (const glm::vec3 &point : points)
+    {
+        glm::vec3 offset = point - part.center;
+        offset[axis] = 0.0f;
+        radius = std::max(radius, glm::length(offset));
+    }
+    float halfHeight = 0.0f;
+    for (const glm::vec3 &point : points)
+    {
+        glm::vec3 offset = point - part.center;
+        float along = std::abs(offset[axis]);
+        offset[axis] = 0.0f;
+        float radial = glm::length(offset);
+        halfHeight = std::max(halfHeight, along - std::sqrt(std::max(0.0f, radius * radius - radial * radial)));
+    }
+    part.halfExtents = glm::vec3(halfHeight, radius, radius);
+
+    // PxCapsuleGeometry is aligned with x
+    if (axis == 1)
+        part.rotation = glm::angleAxis(glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    else if (axis == 2)
+        part.rotation = glm::angleAxis(glm::radians(-90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    double sum = 0.0;
+    for (const glm::vec3 &point : points)
+    {
+        glm::vec3 offset = point - part.center;
+        float along = std::clamp(offset[axis], -halfHeight, halfHeight);
+        offset[axis] -= along;
+        sum += radius - glm::length(offset);
+    }
+    error = static_cast<float>(sum / points.size()) / std::max(radius, halfHeight + radius);
+    return part;
+}
+
+CollisionProxy::Part CollisionProxy::makeHull(std::vector<glm::vec3> points)
+{
+    Bounds bounds = getBounds(points);
+    Part part;
+    part.type = Type::CONVEX_HULL;
+    part.center = (bounds.min + bounds.max) * 0.5f;
+    part.halfExtents = glm::max((bounds.max - bounds.min) * 0.5f, glm::vec3(1e-3f));
+    part.points = std::move(points);
+    return part;
+}
+
+void CollisionProxy::decompose(const GeometryData &data, const Settings &settings, std::vector<Part> &outParts)
+{
+    struct Piece
+    {
+        std::vector<unsigned int> triangles;
+        Bounds bounds;
+        // set by trySplit
+        std::vector<unsigned int> left, right;
+        float fill = 1.0f;
+    };
+
+    size_t triangleCount = data.indices.size() / 3;
+    if (triangleCount == 0)
+        return;
+
+    std::vector<glm::vec3> centroids(triangleCount);
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        centroids[t] = (data.positions[data.indices[t * 3]] + data.positions[data.indices[t * 3 + 1]] +
+                        data.positions[data.indices[t * 3 + 2]]) /
+                       3.0f;
+    }
+
+    auto boundsOf = [&](const std::vector<unsigned int> &triangles)
+    {
+        Bounds bounds;
+        for (unsigned int t : triangles)
+        {
+            for (int v = 0; v < 3; v++)
+                bounds.add(data.positions[data.indices[t * 3 + v]]);
+        }
+        return bounds;
+    };
+
+    // halves at the median centroid along the longest axis, fill is how much of the box they keep
+    auto trySplit = [&](Piece &piece)
+    {
+        piece.left.clear();
+        piece.right.clear();
+        piece.fill = 1.0f;
+        if (piece.triangles.size() < 8)
+            return;
+
+        glm::vec3 size = piece.bounds.max - piece.bounds.min;
+        int axis = size.x >= size.y && size.x >= size.z ? 0 : size.y >= size.z ? 1 : 2;
+        std::vector<unsigned int> sorted = piece.triangles;
+        size_t middle = sorted.size() / 2;
+        std::nth_element(sorted.begin(), sorted.begin() + middle, sorted.end(),
+                         [&](unsigned int a, unsigned int b) { return centroids[a][axis] < centroids[b][axis]; });
+        piece.left.assign(sorted.begin(), sorted.begin() + middle);
+        piece.right.assign(sorted.begin() + middle, sorted.end());
+        piece.fill = (boundsOf(piece.left).volume() + boundsOf(piece.right).volume()) / piece.bounds.volume();
+    };
+
+    std::vector<Piece> pieces(1);
+    pieces[0].triangles.resize(triangleCount);
+    for (size_t t = 0; t < triangleCount; t++)
+        pieces[0].triangles[t] = static_cast<unsigned int>(t);
+    pieces[0].bounds = boundsOf(pieces[0].triangles);
+    trySplit(pieces[0]);
+
+    // always split the piece that wastes the most space until nothing is worth it or the budget is used
+    unsigned int maxHulls = std::clamp(settings.maxHulls, 1u, MAX_SHAPES);
+    while (pieces.size() < maxHulls)
+    {
+        auto worst = std::min_element(pieces.begin(), pieces.end(), [](const Piece &a, const Piece &b) { return a.fill < b.fill; });
+        if (worst->fill >= settings.splitThreshold)
+            break;
+
+        Piece right;
+        right.triangles = std::move(worst->right);
+        worst->triangles = std::move(worst->left);
+        worst->bounds = boundsOf(worst->triangles);
+        right.bounds = boundsOf(right.triangles);
+        trySplit(*worst);
+        trySplit(right);
+        pieces.push_back(std::move(right));
+    }
+
+    // triangles go to one side by their centroid but keep all their vertices, neighbouring hulls overlap without gaps
+    for (const Piece &piece : pieces)
+    {
+        std::vector<glm::vec3> points;
+        points.reserve(piece.triangles.size() * 3);
+        for (unsigned int t : piece.triangles)
+        {
+            for (int v = 0; v < 3; v++)
+                points.push_back(data.positions[data.indices[t * 3 + v]]);
+        }
+        outParts.push_back(makeHull(uniquePoints(points)));
+    }
+}
+
+bool CollisionProxy::buildHeightField(const GeometryData &data, const Settings &settings, HeightField &heightField)
+{
+    size_t triangleCount = data.indices.size() / 3;
+    if (triangleCount == 0 || settings.cellSize <= 0.0f)
+        return false;
+
+    Bounds bounds = getBounds(data.positions);
+    glm::vec3 size = bounds.max - bounds.min;
+    int rows = static_cast<int>(std::ceil(size.x / settings.cellSize)) + 1;
+    int columns = static_cast<int>(std::ceil(size.z / settings.cellSize)) + 1;
+    if (rows < 2 || columns < 2 || static_cast<size_t>(rows) * columns > 4096u * 4096u)
+        return false;
+
+    // walls and step faces cannot be sampled, their cells and the ring around them become holes
+    // that a small triangle mesh fills in. Cells where the grid misses the mesh join them below
+    int cellRows = rows - 1, cellColumns = columns - 1;
+    std::vector<bool> steepTriangles(triangleCount, false);
+    std::vector<bool> meshCells(static_cast<size_t>(cellRows) * cellColumns, false);
+    auto cellRange = [&](size_t t, int dilate, glm::ivec2 &minCell, glm::ivec2 &maxCell)
+    {
+        glm::vec3 low(INFINITY), high(-INFINITY);
+        for (int i = 0; i < 3; i++)
+        {
+            glm::vec3 grid = (data.positions[data.indices[t * 3 + i]] - bounds.min) / settings.cellSize;
+            low = glm::min(low, grid);
+            high = glm::max(high, grid);
+        }
+        minCell = glm::ivec2(std::max(0, static_cast<int>(std::floor(low.x)) - dilate), std::max(0, static_cast<int>(std::floor(low.z)) - dilate));
+        maxCell = glm::ivec2(std::min(cellRows - 1, static_cast<int>(std::floor(high.x)) + dilate), std::min(cellColumns - 1, static_cast<int>(std::floor(high.z)) + dilate));
+    };
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        const glm::vec3 &a = data.positions[data.indices[t * 3]];
+        glm::vec3 normal = glm::cross(data.positions[data.indices[t * 3 + 1]] - a, data.positions[data.indices[t * 3 + 2]] - a);
+        float length = glm::length(normal);
+        if (length <= 1e-8f || std::abs(normal.y) / length >= 0.3f)
+            continue;
+
+        steepTriangles[t] = true;
+        glm::ivec2 minCell, maxCell;
+        cellRange(t, 1, minCell, maxCell);
+        for (int row = minCell.x; row <= maxCell.x; row++)
+        {
+            for (int column = minCell.y; column <= maxCell.y; column++)
+                meshCells[static_cast<size_t>(row) * cellColumns + column] = true;
+        }
+    }
+    auto isMeshCell = [&](int row, int column)
+    {
+        return row >= 0 && column >= 0 && row < cellRows && column < cellColumns && meshCells[static_cast<size_t>(row) * cellColumns + column];
+    };
+    // samples surrounded by hole cells may see the floor above and below a step
+    auto insideMeshArea = [&](int row, int column)
+    {
+        for (int dr = -1; dr <= 0; dr++)
+        {
+            for (int dc = -1; dc <= 0; dc++)
+            {
+                int r = row + dr, c = column + dc;
+                if (r >= 0 && c >= 0 && r < cellRows && c < cellColumns && !meshCells[static_cast<size_t>(r) * cellColumns + c])
+                    return false;
+            }
+        }
+        return true;
+    };
+
+    // every sample takes the height of the triangle above it, a second layer more than the
+    // tolerance away means the mesh is not a height field
+    std::vector<float> heights(static_cast<size_t>(rows) * columns, NAN);
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        if (steepTriangles[t])
+            continue;
+
+        glm::vec3 v[3];
+        for (int i = 0; i < 3; i++)
+            v[i] = (data.positions[data.indices[t * 3 + i]] - bounds.min) / settings.cellSize;
+
+        float area = (v[1].x - v[0].x) * (v[2].z - v[0].z) - (v[2].x - v[0].x) * (v[1].z - v[0].z);
+        if (std::abs(area) < 1e-12f)
+            continue;
+
+        int minRow = std::max(0, static_cast<int>(std::floor(std::min({v[0].x, v[1].x, v[2].x}))));
+        int maxRow = std::min(rows - 1, static_cast<int>(std::ceil(std::max({v[0].x, v[1].x, v[2].x}))));
+        int minColumn = std::max(0, static_cast<int>(std::floor(std::min({v[0].z, v[1].z, v[2].z}))));
+        int maxColumn = std::min(columns - 1, static_cast<int>(std::ceil(std::max({v[0].z, v[1].z, v[2].z}))));
+
+        for (int row = minRow; row <= maxRow; row++)
+        {
+            for (int column = minColumn; column <= maxColumn; column++)
+            {
+                float x = static_cast<float>(row), z = static_cast<float>(column);
+                float w1 = ((x - v[0].x) * (v[2].z - v[0].z) - (v[2].x - v[0].x) * (z - v[0].z)) / area;
+                float w2 = ((v[1].x - v[0].x) * (z - v[0].z) - (x - v[0].x) * (v[1].z - v[0].z)) / area;
+                float w0 = 1.0f - w1 - w2;
+                // samples on shared edges belong to both neighbours
+                const float epsilon = -1e-4f;
+                if (w0 < epsilon || w1 < epsilon || w2 < epsilon)
+                    continue;
+
+                float y = (w0 * v[0].y + w1 * v[1].y + w2 * v[2].y) * settings.cellSize;
+                float &sample = heights[static_cast<size_t>(row) * columns + column];
+                if (!std::isnan(sample) && std::abs(sample - y) > settings.heightTolerance && !insideMeshArea(row, column))
+                    return false;
+                sample = std::isnan(sample) ? y : std::max(sample, y);
+            }
+        }
+    }
+
+    // the grid must follow the mesh, cells that would flatten a bump or a crease away are left to the triangle mesh
+    auto sampleAt = [&](int row, int column)
+    {
+        row = std::clamp(row, 0, rows - 1);
+        column = std::clamp(column, 0, columns - 1);
+        return heights[static_cast<size_t>(row) * columns + column];
+    };
+    for (const glm::vec3 &position : data.positions)
+    {
+        glm::vec3 grid = (position - bounds.min) / settings.cellSize;
+        int row = static_cast<int>(grid.x), column = static_cast<int>(grid.z);
+        if (isMeshCell(std::min(row, cellRows - 1), std::min(column, cellColumns - 1)))
+            continue;
+        float fx = grid.x - row, fz = grid.z - column;
+        float h00 = sampleAt(row, column), h10 = sampleAt(row + 1, column);
+        float h01 = sampleAt(row, column + 1), h11 = sampleAt(row + 1, column + 1);
+        if (std::isnan(h00) || std::isnan(h10) || std::isnan(h01) || std::isnan(h11))
+            continue;
+        float height = (h00 * (1.0f - fx) + h10 * fx) * (1.0f - fz) + (h01 * (1.0f - fx) + h11 * fx) * fz;
+        if (std::abs(height - (position.y - bounds.min.y)) > settings.heightTolerance)
+            meshCells[static_cast<size_t>(std::min(row, cellRows - 1)) * cellColumns + std::min(column, cellColumns - 1)] = true;
+    }
+
+    heightField.rows = rows;
+    heightField.columns = columns;
+    heightField.origin = bounds.min;
+    heightField.cellSize = settings.cellSize;
+    heightField.heightScale = std::max(size.y, 1e-4f) / 32767.0f;
+    heightField.heights.resize(heights.size());
+    heightField.holes.assign(heights.size(), false);
+    for (int row = 0; row < rows; row++)
+    {
+        for (int column = 0; column < columns; column++)
+        {
+            size_t index = static_cast<size_t>(row) * columns + column;
+            float height = std::isnan(heights[index]) ? 0.0f : heights[index];
+            heightField.heights[index] = static_cast<int16_t>(std::clamp(std::round(height / heightField.heightScale), 0.0f, 32767.0f));
+
+            // a cell needs floor at all four corners
+            if (row + 1 < rows && column + 1 < columns)
+            {
+                heightField.holes[index] = isMeshCell(row, column) || std::isnan(heights[index]) || std::isnan(sampleAt(row + 1, column)) ||
+                                           std::isnan(sampleAt(row, column + 1)) || std::isnan(sampleAt(row + 1, column + 1));
+            }
+        }
+    }
+
+    // the steep triangles and every triangle touching a hole they or the tolerance check left
+    heightField.meshPositions.clear();
+    heightField.meshIndices.clear();
+    std::vector<unsigned int> remap(data.positions.size(), ~0u);
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        bool covered = steepTriangles[t];
+        if (!covered)
+        {
+            glm::ivec2 minCell, maxCell;
+            cellRange(t, 0, minCell, maxCell);
+            for (int row = minCell.x; row <= maxCell.x && !covered; row++)
+            {
+                for (int column = minCell.y; column <= maxCell.y && !covered; column++)
+                    covered = isMeshCell(row, column);
+            }
+        }
+        if (!covered)
+            continue;
+
+        for (int i = 0; i < 3; i++)
+        {
+            unsigned int &index = remap[data.indices[t * 3 + i]];
+            if (index == ~0u)
+            {
+                index = static_cast<unsigned int>(heightField.meshPositions.size());
+                heightField.meshPositions.push_back(data.positions[data.indices[t * 3 + i]]);
+            }
+            heightField.meshIndices.push_back(index);
+        }
+    }
+
+    // a mesh that mostly stays triangles gains nothing from the grid
+    return heightField.meshIndices.size() / 3 <= triangleCount / 4;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+#include "Geometry.h"
+
+/*!
+ * Simplified collision shapes for a mesh, computed once when the model is imported.
+ * A mesh becomes a single primitive when one fits its vertices closely enough, otherwise it is
+ * split into a few convex parts (recursive splits along the longest axis while that shrinks the
+ * bounding volume noticeably) or wrapped in one hull. Hulls are cooked with a vertex limit, so
+ * neither cooking nor the narrow phase ever see the full render mesh.
+ * Static terrain-like meshes can be resampled into a height field instead of a triangle mesh.
+ */
+class CollisionProxy
+{
+public:
+    enum class Type
+    {
+        AUTO,
+        BOX,
+        SPHERE,
+        CAPSULE,
+        CONVEX_HULL,
+        DECOMPOSITION,
+        // static bodies only, falls back to the triangle mesh when the mesh is not a single layer floor
+        HEIGHTFIELD
+    };
+
+    // RenderObject fetches at most this many shapes when it sets collision filters
+    static constexpr unsigned int MAX_SHAPES = 8;
+
+    struct Settings
+    {
+        Type type = Type::AUTO;
+        // AUTO takes a primitive when the vertices are on average this close to its surface, relative to its size
+        float tolerance = 0.05f;
+        // vertex limit of each cooked hull, 255 at most
+        unsigned int maxHullVertices = 32;
+        // parts of a decomposition, at most MAX_SHAPES
+        unsigned int maxHulls = 4;
+        // a part is split while its two halves fill less than this share of its bounding box
+        float splitThreshold = 0.7f;
+        // sample spacing of a height field
+        float cellSize = 0.1f;
+        // largest height difference between the mesh and the resampled height field
+        float heightTolerance = 0.02f;
+    };
+
+    /*!
+     * Regular grid over x (rows) and z (columns) starting at origin, laid out like PxHeightFieldDesc
+     */
+    struct HeightField
+    {
+        int rows = 0, columns = 0;
+        glm::vec3 origin;
+        float cellSize, heightScale;
+        std::vector<int16_t> heights;
+        // cells without floor underneath, indexed like the samples of their lower corner
+        std::vector<bool> holes;
+        // triangles the grid cannot represent (walls, step faces and the floor next to them), they
+        // collide as a triangle mesh filling the holes they leave
+        std::vector<glm::vec3> meshPositions;
+        std::vector<unsigned int> meshIndices;
+    };
+
+    struct Part
+    {
+        // BOX, SPHERE, CAPSULE or CONVEX_HULL
+        Type type;
+        glm::vec3 center;
+        // capsules lie along their local x axis, like PxCapsuleGeometry
+        glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        // box: half extents, sphere: x is the radius, capsule: x is the half height and y the radius.
+        // Hulls keep their bounding box here as fallback when cooking fails
+        glm::vec3 halfExtents;
+        // hull input, deduplicated mesh vertices
+        std::vector<glm::vec3> points;
+    };
+
+    static CollisionProxy build(const GeometryData &data, const Settings &settings);
+
+    /*!
+     * Resamples a floor mesh into a height field, steep triangles are cut out and kept in meshIndices
+     * @return false when the mesh has overhangs, or the grid misses it by more than heightTolerance
+     */
+    static bool buildHeightField(const GeometryData &data, const Settings &settings, HeightField &heightField);
+
+    static const char *getTypeName(Type type);
+
+    Type getType() const { return type; }
+    const std::vector<Part> &getParts() const { return parts; }
+
+private:
+    Type type = Type::CONVEX_HULL;
+    std::vector<Part> parts;
+
+    static std::vector<glm::vec3> uniquePoints(const std::vector<glm::vec3> &points);
+    static Part fitBox(const std::vector<glm::vec3> &points, float &error);
+    static Part fitSphere(const std::vector<glm::vec3> &points, float &error);
+    static Part fitCapsule(const std::vector<glm::vec3> &points, float &error);
+    static Part makeHull(std::vector<glm::vec3> points);
+    static void decompose(const GeometryData &data, const Settings &settings, std::vector<Part> &outParts);
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "EntityHandle.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*!
+ * Components of one type, packed without gaps. The sparse array maps an entity index to the
+ * component's slot in the dense arrays, removing swaps the last component into the hole.
+ * Systems walk getComponents() / getEntities() front to back, pointers into the pool stay valid
+ * until the next add or remove.
+ */
+template <typename T>
+class ComponentPool
+{
+public:
+    /*!
+     * Adds the component, or replaces the one the entity already has
+     */
+    T &add(EntityHandle entity, const T &component)
+    {
+        if (T *existing = get(entity))
+            return *existing = component;
+
+        if (entity.index >= sparse.size())
+            sparse.resize(entity.index + 1, NONE);
+        sparse[entity.index] = static_cast<uint32_t>(components.size());
+        components.push_back(component);
+        entities.push_back(entity);
+        return components.back();
+    }
+
+    void remove(EntityHandle entity)
+    {
+        if (!has(entity))
+            return;
+
+        uint32_t slot = sparse[entity.index];
+        uint32_t last = static_cast<uint32_t>(components.size() - 1);
+        if (slot != last)
+        {
+            components[slot] = components[last];
+            entities[slot] = entities[last];
+            sparse[entities[slot].index] = slot;
+        }
+        components.pop_back();
+        entities.pop_back();
+        sparse[entity.index] = NONE;
+    }
+
+    bool has(EntityHandle entity) const
+    {
+        return entity.index < sparse.size() && sparse[entity.index] != NONE && entities[sparse[entity.index]] == entity;
+    }
+
+    T *get(EntityHandle entity) { return has(entity) ? &components[sparse[entity.index]] : nullptr; }
+    const T *get(EntityHandle entity) const { return has(entity) ? &components[sparse[entity.index]] : nullptr; }
+
+    size_t size() const { return components.size(); }
+    std::vector<T> &getComponents() { return components; }
+    const std::vector<T> &getComponents() const { return components; }
+    const std::vector<EntityHandle> &getEntities() const { return entities; }
+
+    void clear()
+    {
+        sparse.clear();
+        components.clear();
+        entities.clear();
+    }
+
+private:
+    static constexpr uint32_t NONE = 0xffffffffu;
+
+    std::vector<uint32_t> sparse;
+    std::vector<T> components;
+    std::vector<EntityHandle> entities;
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <PxPhysicsAPI.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "../GameLogic/TriggerSystem.h"
+
+struct RenderObject;
+
+struct TransformComponent
+{
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    glm::mat4 model = glm::mat4(1.0f);
+    // position or rotation changed, EntitySystems::updateTransforms rebuilds the model matrix
+    bool dirty = false;
+};
+
+/*!
+ * The render object still owns geometry and materials, the passes draw through it
+ */
+struct RenderableComponent
+{
+    RenderObject *object = nullptr;
+};
+
+struct RigidBodyComponent
+{
+    physx::PxRigidActor *actor = nullptr;
+    // dynamic bodies are moved by the simulation, everything else follows its transform
+    bool dynamic = false;
+};
+
+struct PickableComponent
+{
+    // distance from the head at which the pickup can be collected
+    float radius = 0.5f;
+};
+
+/*!
+ * A trigger volume that moves with the entity and is only active while it is rendered
+ */
+struct TriggerComponent
+{
+    TriggerSystem::Handle volume = -1;
+};
+
+/*!
+ * Bobs up and down around a resting position
+ */
+struct AnimationComponent
+{
+    glm::vec3 basePosition = glm::vec3(0.0f);
+    float amplitude = 0.0f;
+    float frequency = 0.0f;
+};
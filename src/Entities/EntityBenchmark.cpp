@@ -0,0 +1,94 @@
+#include "EntityBenchmark.h"
+#include "EntitySystems.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+
+namespace
+{
+    // stand-ins for RenderObject and Geometry, same indirections without GL resources
+    struct LegacyGeometry
+    {
+        glm::mat4 modelMatrix = glm::mat4(1.0f);
+        std::vector<float> vertices;
+    };
+
+    struct LegacyObject
+    {
+        std::string id;
+        std::shared_ptr<LegacyGeometry> geometry;
+        glm::vec3 basePosition;
+        bool isRendered = true;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    float millisecondsPerFrame(Clock::time_point start, int frameCount)
+    {
+        return std::chrono::duration<float, std::milli>(Clock::now() - start).count() / frameCount;
+    }
+}
+
+void EntityBenchmark::run(int entityCount, int frameCount)
+{
+    std::mt19937 rng(1337);
+    std::uniform_real_distribution<float> coordinate(-50.0f, 50.0f);
+
+    // the old layout, allocated interleaved with other data the way loading models does
+    std::vector<std::shared_ptr<LegacyObject>> objects;
+    std::vector<std::unique_ptr<char[]>> loaderGarbage;
+    for (int i = 0; i < entityCount; ++i)
+    {
+        auto object = std::make_shared<LegacyObject>();
+        loaderGarbage.push_back(std::make_unique<char[]>(256));
+        object->geometry = std::make_shared<LegacyGeometry>();
+        object->geometry->vertices.resize(64);
+        object->id = "object" + std::to_string(i);
+        object->basePosition = glm::vec3(coordinate(rng), coordinate(rng), coordinate(rng));
+        objects.push_back(object);
+    }
+
+    EntityRegistry registry;
+    for (const auto &object : objects)
+    {
+        EntityHandle entity = registry.create();
+        registry.transforms.add(entity, TransformComponent());
+        registry.animations.add(entity, {object->basePosition, 0.04f, 2.0f});
+    }
+
+    float checksum = 0.0f;
+    auto start = Clock::now();
+    for (int frame = 0; frame < frameCount; ++frame)
+    {
+        float t = frame / 60.0f;
+        for (const auto &object : objects)
+        {
+            if (!object->isRendered)
+                continue;
+            glm::vec3 position = object->basePosition + glm::vec3(0.0f, std::sin(t * 2.0f) * 0.04f, 0.0f);
+            object->geometry->modelMatrix = glm::translate(glm::mat4(1.0f), position);
+        }
+        checksum += objects[frame % objects.size()]->geometry->modelMatrix[3][1];
+    }
+    float legacyMs = millisecondsPerFrame(start, frameCount);
+
+    start = Clock::now();
+    for (int frame = 0; frame < frameCount; ++frame)
+    {
+        float t = frame / 60.0f;
+        EntitySystems::animate(registry, t);
+        EntitySystems::updateTransforms(registry);
+        checksum += registry.transforms.getComponents()[frame % registry.transforms.size()].model[3][1];
+    }
+    float registryMs = millisecondsPerFrame(start, frameCount);
+
+    std::cout << "Entity benchmark: " << entityCount << " entities, " << frameCount << " frames" << std::endl;
+    std::cout << "  shared_ptr scene  " << legacyMs << " ms per frame" << std::endl;
+    std::cout << "  entity registry   " << registryMs << " ms per frame" << std::endl;
+    // printing the sum keeps both loops from being optimized away
+    std::cout << "  checksum          " << checksum << std::endl;
+}
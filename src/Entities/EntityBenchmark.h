@@ -0,0 +1,14 @@
+#pragma once
+
+/*!
+ * Measures the per-frame cost of the animation and transform systems over a synthetic scene,
+ * once on the entity registry and once on the scene layout it replaced: a vector of shared
+ * pointers to objects that point to separately allocated geometry. Needs no window.
+ *
+ *   doppel --entity-benchmark [entities]
+ */
+class EntityBenchmark
+{
+public:
+    static void run(int entityCount, int frameCount = 600);
+};
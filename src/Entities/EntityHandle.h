@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+/*!
+ * Index into the entity registry plus the generation the slot had when the entity was created.
+ * A destroyed entity's slot gets reused with the next generation, so stale handles stop resolving
+ */
+struct EntityHandle
+{
+    static constexpr uint32_t INVALID_INDEX = 0xffffffffu;
+
+    uint32_t index = INVALID_INDEX;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != INVALID_INDEX; }
+    bool operator==(const EntityHandle &other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const EntityHandle &other) const { return !(*this == other); }
+};
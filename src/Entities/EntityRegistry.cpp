@@ -0,0 +1,54 @@
+#include "EntityRegistry.h"
+
+EntityHandle EntityRegistry::create()
+{
+    EntityHandle entity;
+    if (!freeIndices.empty())
+    {
+        entity.index = freeIndices.back();
+        freeIndices.pop_back();
+    }
+    else
+    {
+        entity.index = static_cast<uint32_t>(generations.size());
+        generations.push_back(0);
+    }
+    entity.generation = generations[entity.index];
+    alive++;
+    return entity;
+}
+
+void EntityRegistry::destroy(EntityHandle entity)
+{
+    if (!isAlive(entity))
+        return;
+
+    transforms.remove(entity);
+    renderables.remove(entity);
+    rigidBodies.remove(entity);
+    pickables.remove(entity);
+    triggers.remove(entity);
+    animations.remove(entity);
+
+    generations[entity.index]++;
+    freeIndices.push_back(entity.index);
+    alive--;
+}
+
+bool EntityRegistry::isAlive(EntityHandle entity) const
+{
+    return entity.index < generations.size() && generations[entity.index] == entity.generation;
+}
+
+void EntityRegistry::clear()
+{
+    transforms.clear();
+    renderables.clear();
+    rigidBodies.clear();
+    pickables.clear();
+    triggers.clear();
+    animations.clear();
+    generations.clear();
+    freeIndices.clear();
+    alive = 0;
+}
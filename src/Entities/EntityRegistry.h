@@ -0,0 +1,35 @@
+#pragma once
+
+#include "ComponentPool.h"
+#include "Components.h"
+#include "EntityHandle.h"
+#include <vector>
+
+/*!
+ * Hands out generational entity handles and keeps one dense pool per component type.
+ * Destroying an entity removes all of its components and retires its handle
+ */
+class EntityRegistry
+{
+public:
+    EntityHandle create();
+    void destroy(EntityHandle entity);
+    bool isAlive(EntityHandle entity) const;
+    size_t getCount() const { return alive; }
+    /*!
+     * Drops every entity, handles from before must not be used again
+     */
+    void clear();
+
+    ComponentPool<TransformComponent> transforms;
+    ComponentPool<RenderableComponent> renderables;
+    ComponentPool<RigidBodyComponent> rigidBodies;
+    ComponentPool<PickableComponent> pickables;
+    ComponentPool<TriggerComponent> triggers;
+    ComponentPool<AnimationComponent> animations;
+
+private:
+    std::vector<uint32_t> generations;
+    std::vector<uint32_t> freeIndices;
+    size_t alive = 0;
+};
@@ -0,0 +1,123 @@
+#include "EntitySystems.h"
+#include "../RenderObject.h"
+#include "../GameLogic/TriggerSystem.h"
+#include <cmath>
+
+void EntitySystems::animate(EntityRegistry &registry, float t)
+{
+    const std::vector<EntityHandle> &entities = registry.animations.getEntities();
+    std::vector<AnimationComponent> &animations = registry.animations.getComponents();
+
+    for (size_t i = 0; i < animations.size(); ++i)
+    {
+        const RenderableComponent *renderable = registry.renderables.get(entities[i]);
+        if (renderable && renderable->object && !renderable->object->isRendered)
+            continue;
+
+        TransformComponent *transform = registry.transforms.get(entities[i]);
+        if (!transform)
+            continue;
+
+        const AnimationComponent &animation = animations[i];
+        transform->position = animation.basePosition + glm::vec3(0.0f, std::sin(t * animation.frequency) * animation.amplitude, 0.0f);
+        transform->dirty = true;
+    }
+}
+
+void EntitySystems::syncRigidBodies(EntityRegistry &registry, physx::PxScene *scene)
+{
+    physx::PxU32 count = 0;
+    physx::PxActor **actors = scene->getActiveActors(count);
+
+    for (physx::PxU32 i = 0; i < count; ++i)
+    {
+        EntityInfo *entity = EntityInfo::fromActor(actors[i]);
+        if (!entity || !actors[i]->is<physx::PxRigidActor>())
+            continue;
+
+        TransformComponent *transform = registry.transforms.get(entity->handle);
+        if (!transform)
+            continue;
+
+        physx::PxTransform pose = static_cast<physx::PxRigidActor *>(actors[i])->getGlobalPose();
+        transform->position = glm::vec3(pose.p.x, pose.p.y, pose.p.z);
+        transform->rotation = glm::quat(pose.q.w, pose.q.x, pose.q.y, pose.q.z);
+        transform->dirty = true;
+    }
+}
+
+void EntitySystems::updateTransforms(EntityRegistry &registry)
+{
+    const std::vector<EntityHandle> &entities = registry.transforms.getEntities();
+    std::vector<TransformComponent> &transforms = registry.transforms.getComponents();
+
+    for (size_t i = 0; i < transforms.size(); ++i)
+    {
+        TransformComponent &transform = transforms[i];
+        if (!transform.dirty)
+            continue;
+
+        // translate * rotate without the matrix product
+        transform.model = glm::mat4_cast(transform.rotation);
+        transform.model[3] = glm::vec4(transform.position, 1.0f);
+        transform.dirty = false;
+
+        if (RenderableComponent *renderable = registry.renderables.get(entities[i]))
+        {
+            if (renderable->object && renderable->object->geometry)
+                renderable->object->geometry->setModelMatrix(transform.model);
+        }
+
+        RigidBodyComponent *body = registry.rigidBodies.get(entities[i]);
+        if (body && body->actor && !body->dynamic)
+        {
+            const glm::vec3 &p = transform.position;
+            const glm::quat &q = transform.rotation;
+            body->actor->setGlobalPose(physx::PxTransform(physx::PxVec3(p.x, p.y, p.z), physx::PxQuat(q.x, q.y, q.z, q.w)));
+        }
+    }
+}
+
+void EntitySystems::updateTriggers(EntityRegistry &registry, TriggerSystem &triggers)
+{
+    const std::vector<EntityHandle> &entities = registry.triggers.getEntities();
+    const std::vector<TriggerComponent> &components = registry.triggers.getComponents();
+
+    for (size_t i = 0; i < components.size(); ++i)
+    {
+        const RenderableComponent *renderable = registry.renderables.get(entities[i]);
+        bool enabled = !renderable || !renderable->object || renderable->object->isRendered;
+        triggers.setEnabled(components[i].volume, enabled);
+
+        const TransformComponent *transform = registry.transforms.get(entities[i]);
+        if (enabled && transform)
+            triggers.setCenter(components[i].volume, transform->position);
+    }
+}
+
+void EntitySystems::pullTransforms(EntityRegistry &registry)
+{
+    const std::vector<EntityHandle> &entities = registry.renderables.getEntities();
+    const std::vector<RenderableComponent> &renderables = registry.renderables.getComponents();
+
+    for (size_t i = 0; i < renderables.size(); ++i)
+    {
+        TransformComponent *transform = registry.transforms.get(entities[i]);
+        RenderObject *object = renderables[i].object;
+        if (!transform || !object || !object->geometry)
+            continue;
+
+        transform->model = object->geometry->getModelMatrix();
+        transform->position = object->geometry->getPosition();
+        transform->rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        if (const RigidBodyComponent *body = registry.rigidBodies.get(entities[i]))
+        {
+            if (body->actor && body->dynamic)
+            {
+                physx::PxQuat q = body->actor->getGlobalPose().q;
+                transform->rotation = glm::quat(q.w, q.x, q.y, q.z);
+            }
+        }
+        transform->dirty = false;
+    }
+}
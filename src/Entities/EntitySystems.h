@@ -0,0 +1,40 @@
+#pragma once
+
+#include "EntityRegistry.h"
+#include <PxPhysicsAPI.h>
+
+class TriggerSystem;
+
+/*!
+ * Per-frame work on the entity registry. Each system walks one dense pool front to back and only
+ * looks up the other components it needs through the entity handle
+ */
+class EntitySystems
+{
+public:
+    /*!
+     * Moves every animated entity to its bobbing position at time t
+     */
+    static void animate(EntityRegistry &registry, float t);
+
+    /*!
+     * Copies the poses of the bodies the last simulation step moved, from the scene's active actors
+     */
+    static void syncRigidBodies(EntityRegistry &registry, physx::PxScene *scene);
+
+    /*!
+     * Rebuilds the model matrices of changed transforms and hands them to the render objects.
+     * Bodies that are not simulated are moved along
+     */
+    static void updateTransforms(EntityRegistry &registry);
+
+    /*!
+     * Moves trigger volumes with their entity and enables them while the entity is rendered
+     */
+    static void updateTriggers(EntityRegistry &registry, TriggerSystem &triggers);
+
+    /*!
+     * Reads every transform back from its render object, after something moved them directly
+     */
+    static void pullTransforms(EntityRegistry &registry);
+};
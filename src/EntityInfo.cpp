@@ -0,0 +1,31 @@
+#include "EntityInfo.h"
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+    std::mutex mutex;
+    // a deque keeps the strings lookup hands out in place while names are added
+    std::deque<std::string> names = {""};
+    std::unordered_map<std::string, NameId> ids = {{"", 0}};
+}
+
+NameId NameTable::intern(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = ids.find(name);
+    if (found != ids.end())
+        return found->second;
+
+    NameId id = static_cast<NameId>(names.size());
+    names.push_back(name);
+    ids.emplace(name, id);
+    return id;
+}
+
+const std::string &NameTable::lookup(NameId id)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return id < names.size() ? names[id] : names[0];
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <PxPhysicsAPI.h>
+#include "Entities/EntityHandle.h"
+#include <cstdint>
+#include <string>
+
+struct RenderObject;
+
+/*!
+ * Interned object name, compares as an integer. 0 is the empty name
+ */
+using NameId = uint32_t;
+
+/*!
+ * Interns names once at load time, lookups are only meant for logging
+ */
+class NameTable
+{
+public:
+    static NameId intern(const std::string &name);
+    static const std::string &lookup(NameId id);
+};
+
+enum EntityTag : uint32_t
+{
+    TAG_NONE = 0,
+    TAG_CASTS_SHADOW = 1 << 0,
+    TAG_PICKABLE = 1 << 1,
+    TAG_TRIGGER = 1 << 2,
+    TAG_REMOTE = 1 << 3,
+    TAG_NOTE = 1 << 4,
+    TAG_PRESSURE_PLATE = 1 << 5
+};
+
+/*!
+ * What a PhysX actor belongs to, the userData of every actor the game creates points to one.
+ * Gameplay code tests tags instead of comparing names or userData pointers
+ */
+struct EntityInfo
+{
+    NameId name = 0;
+    uint32_t tags = TAG_NONE;
+    // null for actors without a render object, like the pressure plate
+    RenderObject *renderObject = nullptr;
+    // the entity in Game's registry, invalid for objects that are not registered
+    EntityHandle handle;
+
+    bool hasTag(uint32_t tag) const { return (tags & tag) != 0; }
+
+    /*!
+     * @return null for actors that are not part of the game, like the character controller's
+     */
+    static EntityInfo *fromActor(const physx::PxActor *actor)
+    {
+        return actor ? static_cast<EntityInfo *>(actor->userData) : nullptr;
+    }
+};
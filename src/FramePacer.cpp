@@ -0,0 +1,140 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+FramePacer::VSync FramePacer::vsync = FramePacer::VSync::ON;
+int FramePacer::fpsLimit = 0;
+bool FramePacer::lowLatency = false;
+int FramePacer::maxQueuedFrames = 1;
+FramePacer::Clock::time_point FramePacer::nextFrame;
+FramePacer::Clock::time_point FramePacer::inputTime;
+std::deque<FramePacer::Frame> FramePacer::frames;
+float FramePacer::latencyMilliseconds = 0.0f;
+
+void FramePacer::init(GLFWwindow *window, VSync vsync, int fpsLimit, bool lowLatency, int maxQueuedFrames)
+{
+    if (vsync == VSync::ADAPTIVE &&
+        !glfwExtensionSupported("WGL_EXT_swap_control_tear") && !glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+    {
+        std::cerr << "Adaptive vsync is not supported, using regular vsync" << std::endl;
+        vsync = VSync::ON;
+    }
+
+    FramePacer::vsync = vsync;
+    FramePacer::fpsLimit = std::max(fpsLimit, 0);
+    FramePacer::lowLatency = lowLatency;
+    FramePacer::maxQueuedFrames = std::max(maxQueuedFrames, 0);
+    nextFrame = Clock::now();
+    inputTime = Clock::now();
+
+    glfwSwapInterval(vsync == VSync::ADAPTIVE ? -1 : vsync == VSync::ON ? 1 : 0);
+
+    // raw motion skips the OS pointer acceleration while the cursor is captured
+    if (glfwRawMouseMotionSupported())
+        glfwSetInputMode(window, GLFW_RAW_MOUSE_MOTION, GLFW_TRUE);
+
+    std::cout << "Frame pacing:     vsync " << getVSyncName(FramePacer::vsync)
+              << ", limit " << (FramePacer::fpsLimit > 0 ? std::to_string(FramePacer::fpsLimit) + " fps" : std::string("off"))
+              << ", low latency " << (lowLatency ? "on" : "off") << std::endl;
+}
+
+FramePacer::VSync FramePacer::parseVSync(const std::string &name)
+{
+    if (name == "off")
+        return VSync::OFF;
+    if (name == "adaptive")
+        return VSync::ADAPTIVE;
+    return VSync::ON;
+}
+
+const char *FramePacer::getVSyncName(VSync mode)
+{
+    switch (mode)
+    {
+    case VSync::OFF:
+        return "off";
+    case VSync::ADAPTIVE:
+        return "adaptive";
+    default:
+        return "on";
+    }
+}
+
+void FramePacer::waitForNextFrame()
+{
+    if (fpsLimit <= 0)
+        return;
+
+    // sleep most of the way, then spin, sleep granularity is about a millisecond
+    Clock::time_point now = Clock::now();
+    if (nextFrame - now > std::chrono::milliseconds(2))
+        std::this_thread::sleep_until(nextFrame - std::chrono::milliseconds(1));
+    while (Clock::now() < nextFrame)
+        std::this_thread::yield();
+
+    // a frame that ran over the budget restarts the schedule instead of rushing to catch up
+    Clock::duration interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fpsLimit));
+    now = Clock::now();
+    nextFrame = std::max(nextFrame + interval, now);
+}
+
+void FramePacer::markInputSampled()
+{
+    inputTime = Clock::now();
+}
+
+void FramePacer::endFrame()
+{
+    if (lowLatency && maxQueuedFrames == 0)
+    {
+        glFinish();
+        addLatencySample(inputTime, Clock::now());
+        return;
+    }
+
+    frames.push_back({glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), inputTime});
+    retire(false);
+
+    // block on the oldest frame until no more than maxQueuedFrames are in flight
+    if (lowLatency)
+    {
+        while (static_cast<int>(frames.size()) > maxQueuedFrames)
+            retire(true);
+    }
+}
+
+void FramePacer::shutdown()
+{
+    for (const Frame &frame : frames)
+        glDeleteSync(frame.fence);
+    frames.clear();
+    latencyMilliseconds = 0.0f;
+}
+
+void FramePacer::retire(bool wait)
+{
+    while (!frames.empty())
+    {
+        Frame &frame = frames.front();
+        GLenum result = glClientWaitSync(frame.fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? 1000000000 : 0);
+        if (result == GL_TIMEOUT_EXPIRED)
+        {
+            if (!wait)
+                return;
+            continue;
+        }
+
+        addLatencySample(frame.inputTime, Clock::now());
+        glDeleteSync(frame.fence);
+        frames.pop_front();
+        if (wait)
+            return;
+    }
+}
+
+void FramePacer::addLatencySample(Clock::time_point inputTime, Clock::time_point doneTime)
+{
+    float sample = std::chrono::duration<float, std::milli>(doneTime - inputTime).count();
+    latencyMilliseconds = latencyMilliseconds == 0.0f ? sample : latencyMilliseconds + (sample - latencyMilliseconds) * 0.1f;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <chrono>
+#include <deque>
+#include <string>
+
+/*!
+ * Frame pacing around glfwSwapBuffers: swap interval, an optional frame rate limit and a
+ * low latency mode that keeps the CPU from queueing frames ahead of the GPU.
+ * The limiter sleeps before input is polled, so the time it waits is never spent between
+ * reading input and presenting. Every frame gets a fence after its swap, the time from the
+ * input poll to the fence signalling is the input-to-present latency estimate.
+ */
+class FramePacer
+{
+public:
+    enum class VSync
+    {
+        OFF,
+        ON,
+        ADAPTIVE // tears instead of waiting when a frame is late, needs *_EXT_swap_control_tear
+    };
+
+    /*!
+     * @param fpsLimit: frames per second to cap at, 0 for no limit
+     * @param maxQueuedFrames: with lowLatency, frames the GPU may lag behind, 0 waits for each frame (glFinish)
+     */
+    static void init(GLFWwindow *window, VSync vsync, int fpsLimit, bool lowLatency, int maxQueuedFrames);
+
+    /*!
+     * "on", "off" or "adaptive", anything else is on
+     */
+    static VSync parseVSync(const std::string &name);
+    static const char *getVSyncName(VSync mode);
+
+    /*!
+     * Sleeps until the frame limit allows the next frame, call right before polling input
+     */
+    static void waitForNextFrame();
+
+    /*!
+     * Input of the coming frame has been read
+     */
+    static void markInputSampled();
+
+    /*!
+     * Call right after glfwSwapBuffers
+     */
+    static void endFrame();
+
+    /*!
+     * Deletes the fences of frames still in flight, call before the GL context is destroyed
+     */
+    static void shutdown();
+
+    static VSync getVSync() { return vsync; }
+    static int getFpsLimit() { return fpsLimit; }
+    static bool isLowLatency() { return lowLatency; }
+    static int getQueuedFrames() { return static_cast<int>(frames.size()); }
+
+    /*!
+     * @return smoothed time from the input poll until the GPU finished the frame. Outside the
+     * low latency mode fences are only polled once per frame, so this is an upper bound.
+     */
+    static float getLatencyMilliseconds() { return latencyMilliseconds; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Frame
+    {
+        GLsync fence;
+        Clock::time_point inputTime;
+    };
+
+    static VSync vsync;
+    static int fpsLimit;
+    static bool lowLatency;
+    static int maxQueuedFrames;
+    static Clock::time_point nextFrame;
+    static Clock::time_point inputTime;
+    static std::deque<Frame> frames;
+    static float latencyMilliseconds;
+
+    static void retire(bool wait);
+    static void addLatencySample(Clock::time_point inputTime, Clock::time_point doneTime);
+};
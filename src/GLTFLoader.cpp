@@ -10,7 +10,7 @@ GLTFLoader::GLTFLoader(Physics &physics) : physics(physics)
 }
 GLTFLoader::~GLTFLoader() {}
 
-std::shared_ptr<RenderObject> GLTFLoader::loadModel(const std::string &filePath, std::shared_ptr<Material> bloomyMaterial, std::shared_ptr<Material> ditherMaterial, uint32_t worldMask, RigidBodyType bodyType)
+std::shared_ptr<RenderObject> GLTFLoader::loadModel(const std::string &filePath, std::shared_ptr<Material> bloomyMaterial, std::shared_ptr<Material> ditherMaterial, uint32_t worldMask, RigidBodyType bodyType, const CollisionProxy::Settings &collisionProxy)
 {
     tinygltf::Model model;
     tinygltf::TinyGLTF loader;
@@ -58,7 +58,7 @@ std::shared_ptr<RenderObject> GLTFLoader::loadModel(const std::string &filePath,
         return std::make_shared<RenderObject>(geometry);
     }
 
-    PxRigidActor *actor = physics.createMeshFromGeometry(geometry->getGeometryData(), bodyType);
+    PxRigidActor *actor = physics.createMeshFromGeometry(geometry->getGeometryData(), bodyType, collisionProxy);
 
     // Erstelle das RenderObject als shared_ptr
     std::shared_ptr<RenderObject> renderObj;
@@ -68,12 +68,6 @@ std::shared_ptr<RenderObject> GLTFLoader::loadModel(const std::string &filePath,
     else
         renderObj = std::make_shared<RenderObject>(geometry, static_cast<PxRigidDynamic *>(actor));
 
-    // Setze userData hier korrekt
-    if (actor)
-    {
-        actor->userData = renderObj.get();
-    }
-
     return renderObj;
 }
 
@@ -21,7 +21,8 @@ public:
         std::shared_ptr<Material> bloomyMaterial,
         std::shared_ptr<Material> ditherMaterial,
         uint32_t worldMask,
-        RigidBodyType bodyType);
+        RigidBodyType bodyType,
+        const CollisionProxy::Settings &collisionProxy = CollisionProxy::Settings());
 
 private:
     Physics &physics;
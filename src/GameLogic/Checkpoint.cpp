@@ -0,0 +1,58 @@
+#include "Checkpoint.h"
+#include "../Log.h"
+#include <fstream>
+
+Checkpoint::Writer::Writer()
+{
+    write(MAGIC);
+    write(VERSION);
+    write(uint32_t(0));
+}
+
+std::vector<uint8_t> Checkpoint::Writer::finish()
+{
+    uint32_t payloadSize = static_cast<uint32_t>(blob.size() - HEADER_SIZE);
+    std::memcpy(blob.data() + 2 * sizeof(uint32_t), &payloadSize, sizeof(payloadSize));
+    return std::move(blob);
+}
+
+Checkpoint::Reader::Reader(const std::vector<uint8_t> &blob) : blob(blob)
+{
+    if (blob.size() < HEADER_SIZE)
+        return;
+
+    uint32_t header[3];
+    std::memcpy(header, blob.data(), HEADER_SIZE);
+    if (header[0] != MAGIC)
+        LOG_WARN(Log::GAME, "checkpoint has no valid header");
+    else if (header[1] != VERSION)
+        LOG_WARN(Log::GAME, "checkpoint version %u does not match version %u", header[1], VERSION);
+    else if (header[2] != blob.size() - HEADER_SIZE)
+        LOG_WARN(Log::GAME, "checkpoint is truncated");
+    else
+        valid = true;
+}
+
+bool Checkpoint::saveToFile(const std::string &path, const std::vector<uint8_t> &blob)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(blob.data()), static_cast<std::streamsize>(blob.size()));
+    if (!file)
+    {
+        LOG_ERROR(Log::GAME, "could not write checkpoint %s", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool Checkpoint::loadFromFile(const std::string &path, std::vector<uint8_t> &blob)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+
+    blob.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(blob.data()), static_cast<std::streamsize>(blob.size()));
+    return static_cast<bool>(file);
+}
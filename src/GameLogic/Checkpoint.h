@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*!
+ * Versioned binary blob of a game snapshot, see Game::saveCheckpoint.
+ * Layout: magic, version, payload size, payload. The payload is a flat sequence of trivially
+ * copyable values that the reader takes back in the order the writer put them in, so any
+ * change to that order needs a new VERSION. Structs with padding go in field by field, the
+ * blob is hashed for replay checksums and must not depend on uninitialized bytes.
+ */
+class Checkpoint
+{
+public:
+    static constexpr uint32_t MAGIC = 0x4b435044; // "DPCK"
+    static constexpr uint32_t VERSION = 3;
+    static constexpr size_t HEADER_SIZE = 3 * sizeof(uint32_t);
+
+    class Writer
+    {
+    public:
+        Writer();
+
+        template <typename T>
+        void write(const T &value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "checkpoints only hold plain values");
+            size_t offset = blob.size();
+            blob.resize(offset + sizeof(T));
+            std::memcpy(blob.data() + offset, &value, sizeof(T));
+        }
+
+        /*!
+         * Fills in the payload size and hands out the blob
+         */
+        std::vector<uint8_t> finish();
+
+    private:
+        std::vector<uint8_t> blob;
+    };
+
+    class Reader
+    {
+    public:
+        /*!
+         * Checks magic, version and size, isValid tells whether the blob can be read
+         */
+        explicit Reader(const std::vector<uint8_t> &blob);
+
+        bool isValid() const { return valid; }
+
+        /*!
+         * @return false when the blob ends early, the reader stays invalid from then on
+         */
+        template <typename T>
+        bool read(T &value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "checkpoints only hold plain values");
+            if (!valid || offset + sizeof(T) > blob.size())
+                return valid = false;
+            std::memcpy(&value, blob.data() + offset, sizeof(T));
+            offset += sizeof(T);
+            return true;
+        }
+
+    private:
+        const std::vector<uint8_t> &blob;
+        size_t offset = HEADER_SIZE;
+        bool valid = false;
+    };
+
+    static bool saveToFile(const std::string &path, const std::vector<uint8_t> &blob);
+    static bool loadFromFile(const std::string &path, std::vector<uint8_t> &blob);
+};
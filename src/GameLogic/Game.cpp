@@ -1,6 +1,14 @@
 #include "Game.h"
 #include "../Render/ShadowPass.h"
 #include "../Render/BasePass.h"
+#include "../ShaderBuildQueue.h"
+#include "../FramePacer.h"
+#include "../PhysicsTelemetry.h"
+#include "../InputRecorder.h"
+#include "../Entities/EntitySystems.h"
+#include <random>
+#include <chrono>
+#include <filesystem>
 
 Game::Game(GLFWwindow *window)
     : interaction(false),
@@ -13,21 +21,28 @@ Game::Game(GLFWwindow *window)
 
     // Initialize physX Scene
     physics.initPhysX();
+    sceneQueries = std::make_unique<SceneQueries>(physics.gScene);
 
     lastX = window_width / 2.0f;
     lastY = window_height / 2.0f;
 
-    // Create shaders
-    std::shared_ptr<Shader> textureShader = std::make_shared<Shader>("assets/shaders/texture.vert", "assets/shaders/texture.frag");
-    std::shared_ptr<Shader> simpleColorShader = std::make_shared<Shader>("assets/shaders/simpleColor.vert", "assets/shaders/simpleColor.frag");
-    ditherShader = std::make_shared<Shader>("assets/shaders/orderedDither.vert", "assets/shaders/orderedDither.frag");
-    std::shared_ptr<Shader> waterShader = std::make_shared<Shader>("assets/shaders/water.vert", "assets/shaders/water.frag");
-    std::shared_ptr<Shader> planeShader = std::make_shared<Shader>("assets/shaders/infPlane.vert", "assets/shaders/infPlane.frag");
-    std::shared_ptr<Shader> shadowShader = std::make_shared<Shader>("assets/shaders/shadow.vert", "assets/shaders/shadow.frag");
-    std::shared_ptr<Shader> textureNormalShader = std::make_shared<Shader>("assets/shaders/textureNormal.vert", "assets/shaders/textureNormal.frag");
-    std::shared_ptr<Shader> textureNormalBloomShader = std::make_shared<Shader>("assets/shaders/textureNormalBloom.vert", "assets/shaders/textureNormalBloom.frag");
+    INIReader graphics_reader("assets/settings/graphics.ini");
 
-    transitionShader = std::make_shared<Shader>("assets/shaders/transition.vert", "assets/shaders/transition.frag");
+    // the bindless shader variants only compile where the extension exists
+    materialTable = std::make_unique<MaterialTable>(graphics_reader.GetBoolean("renderer", "bindless_textures", true));
+    uint32_t unavailableFeatures = materialTable->usesBindlessTextures() ? SHADER_FEATURE_NONE : SHADER_FEATURE_BINDLESS_TEXTURES;
+    ShaderPermutations::setAvailableFeatures(~unavailableFeatures);
+
+    // Create shaders, while the ShaderBuildQueue is open they compile as the assets below load
+    std::shared_ptr<ShaderPermutations> simpleColorShader = std::make_shared<ShaderPermutations>("assets/shaders/simpleColor.vert", "assets/shaders/simpleColor.frag");
+    ditherShader = std::make_shared<ShaderPermutations>("assets/shaders/orderedDither.vert", "assets/shaders/orderedDither.frag", SHADER_FEATURE_BLOOMY_WORLD);
+    std::shared_ptr<ShaderPermutations> waterShader = std::make_shared<ShaderPermutations>("assets/shaders/water.vert", "assets/shaders/water.frag");
+    std::shared_ptr<ShaderPermutations> planeShader = std::make_shared<ShaderPermutations>("assets/shaders/infPlane.vert", "assets/shaders/infPlane.frag", SHADER_FEATURE_BLOOMY_WORLD);
+    std::shared_ptr<ShaderPermutations> shadowShader = std::make_shared<ShaderPermutations>("assets/shaders/shadow.vert", "assets/shaders/shadow.frag");
+    std::shared_ptr<ShaderPermutations> textureNormalShader = std::make_shared<ShaderPermutations>("assets/shaders/textureNormal.vert", "assets/shaders/textureNormal.frag", SHADER_FEATURE_NORMAL_MAP | SHADER_FEATURE_BINDLESS_TEXTURES);
+    std::shared_ptr<ShaderPermutations> textureNormalBloomShader = std::make_shared<ShaderPermutations>("assets/shaders/textureNormalBloom.vert", "assets/shaders/textureNormalBloom.frag", SHADER_FEATURE_NORMAL_MAP | SHADER_FEATURE_BINDLESS_TEXTURES);
+
+    transitionShader = std::make_shared<PreprocessedShader>("assets/shaders/transition.vert", "assets/shaders/transition.frag");
 
     shaders.push_back(shadowShader);
     shaders.push_back(simpleColorShader);
@@ -58,10 +73,16 @@ Game::Game(GLFWwindow *window)
     std::shared_ptr<Material> planeMaterial = std::make_shared<Material>(planeShader, glm::vec3(0.95f, 0.95, 0.95f), glm::vec3(0.5f, 0.5f, 0.0f), 1.0f);
     std::shared_ptr<Material> simpleRedColorMaterial = std::make_shared<Material>(simpleColorShader, redColor, glm::vec3(0.5f, 0.5f, 0.0f), 1.0f);
     std::shared_ptr<Material> waterMaterial = std::make_shared<Material>(waterShader, glm::vec3(0.95f, 0.95, 0.95f), glm::vec3(0.5f, 0.5f, 0.0f), 1.0f);
+    waterMaterial->setDepthPrepass(false); // waves are displaced in the vertex shader
     std::shared_ptr<Material> concreteMaterial = std::make_shared<TextureMaterial>(textureNormalShader, glm::vec3(1.0f, 0.9f, 0.6f), 8.0f, concreteTexture, concreteNormalMapTexture);
     std::shared_ptr<Material> noteMaterialBloomy = std::make_shared<TextureMaterial>(textureNormalBloomShader, glm::vec3(1.0f, 0.1f, 0.0f), 20.0f, noteDiffuse);
     std::shared_ptr<Material> noteMaterial = std::make_shared<TextureMaterial>(textureNormalShader, glm::vec3(1.0f, 0.2f, 0.0f), 20.0f, noteDiffuse);
 
+    for (const auto &material : {remoteTextureMaterial, ditherMaterial, ditherFloorMaterial, simpleGreyColorMaterial, planeMaterial,
+                                 simpleRedColorMaterial, waterMaterial, concreteMaterial, noteMaterialBloomy, noteMaterial})
+        materialTable->add(material);
+    materialTable->build();
+
     // Create geometries
     GLTFLoader loader(physics);
 
@@ -71,12 +92,21 @@ Game::Game(GLFWwindow *window)
     ditherWaterFloor = loader.loadModel("assets/models/dither_water.glb", nullptr, waterMaterial, WORLD_DITHER, RigidBodyType::NONE);
     renderObjects.push_back(ditherWaterFloor);
 
-    auto ditherFloor = loader.loadModel("assets/models/floor_dither.glb", nullptr, ditherFloorMaterial, WORLD_DITHER, RigidBodyType::STATIC);
-    ditherFloor->id = "floor";
+    // floors collide as height fields when they are single layered, the controller sweeps a grid instead of a triangle soup
+    INIReader physics_reader("assets/settings/physics.ini");
+    CollisionProxy::Settings floorProxy;
+    floorProxy.type = physics_reader.GetBoolean("floors", "heightfield", true) ? CollisionProxy::Type::HEIGHTFIELD : CollisionProxy::Type::AUTO;
+    floorProxy.cellSize = static_cast<float>(physics_reader.GetReal("floors", "cell_size", 0.1));
+    floorProxy.heightTolerance = static_cast<float>(physics_reader.GetReal("floors", "height_tolerance", 0.02));
+
+    auto ditherFloor = loader.loadModel("assets/models/floor_dither.glb", nullptr, ditherFloorMaterial, WORLD_DITHER, RigidBodyType::STATIC, floorProxy);
+    ditherFloor->setIdentifier("floor");
+    ditherFloor->removeTag(TAG_CASTS_SHADOW);
     renderObjects.push_back(ditherFloor);
 
-    auto bloomyFloor = loader.loadModel("assets/models/floor_bloomy.glb", planeMaterial, ditherMaterial, WORLD_BLOOM, RigidBodyType::STATIC);
-    bloomyFloor->id = "floor";
+    auto bloomyFloor = loader.loadModel("assets/models/floor_bloomy.glb", planeMaterial, ditherMaterial, WORLD_BLOOM, RigidBodyType::STATIC, floorProxy);
+    bloomyFloor->setIdentifier("floor");
+    bloomyFloor->removeTag(TAG_CASTS_SHADOW);
     renderObjects.push_back(bloomyFloor);
 
     bloomyWaterFloor = loader.loadModel("assets/models/bloomy_water.glb", ditherMaterial, ditherMaterial, WORLD_BLOOM, RigidBodyType::NONE);
@@ -88,14 +118,23 @@ Game::Game(GLFWwindow *window)
     auto jumpnrun_bloomy = loader.loadModel("assets/models/jumpnrun_bloomy.glb", concreteMaterial, ditherMaterial, WORLD_BLOOM, RigidBodyType::STATIC);
     renderObjects.push_back(jumpnrun_bloomy);
 
+    // the level geometry hides most of the props behind it, everything else is only tested
+    if (graphics_reader.GetBoolean("renderer", "occlusion_culling", true))
+    {
+        occlusionCuller = std::make_unique<OcclusionCuller>(320, static_cast<float>(window_width) / static_cast<float>(window_height));
+        for (auto &occluder : {envStructure, jumpnrun_dither, jumpnrun_bloomy})
+            occlusionCuller->addOccluder(occluder.get());
+    }
+
     note = loader.loadModel("assets/models/note.glb", noteMaterialBloomy, noteMaterialBloomy, WORLD_BLOOM, RigidBodyType::STATIC);
     note->setPosition(notePosition);
     note->setAsPickable();
-    note->id = "note";
+    note->setIdentifier("note");
+    note->addTag(TAG_NOTE);
     renderObjects.push_back(note);
 
     closeUpNote = loader.loadModel("assets/models/note_closeup.glb", noteMaterial, noteMaterial, WORLD_BLOOM, RigidBodyType::NONE);
-    closeUpNote->isRendered = false;
+    closeUpNote->setRendered(false);
 
     renderObjects.push_back(closeUpNote);
 
@@ -107,7 +146,8 @@ Game::Game(GLFWwindow *window)
     remote->setPosition(remotePosition);
     remote->setAsPickable();
 
-    remote->id = "remote";
+    remote->setIdentifier("remote");
+    remote->addTag(TAG_REMOTE);
     renderObjects.push_back(remote);
 
     // Initialize Player
@@ -127,27 +167,68 @@ Game::Game(GLFWwindow *window)
         /*wallThickness=*/0.1f);
 
     // Render passes
-    shadowPass = std::make_unique<ShadowPass>(shadowShader.get(), 10000, 10000, renderObjects, in_bloomy_world);
-    basePass = std::make_unique<BasePass>(window_width, window_height, renderObjects, player.get(), in_bloomy_world, underwater);
+    drawLists = std::make_unique<SceneDrawLists>();
+    shadowPass = std::make_unique<ShadowPass>(shadowShader->get(SHADER_FEATURE_NONE), 10000, 10000, *drawLists);
+    basePass = std::make_unique<BasePass>(window_width, window_height, *drawLists, player.get(), in_bloomy_world);
+
+    basePass->setDepthPrepass(graphics_reader.GetBoolean("renderer", "depth_prepass", true));
+    basePass->setAntialiasing(BasePass::parseAntialiasing(graphics_reader.Get("renderer", "antialiasing", "msaa")),
+                              static_cast<int>(graphics_reader.GetInteger("renderer", "msaa_samples", 4)));
+
+    // the GPU gets a share of the display's frame time, the rest is left for the CPU and the driver
+    INIReader window_reader("assets/settings/window.ini");
+    float refreshRate = static_cast<float>(std::max(1L, window_reader.GetInteger("window", "refresh_rate", 60)));
+    basePass->configureDynamicResolution(
+        1000.0f / refreshRate * static_cast<float>(graphics_reader.GetReal("dynamic_resolution", "gpu_budget", 0.9)),
+        static_cast<float>(graphics_reader.GetReal("dynamic_resolution", "min_scale", 0.5)),
+        static_cast<float>(graphics_reader.GetReal("dynamic_resolution", "max_scale", 1.0)),
+        static_cast<float>(graphics_reader.GetReal("dynamic_resolution", "sharpness", 0.5)));
+    basePass->setDynamicResolution(graphics_reader.GetBoolean("dynamic_resolution", "enabled", true));
+
+    waterPass = std::make_unique<WaterPass>(
+        static_cast<int>(graphics_reader.GetInteger("water", "resolution", 512)),
+        static_cast<float>(graphics_reader.GetReal("water", "tile_size", 4.0)),
+        static_cast<float>(graphics_reader.GetReal("water", "update_rate", 30.0)),
+        t);
+
+    drawData = std::make_unique<DrawDataBuffer>(renderObjects.size());
+
+    // all shaders are submitted, wait for the driver before the first one is used
+    ShaderBuildQueue::finish();
+    waterPass->setUniforms(waterShader->get(SHADER_FEATURE_NONE), BasePass::WATER_HEIGHTFIELD_UNIT);
+    basePass->buildGraph(shadowPass.get(), waterPass.get());
+
     // Initialize lights
     dirL = DirectionalLight(glm::vec3(0.8f), glm::vec3(0.0f, -1.0f, -1.0f));
     pointL = PointLight(glm::vec3(1), glm::vec3(0.0f, 0.1f, 0.0f), glm::vec3(1.0f, 8.0f, 8.0f));
+    clusteredLighting = std::make_unique<ClusteredLighting>(window_width, window_height);
+    createBloomLights(static_cast<int>(graphics_reader.GetInteger("lighting", "bloom_lights", 256)));
 
-    // Render loop setup
-    t = float(glfwGetTime());
+    // Render loop setup, recorded and replayed runs start their clock at zero so both see the same times
+    lastTime = float(glfwGetTime());
+    t = InputRecorder::isActive() ? 0.0f : lastTime;
     dt = 0.0f;
     t_sum = 0.0f;
-    lastTime = t;
     double mouse_x, mouse_y;
 
+    // the remote is a slim block: prefer a primitive, otherwise a small hull
+    CollisionProxy::Settings remoteProxy;
+    remoteProxy.type = CollisionProxy::Type::AUTO;
+    remoteProxy.tolerance = 0.1f;
+    remoteProxy.maxHullVertices = 16;
     player->setRemoteThrowable(loader.loadModel(
         "assets/models/remote_static.glb",
         remoteTextureMaterial,
         ditherMaterial,
         WORLD_BOTH,
-        RigidBodyType::DYNAMIC));
+        RigidBodyType::DYNAMIC,
+        remoteProxy));
     renderObjects.push_back(player->getRemoteThrowable());
 
+    registerEntities();
+
+    createTriggers();
+
     hud = std::make_unique<HeadsUpDisplay>(&player->getState(), &show_controls_guide, window_width, window_height);
 
     std::string rel = "assets/sound/Calmed_Sub.wav";
@@ -194,12 +275,19 @@ Game::Game(GLFWwindow *window)
 
 void Game::Shutdown()
 {
+    registry.clear();
     renderObjects.clear();
 
     hud = nullptr;
     player = nullptr;
-    shadowPass = nullptr;
     basePass = nullptr;
+    shadowPass = nullptr;
+    waterPass = nullptr;
+    drawData = nullptr;
+    drawLists = nullptr;
+    occlusionCuller = nullptr;
+    sceneQueries = nullptr;
+    materialTable = nullptr;
     transitionShader = nullptr;
     shaders.clear();
 
@@ -213,73 +301,77 @@ void Game::Run()
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
     /*--FRAME TIMING--**/
-    dt = t;
-    t = float(glfwGetTime());
-    dt = t - lastTime;
-    lastTime = t;
+    float now = float(glfwGetTime());
+    // a replay takes the recorded step instead of the measured one
+    dt = InputRecorder::beginFrame(window, now - lastTime);
+    lastTime = now;
+    t += dt;
     t_sum += dt;
 
-    /*--ANIMATING OBJECTS--*/
-    if (remote && remote->isRendered && !player->getState().IsRemoteInInventory())
-    {
-        float yOffset = sin(t * 2.f) * 0.04f;
-        remote->setPosition(remotePosition + glm::vec3(0.0f, yOffset, 0.0f));
-    }
-    if (note && note->isRendered && !player->getState().IsNoteInInventory())
-    {
-        float yOffset = sin(t * 2.f) * 0.04f;
-        note->setPosition(notePosition + glm::vec3(0.0f, yOffset, 0.0f));
-    }
+    /*--PROCESS INPUT--*/
+    // input and simulation run before the view is built, so the frame shows this frame's input
+    InputRecorder::getCursorPos(window, &xpos, &ypos);
+    processMouseInput(xpos, ypos);
+    processInput(window, dt);
+    // queries enqueued by input run together, their results arrive before the player moves
+    sceneQueries->execute();
 
-    float waterSpeed = 0.0002f;
-    bloomyWaterFloor->setPosition(bloomyWaterFloor->geometry->getPosition() + glm::vec3(0.0f, waterSpeed, 0.0f));
+    /*--PLAYER UPDATES--*/
+    player->update(dt, physics.gScene);
 
-    pointL.position = player->getPosition();
+    float playerPos = player->getPosition().y;
 
-    /*--RENDERING--**/
-    for (std::shared_ptr<Shader> shader : shaders)
+    /*--TRIGGERS--*/
+    updateTriggers();
+
+    if (playerPos > 5.3f)
     {
-        setPerFrameUniforms(shader.get(), camera, dirL, pointL);
+        player->getState().ChargeRemote(dt);
+        // player->getState().Heal(10);
     }
-    shadowPass->Execute();
-
-    ditherShader->use();
-    ditherShader->setUniform("drawBloom", (int)in_bloomy_world);
-    basePass->Execute();
 
-    /*--TRANSITION--**/
-    if (transitionActive)
+    if (in_bloomy_world)
     {
-        transitionTimer += dt;
-
-        if (transitionTimer >= 0.25 && should_transition)
+        if (feetInBloomyWater)
         {
-            in_bloomy_world = !in_bloomy_world;
-            if (in_bloomy_world)
-                player->getState().Heal(30.0f);
-
-            player->setInBloomyWorld(in_bloomy_world);
-            should_transition = false;
+            player->registerDamage(dt, 10.0f, damageSound);
         }
+        underwater = headInBloomyWater;
+    }
 
-        float alpha = 0.0f;
-        if (transitionTimer < 0.25f)
-            alpha = transitionTimer * 4.0f;
-        else
-            alpha = (1.0f - transitionTimer) * 2.0f;
+    if (!in_bloomy_world && !feetInDitherWater)
+    {
+        player->registerDamage(dt, 2.0f, damageSound);
+        player->getState().DrainRemote(dt);
+    }
 
-        drawFullScreenQuadWithAlpha(alpha);
+    if (in_bloomy_world || feetInDitherWater)
+        player->getState().ChargeRemote(dt);
 
-        if (transitionTimer >= 1.0f)
-            transitionActive = false;
+    if (player->getState().GetHealth() <= 0.0f || playerPos <= -5.0f)
+    {
+        g_GameState = GameState::GameOver;
+        return;
     }
+    updatePhysics(dt);
+
+    /*--ANIMATING OBJECTS--*/
+    EntitySystems::syncRigidBodies(registry, physics.gScene);
+    EntitySystems::animate(registry, t);
+    EntitySystems::updateTransforms(registry);
+
+    float waterSpeed = 0.0002f;
+    bloomyWaterFloor->setPosition(bloomyWaterFloor->geometry->getPosition() + glm::vec3(0.0f, waterSpeed, 0.0f));
+
+    pointL.position = player->getPosition();
+    updateLights();
 
     /*--HUD--**/
     bool shouldShowInstruction = false;
 
     if (player->getState().IsRemoteInInventory() && !remoteCloseUpShown && !remoteTimerStarted)
     {
-        remote->isRendered = true;
+        remote->setRendered(true);
         remoteTimerStarted = true;
         remoteDisplayStartTime = t;
     }
@@ -302,24 +394,20 @@ void Game::Run()
     }
     if (remoteTimerStarted && (t - remoteDisplayStartTime >= remoteDisplayDuration))
     {
-        remote->isRendered = false;
+        remote->setRendered(false);
         remoteCloseUpShown = true;
         remoteTimerStarted = false;
     }
-    if (remote && remote->isRendered && !remoteTimerStarted)
+    if (remote && remote->isRendered && !remoteTimerStarted && isNearby(remote.get()))
     {
-        float distance = glm::distance(remote->geometry->getPosition(), player->getPosition());
-        if (distance < 0.5f)
-        {
-            hud->SetInstructionText("Press [E] to pick up the remote");
-            shouldShowInstruction = true;
-        }
+        hud->SetInstructionText("Press [E] to pick up the remote");
+        shouldShowInstruction = true;
     }
 
     // note
     if (player->getState().IsNoteInInventory() && !noteCloseUpShown && !noteTimerStarted)
     {
-        closeUpNote->isRendered = true;
+        closeUpNote->setRendered(true);
         noteTimerStarted = true;
         noteDisplayStartTime = t;
     }
@@ -342,35 +430,19 @@ void Game::Run()
     }
     if (noteTimerStarted && (t - noteDisplayStartTime >= noteDisplayDuration))
     {
-        closeUpNote->isRendered = false;
+        closeUpNote->setRendered(false);
         noteCloseUpShown = true;
         noteTimerStarted = false;
     }
 
-    if (note && note->isRendered && !noteTimerStarted)
+    if (note && note->isRendered && !noteTimerStarted && isNearby(note.get()))
     {
-        float distance = glm::distance(note->geometry->getPosition(), player->getPosition());
-        if (distance < 0.5f)
-        {
-            hud->SetInstructionText("Press [E] to pick up the note");
-            shouldShowInstruction = true;
-        }
+        hud->SetInstructionText("Press [E] to pick up the note");
+        shouldShowInstruction = true;
     }
 
-    glm::vec2 zoneCenter(29.0f, 17.0f);
-    float zoneRadius = 5.0f;
-    float zoneHeightMin = -3.0f;
-    float zoneHeightMax = 3.0f;
-
-    // Only show "drop remote" if not showing "pickup remote"
-    glm::vec2 playerXZ(player->getPosition().x, player->getPosition().z);
-    float distanceToCenter = glm::distance(playerXZ, zoneCenter);
-    bool inCylindricalZone =
-        distanceToCenter <= zoneRadius &&
-        player->getPosition().y >= zoneHeightMin &&
-        player->getPosition().y <= zoneHeightMax;
-
-    if (!shouldShowInstruction && inCylindricalZone && !in_bloomy_world)
+    // Only show "drop remote" if not showing "pickup remote", the pit volume only exists in the dither world
+    if (!shouldShowInstruction && inPitZone)
     {
         hud->SetInstructionText("Press [F] to drop the remote into the pit");
         shouldShowInstruction = true;
@@ -379,83 +451,137 @@ void Game::Run()
     hud->SetShowInstruction(shouldShowInstruction);
     hud->Render();
 
-    /*--PROCESS INPUT--*/
-    glfwGetCursorPos(window, &xpos, &ypos);
-    processMouseInput(xpos, ypos);
-    processInput(window, dt);
-
-    /*--PLAYER UPDATES--*/
-    player->update(dt, physics.gScene);
-
-    if (player->getRemoteThrowable() && player->getRemoteThrowable()->isRendered)
+    /*--RENDERING--**/
+    clusteredLighting->setRenderSize(basePass->getRenderWidth(), basePass->getRenderHeight());
+    ShaderPermutations::setActiveFeatures(
+        (useNormalMap ? SHADER_FEATURE_NORMAL_MAP : SHADER_FEATURE_NONE) |
+        (in_bloomy_world ? SHADER_FEATURE_BLOOMY_WORLD : SHADER_FEATURE_NONE) |
+        (materialTable->usesBindlessTextures() ? SHADER_FEATURE_BINDLESS_TEXTURES : SHADER_FEATURE_NONE));
+    for (std::shared_ptr<ShaderPermutations> shader : shaders)
     {
-        player->getRemoteThrowable()->updateTransform();
+        setPerFrameUniforms(shader->getActive(), camera, dirL);
     }
+    materialTable->bind();
+    drawLists->update(renderObjects, in_bloomy_world ? WORLD_BLOOM : WORLD_DITHER, underwater);
+    if (occlusionCuller)
+        occlusionCuller->cull(*drawLists, in_bloomy_world ? WORLD_BLOOM : WORLD_DITHER, player->getViewProjectionMatrix());
+    drawData->update(*drawLists);
+    // the graph runs the shadow and water passes before the scene that samples them
+    basePass->Execute();
+    drawData->endFrame();
 
-    float playerSize = player->getSize();
-    float playerPos = player->getPosition().y;
-    float playerFeet = player->getFootPosition();
-
-    float ditherWaterPos = ditherWaterFloor->geometry->getPosition().y;
-    float bloomyWaterPos = bloomyWaterFloor->geometry->getPosition().y;
-
-    if (playerPos > 5.3f)
+    /*--TRANSITION--**/
+    if (transitionActive)
     {
-        player->getState().ChargeRemote(dt);
-        // player->getState().Heal(10);
-    }
+        transitionTimer += dt;
 
-    if (in_bloomy_world)
-    {
-        if ((playerFeet <= bloomyWaterPos))
+        if (transitionTimer >= 0.25 && should_transition)
         {
-            player->registerDamage(dt, 10.0f, damageSound);
-        }
+            in_bloomy_world = !in_bloomy_world;
+            if (in_bloomy_world)
+                player->getState().Heal(30.0f);
 
-        if ((playerPos >= bloomyWaterPos))
-        {
-            underwater = false;
+            player->setInBloomyWorld(in_bloomy_world);
+            should_transition = false;
         }
-        if ((playerPos < bloomyWaterPos))
+
+        float alpha = 0.0f;
+        if (transitionTimer < 0.25f)
+            alpha = transitionTimer * 4.0f;
+        else
+            alpha = (1.0f - transitionTimer) * 2.0f;
+
+        drawFullScreenQuadWithAlpha(alpha);
+
+        if (transitionTimer >= 1.0f)
+            transitionActive = false;
+    }
+
+    if (show_debug_overlay)
+    {
+        basePass->getStats(frameStats);
+        frameStats.lightCount = clusteredLighting->getLightCount();
+        frameStats.lightAssignments = clusteredLighting->getAssignedLightCount();
+        frameStats.drawRecords = static_cast<unsigned int>(drawData->getDrawCount());
+        frameStats.drawDataPersistent = drawData->isPersistent();
+        frameStats.drawListRebuilds = drawLists->getRebuildCount();
+        frameStats.sceneQueries = sceneQueries->getLastBatchSize();
+        frameStats.sceneQueryMs = sceneQueries->getLastBatchMilliseconds();
+        if (occlusionCuller)
         {
-            underwater = true;
+            const OcclusionCuller::Stats &culling = occlusionCuller->getStats();
+            frameStats.occlusionCulling = true;
+            frameStats.occluders = culling.occluders;
+            frameStats.occluderTriangles = culling.occluderTriangles;
+            frameStats.occlusionTested = culling.tested;
+            frameStats.occlusionCulled = culling.occluded;
+            frameStats.outsideView = culling.outsideView;
+            frameStats.occlusionMs = culling.milliseconds;
         }
+        frameStats.latencyMs = FramePacer::getLatencyMilliseconds();
+        frameStats.vsync = FramePacer::getVSyncName(FramePacer::getVSync());
+        frameStats.fpsLimit = FramePacer::getFpsLimit();
+        frameStats.lowLatency = FramePacer::isLowLatency();
+        debugOverlay.Render(frameStats);
     }
-    if (in_bloomy_world && (playerPos < bloomyWaterPos))
+
+    if (show_physics_panel)
     {
+        physicsPanel.Render();
     }
 
-    if (!in_bloomy_world && playerFeet > ditherWaterPos)
+    // FPS counter logic
+    fpsTimer += dt;
+    frameCount++;
+
+    if (fpsTimer >= 1.0f)
     {
-        player->registerDamage(dt, 2.0f, damageSound);
-        player->getState().DrainRemote(dt);
-    }
+        frameStats.fps = frameCount / fpsTimer;
+        frameStats.frameMs = 1000.0f * fpsTimer / frameCount;
 
-    if (in_bloomy_world || playerFeet <= ditherWaterPos)
-        player->getState().ChargeRemote(dt);
+        fpsTimer = 0.0f;
+        frameCount = 0;
+    }
+}
 
-    if (player->getState().GetHealth() <= 0.0f || playerPos <= -5.0f)
+void Game::createBloomLights(int count)
+{
+    // fixed seed, the glowing lights float at the same spots every run
+    std::mt19937 rng(1337);
+    std::uniform_real_distribution<float> x(-8.0f, 35.0f), y(0.5f, 5.0f), z(-15.0f, 35.0f);
+    std::uniform_int_distribution<int> palette(0, 2);
+
+    const glm::vec3 colors[3] = {
+        glm::vec3(162.0f / 255.0f, 129.0f / 255.0f, 160 / 255.0f),
+        glm::vec3(151.0f / 255.0f, 154.0f / 255.0f, 187 / 255.0f),
+        glm::vec3(1.0f, 0.75f, 0.45f)};
+
+    bloomLights.clear();
+    for (int i = 0; i < count; i++)
     {
-        g_GameState = GameState::GameOver;
-        return;
+        bloomLights.push_back(PointLight(colors[palette(rng)] * 0.8f, glm::vec3(x(rng), y(rng), z(rng)), glm::vec3(1.0f, 2.0f, 6.0f)));
     }
-    updatePhysics(dt);
+}
 
-    // FPS counter logic
-    // fpsTimer += dt;
-    // frameCount++;
+void Game::updateLights()
+{
+    frameLights.clear();
+    frameLights.push_back(pointL);
 
-    // if (fpsTimer >= 1.0f)
-    // {
-    //     float currentFPS = frameCount / fpsTimer;
-    //     std::cout << "FPS: " << currentFPS << std::endl;
+    if (in_bloomy_world)
+    {
+        for (size_t i = 0; i < bloomLights.size(); i++)
+        {
+            PointLight light = bloomLights[i];
+            light.position.y += sin(t * 0.8f + i * 0.37f) * 0.25f;
+            frameLights.push_back(light);
+        }
+    }
 
-    //     fpsTimer = 0.0f;
-    //     frameCount = 0;
-    // }
+    clusteredLighting->update(frameLights, player->getCamera().getProjectionMatrix(), player->getViewProjectionMatrix());
 }
 
-void Game::setPerFrameUniforms(Shader *shader, POVCamera &camera, DirectionalLight &dirL, PointLight &pointL)
+void Game::setPerFrameUniforms(Shader *shader, POVCamera &camera, DirectionalLight &dirL)
 {
 
     // get projection around position, so shadowmap is dynamic to player position
@@ -480,23 +606,441 @@ void Game::setPerFrameUniforms(Shader *shader, POVCamera &camera, DirectionalLig
     // Uniforms setzen
     shader->use();
     shader->setUniform("u_time", (float)glfwGetTime());
-    shader->setUniform("in_bloomy_world", in_bloomy_world);
-    shader->setUniform("shadowMap", 5);
+    shader->setUniform("shadowMap", int(BasePass::SHADOW_MAP_UNIT));
     shader->setUniform("lightSpaceMatrix", lightSpaceMatrix);
     shader->setUniform("viewProjMatrix", player->getViewProjectionMatrix());
     shader->setUniform("camera_world", camPos);
     shader->setUniform("dirL.color", dirL.color);
     shader->setUniform("dirL.direction", dirL.direction);
-    shader->setUniform("pointL.color", pointL.color);
-    shader->setUniform("pointL.position", pointL.position);
-    shader->setUniform("pointL.attenuation", pointL.attenuation);
-    shader->setUniform("useNormalMap", useNormalMap ? 1 : 0);
+    clusteredLighting->setUniforms(shader);
+    materialTable->setUniforms(shader);
+}
+
+// the water volumes cover the level inside the bounding walls, their tops follow the water planes
+static const glm::vec3 waterVolumeMin(-9.0f, -1000.0f, -16.0f);
+static const glm::vec3 waterVolumeMax(36.0f, 0.0f, 36.0f);
+
+static glm::vec3 getWaterVolumeMax(float waterHeight)
+{
+    return glm::vec3(waterVolumeMax.x, waterHeight, waterVolumeMax.z);
+}
+
+void Game::registerEntities()
+{
+    for (const auto &obj : renderObjects)
+    {
+        EntityHandle entity = registry.create();
+        obj->entity.handle = entity;
+        registry.transforms.add(entity, TransformComponent());
+        registry.renderables.add(entity, {obj.get()});
+        if (physx::PxRigidActor *actor = obj->getRigidActor())
+            registry.rigidBodies.add(entity, {actor, obj->dynamicBody != nullptr});
+        // pickups react within the distance Player::tryPickupNearbyObject accepts
+        if (obj->hasTag(TAG_PICKABLE))
+            registry.pickables.add(entity, {0.5f});
+    }
+
+    registry.animations.add(remote->entity.handle, {remotePosition, 0.04f, 2.0f});
+    registry.animations.add(note->entity.handle, {notePosition, 0.04f, 2.0f});
+
+    EntitySystems::pullTransforms(registry);
+}
+
+void Game::createTriggers()
+{
+    triggers = std::make_unique<TriggerSystem>();
+
+    const std::vector<EntityHandle> &pickupEntities = registry.pickables.getEntities();
+    const std::vector<PickableComponent> &pickups = registry.pickables.getComponents();
+    for (size_t i = 0; i < pickups.size(); ++i)
+    {
+        const TransformComponent *transform = registry.transforms.get(pickupEntities[i]);
+        RenderObject *object = registry.renderables.get(pickupEntities[i])->object;
+        TriggerSystem::Handle volume = triggers->addSphere(transform->position, pickups[i].radius, TriggerSystem::Probe::HEAD,
+                                                           WORLD_BOTH, TRIGGER_PICKUP, object);
+        registry.triggers.add(pickupEntities[i], {volume});
+    }
+
+    triggers->addCylinder(glm::vec3(29.0f, -3.0f, 17.0f), 5.0f, 6.0f, TriggerSystem::Probe::HEAD, WORLD_DITHER, TRIGGER_PIT);
+
+    bloomyWaterFeetTrigger = triggers->addBox(waterVolumeMin, waterVolumeMax, TriggerSystem::Probe::FEET, WORLD_BOTH, TRIGGER_BLOOMY_WATER_FEET);
+    bloomyWaterHeadTrigger = triggers->addBox(waterVolumeMin, waterVolumeMax, TriggerSystem::Probe::HEAD, WORLD_BOTH, TRIGGER_BLOOMY_WATER_HEAD);
+    ditherWaterTrigger = triggers->addBox(waterVolumeMin, waterVolumeMax, TriggerSystem::Probe::FEET, WORLD_BOTH, TRIGGER_DITHER_WATER_FEET);
+}
+
+void Game::updateTriggers()
+{
+    // the few volumes that move, the bloomy water rises every frame
+    float bloomyWaterPos = bloomyWaterFloor->geometry->getPosition().y;
+    float ditherWaterPos = ditherWaterFloor->geometry->getPosition().y;
+    triggers->setBox(bloomyWaterFeetTrigger, waterVolumeMin, getWaterVolumeMax(bloomyWaterPos));
+    triggers->setBox(bloomyWaterHeadTrigger, waterVolumeMin, getWaterVolumeMax(bloomyWaterPos));
+    triggers->setBox(ditherWaterTrigger, waterVolumeMin, getWaterVolumeMax(ditherWaterPos));
+
+    // pickups follow their entity
+    EntitySystems::updateTriggers(registry, *triggers);
+
+    glm::vec3 head = player->getPosition();
+    glm::vec3 feet(head.x, player->getFootPosition(), head.z);
+    triggers->update(head, feet, in_bloomy_world ? WORLD_BLOOM : WORLD_DITHER);
+    handleTriggerEvents();
+}
+
+void Game::handleTriggerEvents()
+{
+    for (const TriggerSystem::Event &event : triggers->getEvents())
+    {
+        switch (event.tag)
+        {
+        case TRIGGER_PICKUP:
+        {
+            RenderObject *pickup = static_cast<RenderObject *>(event.user);
+            if (event.entered)
+                nearbyPickups.push_back(pickup);
+            else
+                nearbyPickups.erase(std::remove(nearbyPickups.begin(), nearbyPickups.end(), pickup), nearbyPickups.end());
+            break;
+        }
+        case TRIGGER_PIT:
+            inPitZone = event.entered;
+            break;
+        case TRIGGER_BLOOMY_WATER_FEET:
+            feetInBloomyWater = event.entered;
+            break;
+        case TRIGGER_BLOOMY_WATER_HEAD:
+            headInBloomyWater = event.entered;
+            break;
+        case TRIGGER_DITHER_WATER_FEET:
+            feetInDitherWater = event.entered;
+            break;
+        }
+    }
+}
+
+bool Game::isNearby(const RenderObject *object) const
+{
+    return std::find(nearbyPickups.begin(), nearbyPickups.end(), object) != nearbyPickups.end();
+}
+
+namespace
+{
+    // one per render object, in the order of renderObjects
+    struct ObjectRecord
+    {
+        uint8_t rendered;
+        uint8_t inScene;
+        uint32_t tags;
+        uint32_t group, mask;
+        float pose[7];
+        float linearVelocity[3];
+        float angularVelocity[3];
+    };
+
+    // field by field, the padding of the structs would put indeterminate bytes into the blob and the checksum
+    void writeRecord(Checkpoint::Writer &writer, const ObjectRecord &record)
+    {
+        writer.write(record.rendered);
+        writer.write(record.inScene);
+        writer.write(record.tags);
+        writer.write(record.group);
+        writer.write(record.mask);
+        writer.write(record.pose);
+        writer.write(record.linearVelocity);
+        writer.write(record.angularVelocity);
+    }
+
+    void readRecord(Checkpoint::Reader &reader, ObjectRecord &record)
+    {
+        reader.read(record.rendered);
+        reader.read(record.inScene);
+        reader.read(record.tags);
+        reader.read(record.group);
+        reader.read(record.mask);
+        reader.read(record.pose);
+        reader.read(record.linearVelocity);
+        reader.read(record.angularVelocity);
+    }
+
+    void writeSnapshot(Checkpoint::Writer &writer, const PlayerState::Snapshot &snapshot)
+    {
+        writer.write(snapshot.health);
+        writer.write(snapshot.stamina);
+        writer.write(snapshot.remoteCharge);
+        writer.write(snapshot.timeSinceLastDamage);
+        writer.write(snapshot.remoteInInventory);
+        writer.write(snapshot.noteInInventory);
+        writer.write(snapshot.exhausted);
+    }
+
+    void readSnapshot(Checkpoint::Reader &reader, PlayerState::Snapshot &snapshot)
+    {
+        reader.read(snapshot.health);
+        reader.read(snapshot.stamina);
+        reader.read(snapshot.remoteCharge);
+        reader.read(snapshot.timeSinceLastDamage);
+        reader.read(snapshot.remoteInInventory);
+        reader.read(snapshot.noteInInventory);
+        reader.read(snapshot.exhausted);
+    }
+}
+
+std::vector<uint8_t> Game::captureCheckpoint() const
+{
+    const POVCamera &cam = player->getCamera();
+
+    Checkpoint::Writer writer;
+    writer.write(cam.position);
+    writer.write(cam.yaw);
+    writer.write(cam.pitch);
+    writer.write(cam.verticalVelocity);
+    writer.write(cam.groundedTimer);
+    writeSnapshot(writer, player->getState().getSnapshot());
+    writer.write(in_bloomy_world);
+    writer.write(underwater);
+    writer.write(bloomyWaterFloor->geometry->getPosition());
+    writer.write(ditherWaterFloor->geometry->getPosition());
+
+    // close-up timers are stored as the time already shown
+    writer.write(remoteCloseUpShown);
+    writer.write(remoteTimerStarted);
+    writer.write(t - remoteDisplayStartTime);
+    writer.write(noteCloseUpShown);
+    writer.write(noteTimerStarted);
+    writer.write(t - noteDisplayStartTime);
+    writer.write(player->isRemoteInScene());
+
+    const std::vector<RenderObject *> &inventory = player->getInventory();
+    writer.write(static_cast<uint32_t>(inventory.size()));
+    for (RenderObject *item : inventory)
+    {
+        auto it = std::find_if(renderObjects.begin(), renderObjects.end(), [item](const auto &obj)
+                               { return obj.get() == item; });
+        writer.write(static_cast<uint32_t>(it - renderObjects.begin()));
+    }
+
+    writer.write(static_cast<uint32_t>(renderObjects.size()));
+    for (const auto &obj : renderObjects)
+    {
+        ObjectRecord record = {};
+        record.rendered = obj->isRendered;
+        record.tags = obj->entity.tags;
+
+        if (physx::PxRigidActor *actor = obj->getRigidActor())
+        {
+            record.inScene = actor->getScene() != nullptr;
+
+            physx::PxShape *shape = nullptr;
+            if (actor->getShapes(&shape, 1) == 1)
+            {
+                physx::PxFilterData filterData = shape->getSimulationFilterData();
+                record.group = filterData.word0;
+                record.mask = filterData.word1;
+            }
+        }
+
+        // static bodies never move, only dynamic ones carry a pose
+        if (obj->dynamicBody)
+        {
+            physx::PxTransform pose = obj->dynamicBody->getGlobalPose();
+            physx::PxVec3 linear = obj->dynamicBody->getLinearVelocity();
+            physx::PxVec3 angular = obj->dynamicBody->getAngularVelocity();
+            const float poseValues[7] = {pose.p.x, pose.p.y, pose.p.z, pose.q.x, pose.q.y, pose.q.z, pose.q.w};
+            std::copy(poseValues, poseValues + 7, record.pose);
+            std::copy(&linear.x, &linear.x + 3, record.linearVelocity);
+            std::copy(&angular.x, &angular.x + 3, record.angularVelocity);
+        }
+        writeRecord(writer, record);
+    }
+
+    return writer.finish();
+}
+
+uint64_t Game::getStateChecksum() const
+{
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (uint8_t byte : captureCheckpoint())
+        hash = (hash ^ byte) * 1099511628211ull;
+    return hash;
+}
+
+bool Game::hasCheckpoint() const
+{
+    return !checkpoint.empty() || std::filesystem::exists(CHECKPOINT_FILE);
+}
+
+bool Game::retryFromCheckpoint()
+{
+    if (checkpoint.empty())
+        Checkpoint::loadFromFile(CHECKPOINT_FILE, checkpoint);
+    if (checkpoint.empty() || !restoreCheckpoint())
+        return false;
+
+    lastTime = float(glfwGetTime());
+    return true;
+}
+
+void Game::saveCheckpoint()
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    checkpoint = captureCheckpoint();
+    Checkpoint::saveToFile(CHECKPOINT_FILE, checkpoint);
+
+    frameStats.checkpointBytes = static_cast<unsigned int>(checkpoint.size());
+    frameStats.checkpointMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    LOG_INFO(Log::GAME, "checkpoint saved, %zu bytes in %.3f ms", checkpoint.size(), frameStats.checkpointMs);
+}
+
+bool Game::restoreCheckpoint()
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // everything is read before anything is applied, a broken blob leaves the game untouched
+    Checkpoint::Reader reader(checkpoint);
+    glm::vec3 position, bloomyWaterPosition, ditherWaterPosition;
+    float yaw, pitch, verticalVelocity, groundedTimer, remoteShownFor, noteShownFor;
+    PlayerState::Snapshot state;
+    bool bloomy, wasUnderwater, remoteShown, remoteStarted, noteShown, noteStarted, remoteInScene;
+    uint32_t inventorySize = 0, objectCount = 0;
+
+    reader.read(position);
+    reader.read(yaw);
+    reader.read(pitch);
+    reader.read(verticalVelocity);
+    reader.read(groundedTimer);
+    readSnapshot(reader, state);
+    reader.read(bloomy);
+    reader.read(wasUnderwater);
+    reader.read(bloomyWaterPosition);
+    reader.read(ditherWaterPosition);
+    reader.read(remoteShown);
+    reader.read(remoteStarted);
+    reader.read(remoteShownFor);
+    reader.read(noteShown);
+    reader.read(noteStarted);
+    reader.read(noteShownFor);
+    reader.read(remoteInScene);
+
+    std::vector<RenderObject *> inventory;
+    reader.read(inventorySize);
+    for (uint32_t i = 0; i < inventorySize && reader.isValid(); ++i)
+    {
+        uint32_t index = 0;
+        if (reader.read(index) && index < renderObjects.size())
+            inventory.push_back(renderObjects[index].get());
+    }
+
+    std::vector<ObjectRecord> records;
+    if (reader.read(objectCount) && objectCount == renderObjects.size())
+    {
+        records.resize(objectCount);
+        for (ObjectRecord &record : records)
+            readRecord(reader, record);
+    }
+
+    if (!reader.isValid() || records.size() != renderObjects.size())
+    {
+        LOG_WARN(Log::GAME, "checkpoint does not fit this scene, nothing restored");
+        checkpoint.clear();
+        return false;
+    }
+
+    POVCamera &cam = player->getCamera();
+    cam.yaw = yaw;
+    cam.pitch = pitch;
+    cam.verticalVelocity = verticalVelocity;
+    cam.groundedTimer = groundedTimer;
+    cam.teleport(position);
+
+    player->getState().restore(state);
+    player->setInventory(std::move(inventory));
+    player->setRemoteInScene(remoteInScene);
+
+    // a transition in flight would flip the world right after the restore
+    transitionActive = false;
+    should_transition = false;
+    in_bloomy_world = bloomy;
+    player->setInBloomyWorld(in_bloomy_world);
+    underwater = wasUnderwater;
+
+    bloomyWaterFloor->setPosition(bloomyWaterPosition);
+    ditherWaterFloor->setPosition(ditherWaterPosition);
+
+    remoteCloseUpShown = remoteShown;
+    remoteTimerStarted = remoteStarted;
+    remoteDisplayStartTime = t - remoteShownFor;
+    noteCloseUpShown = noteShown;
+    noteTimerStarted = noteStarted;
+    noteDisplayStartTime = t - noteShownFor;
+
+    for (size_t i = 0; i < renderObjects.size(); ++i)
+    {
+        RenderObject *obj = renderObjects[i].get();
+        const ObjectRecord &record = records[i];
+        obj->setRendered(record.rendered != 0);
+        obj->setTags(record.tags);
+
+        physx::PxRigidActor *actor = obj->getRigidActor();
+        if (!actor)
+            continue;
+
+        bool inScene = actor->getScene() != nullptr;
+        if (record.inScene && !inScene)
+            physics.gScene->addActor(*actor);
+        else if (!record.inScene && inScene)
+            physics.gScene->removeActor(*actor);
+
+        if (record.group)
+            obj->setCollisionFilter(record.group, record.mask);
+
+        if (obj->dynamicBody)
+        {
+            const float *p = record.pose;
+            obj->dynamicBody->setGlobalPose(physx::PxTransform(physx::PxVec3(p[0], p[1], p[2]), physx::PxQuat(p[3], p[4], p[5], p[6])));
+            if (record.inScene)
+            {
+                const float *v = record.linearVelocity;
+                const float *w = record.angularVelocity;
+                obj->dynamicBody->setLinearVelocity(physx::PxVec3(v[0], v[1], v[2]));
+                obj->dynamicBody->setAngularVelocity(physx::PxVec3(w[0], w[1], w[2]));
+                obj->dynamicBody->wakeUp();
+            }
+            if (obj->isRendered)
+                obj->updateTransform();
+        }
+    }
+
+    EntitySystems::pullTransforms(registry);
+
+    // trigger state is derived, start from scratch so the next update sends fresh enter events
+    nearbyPickups.clear();
+    inPitZone = feetInBloomyWater = headInBloomyWater = feetInDitherWater = false;
+    createTriggers();
+
+    frameStats.checkpointBytes = static_cast<unsigned int>(checkpoint.size());
+    frameStats.checkpointMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    LOG_INFO(Log::GAME, "checkpoint restored, %zu bytes in %.3f ms", checkpoint.size(), frameStats.checkpointMs);
+    return true;
 }
 
 void Game::updatePhysics(float deltaTime)
 {
+    if (!PhysicsTelemetry::isEnabled())
+    {
+        physics.gScene->simulate(deltaTime);
+        physics.gScene->fetchResults(true);
+        PhysicsTelemetry::record(physics.gScene, 0.0f, 0.0f, 0);
+        return;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
     physics.gScene->simulate(deltaTime);
+    auto simulated = std::chrono::high_resolution_clock::now();
     physics.gScene->fetchResults(true);
+    auto fetched = std::chrono::high_resolution_clock::now();
+
+    PhysicsTelemetry::record(physics.gScene, std::chrono::duration<float, std::milli>(simulated - start).count(),
+                             std::chrono::duration<float, std::milli>(fetched - simulated).count(), sceneQueries->getLastBatchSize());
 }
 void Game::processInput(GLFWwindow *window, float deltaTime)
 {
@@ -509,10 +1053,19 @@ void Game::processInput(GLFWwindow *window, float deltaTime)
     static bool nKeyWasDown = false;
     static bool fKeyWasDown = false;
     static bool spaceKeyWasDown = false;
+    static bool f1KeyWasDown = false;
+    static bool f2KeyWasDown = false;
+    static bool f3KeyWasDown = false;
+    static bool f4KeyWasDown = false;
+    static bool f5KeyWasDown = false;
+    static bool f6KeyWasDown = false;
+    static bool f7KeyWasDown = false;
+    static bool f8KeyWasDown = false;
+    static bool f9KeyWasDown = false;
 
     auto isKeyPressedThisFrame = [](int key, GLFWwindow *window, bool &wasDown)
     {
-        bool isDown = glfwGetKey(window, key) == GLFW_PRESS;
+        bool isDown = InputRecorder::getKey(window, key) == GLFW_PRESS;
         bool justPressed = isDown && !wasDown;
         wasDown = isDown;
         return justPressed;
@@ -520,7 +1073,7 @@ void Game::processInput(GLFWwindow *window, float deltaTime)
 
     auto isMousePressedThisFrame = [](int button, GLFWwindow *window, bool &wasDown)
     {
-        bool isDown = glfwGetMouseButton(window, button) == GLFW_PRESS;
+        bool isDown = InputRecorder::getMouseButton(window, button) == GLFW_PRESS;
         bool justPressed = isDown && !wasDown;
         wasDown = isDown;
         return justPressed;
@@ -561,12 +1114,84 @@ void Game::processInput(GLFWwindow *window, float deltaTime)
         useNormalMap = !useNormalMap;
     }
 
+    // Toggle performance overlay
+    if (isKeyPressedThisFrame(GLFW_KEY_F1, window, f1KeyWasDown))
+    {
+        show_debug_overlay = !show_debug_overlay;
+    }
+
+    // Toggle depth pre-pass
+    if (isKeyPressedThisFrame(GLFW_KEY_F2, window, f2KeyWasDown))
+    {
+        basePass->setDepthPrepass(!basePass->isDepthPrepassEnabled());
+    }
+
+    // Cycle anti-aliasing: off -> MSAA -> FXAA
+    if (isKeyPressedThisFrame(GLFW_KEY_F3, window, f3KeyWasDown))
+    {
+        switch (basePass->getAntialiasing())
+        {
+        case BasePass::Antialiasing::OFF:
+            basePass->setAntialiasingMode(BasePass::Antialiasing::MSAA);
+            break;
+        case BasePass::Antialiasing::MSAA:
+            basePass->setAntialiasingMode(BasePass::Antialiasing::FXAA);
+            break;
+        default:
+            basePass->setAntialiasingMode(BasePass::Antialiasing::OFF);
+            break;
+        }
+    }
+
+    // Toggle dynamic resolution
+    if (isKeyPressedThisFrame(GLFW_KEY_F4, window, f4KeyWasDown))
+    {
+        basePass->setDynamicResolution(!basePass->isDynamicResolutionEnabled());
+    }
+
+    // Toggle physics panel
+    if (isKeyPressedThisFrame(GLFW_KEY_F6, window, f6KeyWasDown))
+    {
+        show_physics_panel = !show_physics_panel;
+        PhysicsTelemetry::setEnabled(show_physics_panel);
+    }
+
+    // Dump the physics history
+    if (isKeyPressedThisFrame(GLFW_KEY_F7, window, f7KeyWasDown))
+    {
+        PhysicsTelemetry::dumpCsv("physics_telemetry.csv");
+    }
+
+    // Record physics telemetry until pressed again
+    if (isKeyPressedThisFrame(GLFW_KEY_F8, window, f8KeyWasDown))
+    {
+        if (PhysicsTelemetry::isWritingCsv())
+            PhysicsTelemetry::stopCsv();
+        else
+            PhysicsTelemetry::startCsv("physics_telemetry_log.csv");
+    }
+
+    // Save checkpoint
+    if (isKeyPressedThisFrame(GLFW_KEY_F5, window, f5KeyWasDown))
+    {
+        saveCheckpoint();
+    }
+
+    // Load checkpoint, from the file when none was saved this session
+    if (isKeyPressedThisFrame(GLFW_KEY_F9, window, f9KeyWasDown) && !transitionActive)
+    {
+        if (checkpoint.empty())
+            Checkpoint::loadFromFile(CHECKPOINT_FILE, checkpoint);
+        if (!checkpoint.empty())
+            restoreCheckpoint();
+    }
+
     // Toggle normal map
     if (isKeyPressedThisFrame(GLFW_KEY_ENTER, window, nKeyWasDown))
     {
         if (noteTimerStarted)
         {
-            closeUpNote->isRendered = false;
+            closeUpNote->setRendered(false);
             noteCloseUpShown = true;
             noteTimerStarted = false;
         }
@@ -576,14 +1201,12 @@ void Game::processInput(GLFWwindow *window, float deltaTime)
     if (isKeyPressedThisFrame(GLFW_KEY_E, window, eKeyWasDown))
     {
 
-        // Try nearby pickup first
-        player->tryPickupNearbyObject(remote.get(), physics.gScene, pickUpRemoteSound);
-        player->tryPickupNearbyObject(note.get(), physics.gScene, pickUpRemoteSound);
-        player->tryPickupNearbyObject(player->getRemoteThrowable().get(), physics.gScene, pickUpRemoteSound);
+        // Try nearby pickup first, only objects whose pickup volume the player is in
+        for (RenderObject *pickup : nearbyPickups)
+            player->tryPickupNearbyObject(pickup, physics.gScene, pickUpRemoteSound);
 
         // raycast-based interaction
-        player->pickObject(xpos, ypos, window_width, window_height, physics.gScene);
-        player->showInventory();
+        player->pickObject(*sceneQueries, physics.gScene);
     }
 
     // Throw Remote
@@ -596,7 +1219,7 @@ void Game::processInput(GLFWwindow *window, float deltaTime)
     }
 
     // Handle sprinting
-    if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
+    if (InputRecorder::getKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
     {
         player->spendStamina(deltaTime); // Spend stamina on sprinting
         player->setSprinting(player->canSprint());
@@ -607,22 +1230,22 @@ void Game::processInput(GLFWwindow *window, float deltaTime)
     }
 
     // Handle movement with WASD keys
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS && !transitionActive)
+    if (InputRecorder::getKey(window, GLFW_KEY_W) == GLFW_PRESS && !transitionActive)
     {
         player->handleInput('W', deltaTime);
         isMoving = true;
     }
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS && !transitionActive)
+    if (InputRecorder::getKey(window, GLFW_KEY_S) == GLFW_PRESS && !transitionActive)
     {
         player->handleInput('S', deltaTime);
         isMoving = true;
     }
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS && !transitionActive)
+    if (InputRecorder::getKey(window, GLFW_KEY_A) == GLFW_PRESS && !transitionActive)
     {
         player->handleInput('A', deltaTime);
         isMoving = true;
     }
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS && !transitionActive)
+    if (InputRecorder::getKey(window, GLFW_KEY_D) == GLFW_PRESS && !transitionActive)
     {
         player->handleInput('D', deltaTime);
         isMoving = true;
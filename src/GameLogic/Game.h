@@ -7,10 +7,24 @@
 #include "../Light.h"
 #include "../GLTFLoader.h"
 #include "../Render/RenderPass.h"
+#include "../Render/BasePass.h"
+#include "../Render/ClusteredLighting.h"
+#include "../Render/WaterPass.h"
+#include "../Render/DrawDataBuffer.h"
+#include "../Render/SceneDrawLists.h"
+#include "../Render/OcclusionCuller.h"
+#include "../Render/MaterialTable.h"
+#include "../Render/FrameStats.h"
 #include "../imgui/HeadsUpDisplay.h"
+#include "../imgui/DebugOverlay.h"
+#include "../imgui/PhysicsPanel.h"
 #include "../ObjectPicker.h"
+#include "../SceneQueries.h"
 #include "../Skybox.h"
 #include "GameState.h"
+#include "TriggerSystem.h"
+#include "../Entities/EntityRegistry.h"
+#include "Checkpoint.h"
 #include <SFML/Audio.hpp>
 
 class Game
@@ -21,6 +35,19 @@ public:
     void End();
     void Pause();
     void Shutdown();
+    /*!
+     * Hash of everything a checkpoint holds, equal for runs that ended in the same state
+     */
+    uint64_t getStateChecksum() const;
+    /*!
+     * Whether there is a checkpoint to retry from, saved in this session or left on disk
+     */
+    bool hasCheckpoint() const;
+    /*!
+     * Restores the last checkpoint from the menus, the time spent in the menu is not simulated
+     * @return false when there is none or it does not fit the scene
+     */
+    bool retryFromCheckpoint();
 
 private:
     GLFWwindow *window;
@@ -38,6 +65,8 @@ private:
     bool firstMouse;
     bool useNormalMap = true;
     bool underwater = false;
+    bool show_debug_overlay = false;
+    bool show_physics_panel = false;
 
     float fpsTimer = 0.0f;
     int frameCount = 0;
@@ -61,18 +90,62 @@ private:
     Skybox skybox;
     POVCamera camera;
     Physics physics;
-    std::vector<std::shared_ptr<Shader>> shaders;
+    std::vector<std::shared_ptr<ShaderPermutations>> shaders;
     std::shared_ptr<Shader> transitionShader;
-    std::shared_ptr<Shader> ditherShader;
-    std::unique_ptr<RenderPass> shadowPass, basePass;
+    std::shared_ptr<ShaderPermutations> ditherShader;
+    std::unique_ptr<RenderPass> shadowPass;
+    std::unique_ptr<BasePass> basePass;
+    std::unique_ptr<WaterPass> waterPass;
+    std::unique_ptr<DrawDataBuffer> drawData;
+    std::unique_ptr<SceneDrawLists> drawLists;
+    std::unique_ptr<OcclusionCuller> occlusionCuller;
+    std::unique_ptr<MaterialTable> materialTable;
     DirectionalLight dirL;
     PointLight pointL;
+    std::vector<PointLight> bloomLights, frameLights;
+    std::unique_ptr<ClusteredLighting> clusteredLighting;
     std::unique_ptr<HeadsUpDisplay> hud;
+    DebugOverlay debugOverlay;
+    PhysicsPanel physicsPanel;
+    FrameStats frameStats;
     std::vector<std::shared_ptr<RenderObject>> renderObjects;
+    // components of the render objects, the per-frame systems run on these, see EntitySystems
+    EntityRegistry registry;
 
-    void setPerFrameUniforms(Shader *shader, POVCamera &camera, DirectionalLight &dirL, PointLight &pointL);
+    // what a trigger volume means to the game, see handleTriggerEvents
+    enum TriggerTag
+    {
+        TRIGGER_PICKUP,
+        TRIGGER_PIT,
+        TRIGGER_BLOOMY_WATER_FEET,
+        TRIGGER_BLOOMY_WATER_HEAD,
+        TRIGGER_DITHER_WATER_FEET
+    };
+    std::unique_ptr<TriggerSystem> triggers;
+    std::unique_ptr<SceneQueries> sceneQueries;
+    TriggerSystem::Handle bloomyWaterFeetTrigger, bloomyWaterHeadTrigger, ditherWaterTrigger;
+    // kept up to date by the trigger events
+    std::vector<RenderObject *> nearbyPickups;
+    bool inPitZone = false;
+    bool feetInBloomyWater = false, headInBloomyWater = false, feetInDitherWater = false;
+
+    // last saved checkpoint, F5 saves and F9 restores it
+    std::vector<uint8_t> checkpoint;
+    static constexpr const char *CHECKPOINT_FILE = "checkpoint.dat";
+
+    void setPerFrameUniforms(Shader *shader, POVCamera &camera, DirectionalLight &dirL);
+    void createBloomLights(int count);
+    void updateLights();
     void processInput(GLFWwindow *window, float deltaTime);
     void processMouseInput(double xpos, double ypos);
+    void registerEntities();
+    void createTriggers();
+    void updateTriggers();
+    void handleTriggerEvents();
+    bool isNearby(const RenderObject *object) const;
+    std::vector<uint8_t> captureCheckpoint() const;
+    void saveCheckpoint();
+    bool restoreCheckpoint();
     void updatePhysics(float deltaTime);
     void drawFullScreenQuadWithAlpha(float alpha);
 };
@@ -7,6 +7,8 @@ enum class GameState
     GameOver,
     Quitting,
     Restarting,
+    // the menus ask Main to restore the last checkpoint on the running game
+    RetryingCheckpoint,
     Won
 };
 
@@ -52,10 +52,10 @@ void Player::setRemoteThrowable(std::shared_ptr<RenderObject> throwable)
 {
     remoteThrowable = throwable;
     remoteThrowable->setAsPickable();
-    remoteThrowable->isRendered = false;
-    remoteThrowable->id = "remote";
+    remoteThrowable->setRendered(false);
+    remoteThrowable->setIdentifier("remote");
+    remoteThrowable->addTag(TAG_REMOTE);
     remoteThrowable->setCollisionFilter(WORLD_REMOTE, WORLD_STATIC);
-    remoteThrowable->getRigidActor()->userData = (void *)"Remote";
 
     if (remoteThrowable->dynamicBody)
     {
@@ -65,26 +65,16 @@ void Player::setRemoteThrowable(std::shared_ptr<RenderObject> throwable)
     }
 }
 
-void Player::pickObject(double mouseX, double mouseY, int width, int height, physx::PxScene *scene)
+void Player::pickObject(SceneQueries &queries, physx::PxScene *scene)
 {
+    ObjectPicker::requestPick(camera, queries, [this, scene](RenderObject *obj)
     {
-        RenderObject *obj = ObjectPicker::pickObject(mouseX, mouseY, width, height, camera, scene);
-
-        std::cerr << "[PickObject] hit obj=" << obj;
-
         if (obj)
-        {
-            std::cerr
-                << " isPickable=" << obj->isPickable
-                << " inInventory=" << isInInventory(obj)
-                << "\n";
-        }
+            LOG_DEBUG(Log::GAME, "pick hit %p, pickable %d, in inventory %d", static_cast<void *>(obj), obj->hasTag(TAG_PICKABLE), isInInventory(obj));
         else
-        {
-            std::cerr << " (no object)\n";
-        }
+            LOG_DEBUG(Log::GAME, "pick hit nothing");
 
-        if (obj && obj->isPickable == true && !isInInventory(obj))
+        if (obj && obj->hasTag(TAG_PICKABLE) && !isInInventory(obj))
         {
             if (obj->dynamicBody)
             {
@@ -95,19 +85,20 @@ void Player::pickObject(double mouseX, double mouseY, int width, int height, phy
                 scene->removeActor(*obj->staticBody);
             }
             inventory.push_back(obj);
-            obj->isRendered = false;
-            std::cerr << "Picked up object!" << std::endl;
+            obj->setRendered(false);
+            LOG_INFO(Log::GAME, "picked up object");
         }
         else
         {
-            std::cerr << "No pickable object found!" << std::endl;
+            LOG_DEBUG(Log::GAME, "no pickable object found");
         }
-    }
+        showInventory();
+    });
 }
 
 void Player::tryPickupNearbyObject(RenderObject *obj, physx::PxScene *scene, const sf::SoundBuffer sound)
 {
-    if (!obj || isInInventory(obj) || !obj->isPickable || !obj->isRendered)
+    if (!obj || isInInventory(obj) || !obj->hasTag(TAG_PICKABLE) || !obj->isRendered)
         return;
 
     float distance = glm::distance(getPosition(), obj->geometry->getPosition());
@@ -120,8 +111,8 @@ void Player::tryPickupNearbyObject(RenderObject *obj, physx::PxScene *scene, con
         scene->removeActor(*obj->staticBody);
 
     inventory.push_back(obj);
-    obj->isRendered = false;
-    if (obj->id == "remote")
+    obj->setRendered(false);
+    if (obj->hasTag(TAG_REMOTE))
     {
         buffer = sound;
 
@@ -137,12 +128,12 @@ void Player::tryPickupNearbyObject(RenderObject *obj, physx::PxScene *scene, con
 
         if (obj == remoteThrowable.get())
         {
-            obj->isRendered = false;
+            obj->setRendered(false);
             remoteAlreadyInScene = false;
         }
     }
 
-    if (obj->id == "note")
+    if (obj->hasTag(TAG_NOTE))
     {
         buffer = sound;
 
@@ -158,12 +149,12 @@ void Player::tryPickupNearbyObject(RenderObject *obj, physx::PxScene *scene, con
 
         if (obj == remoteThrowable.get())
         {
-            obj->isRendered = false;
+            obj->setRendered(false);
             remoteAlreadyInScene = false;
         }
     }
 
-    std::cerr << "Picked up nearby object!" << std::endl;
+    LOG_INFO(Log::GAME, "picked up nearby object");
 }
 
 void Player::throwRemote()
@@ -181,7 +172,7 @@ void Player::throwRemote()
     remoteThrowable->setCollisionFilter(WORLD_REMOTE, WORLD_STATIC | activeWorldMask);
     remoteThrowable->dynamicBody->setGlobalPose(PxTransform(PxVec3(throwPos.x, throwPos.y, throwPos.z)));
     remoteThrowable->dynamicBody->setLinearVelocity(PxVec3(throwVel.x, throwVel.y, throwVel.z));
-    remoteThrowable->isRendered = true;
+    remoteThrowable->setRendered(true);
     remoteThrowable->setAsPickable();
 
     auto it = std::find(inventory.begin(), inventory.end(), remoteThrowable.get());
@@ -17,7 +17,10 @@ public:
     void setSprinting(bool sprinting);
     void showInventory() const;
     bool isInInventory(RenderObject *obj) const;
-    void pickObject(double mouseX, double mouseY, int width, int height, physx::PxScene *scene);
+    /*!
+     * Picks up what the player looks at once the scene queries ran
+     */
+    void pickObject(SceneQueries &queries, physx::PxScene *scene);
     void tryPickupNearbyObject(RenderObject *obj, physx::PxScene *scene, const sf::SoundBuffer sound);
     glm::vec3 getPosition() const;
     float getFootPosition() const;
@@ -58,10 +61,16 @@ public:
     void throwRemote();
     void setRemoteThrowable(std::shared_ptr<RenderObject> throwable);
     std::shared_ptr<RenderObject> getRemoteThrowable() { return remoteThrowable; };
-    void setInBloomyWorld(bool inBloomyWorld) { camera.inBloomyWorld = inBloomyWorld; };
+    void setInBloomyWorld(bool inBloomyWorld) { camera.setInBloomyWorld(inBloomyWorld); };
     float getSize();
     void cleanupFinishedSounds();
 
+    // checkpoint access
+    const std::vector<RenderObject *> &getInventory() const { return inventory; }
+    void setInventory(std::vector<RenderObject *> objects) { inventory = std::move(objects); }
+    bool isRemoteInScene() const { return remoteAlreadyInScene; }
+    void setRemoteInScene(bool inScene) { remoteAlreadyInScene = inScene; }
+
 private:
     PlayerState state;
     POVCamera camera;
@@ -90,3 +90,19 @@ bool PlayerState::IsExhausted() const
 {
     return exhausted;
 }
+
+PlayerState::Snapshot PlayerState::getSnapshot() const
+{
+    return {health, stamina, remoteCharge, timeSinceLastDamage, remoteInInventory, noteInInventory, exhausted};
+}
+
+void PlayerState::restore(const Snapshot &snapshot)
+{
+    health = snapshot.health;
+    stamina = snapshot.stamina;
+    remoteCharge = snapshot.remoteCharge;
+    timeSinceLastDamage = snapshot.timeSinceLastDamage;
+    remoteInInventory = snapshot.remoteInInventory;
+    noteInInventory = snapshot.noteInInventory;
+    exhausted = snapshot.exhausted;
+}
@@ -4,6 +4,13 @@
 class PlayerState
 {
 public:
+    // everything that changes while playing, for checkpoints
+    struct Snapshot
+    {
+        float health, stamina, remoteCharge, timeSinceLastDamage;
+        bool remoteInInventory, noteInInventory, exhausted;
+    };
+
     PlayerState(bool &inBloomyWorld);
 
     void Update(float deltaTime);
@@ -30,6 +37,9 @@ public:
     void setRemoteInInventory(bool isRemoteInInventory) { remoteInInventory = isRemoteInInventory; };
     void fullRemoteCharge() { remoteCharge = maxRemoteCharge; };
 
+    Snapshot getSnapshot() const;
+    void restore(const Snapshot &snapshot);
+
 private:
     float timeSinceLastDamage = 0.0f;
     bool remoteInInventory = false;
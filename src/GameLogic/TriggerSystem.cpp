@@ -0,0 +1,187 @@
+#include "TriggerSystem.h"
+#include <algorithm>
+#include <cmath>
+
+TriggerSystem::TriggerSystem(float cellSize) : cellSize(cellSize)
+{
+}
+
+TriggerSystem::Handle TriggerSystem::addSphere(const glm::vec3 &center, float radius, Probe probe, uint32_t worldMask, int tag, void *user)
+{
+    Volume volume;
+    volume.shape = Shape::SPHERE;
+    volume.center = center;
+    volume.radius = radius;
+    volume.min = center - glm::vec3(radius);
+    volume.max = center + glm::vec3(radius);
+    volume.probe = probe;
+    volume.worldMask = worldMask;
+    volume.tag = tag;
+    volume.user = user;
+    return add(volume);
+}
+
+TriggerSystem::Handle TriggerSystem::addCylinder(const glm::vec3 &baseCenter, float radius, float height, Probe probe, uint32_t worldMask, int tag, void *user)
+{
+    Volume volume;
+    volume.shape = Shape::CYLINDER;
+    volume.center = baseCenter;
+    volume.radius = radius;
+    volume.min = baseCenter - glm::vec3(radius, 0.0f, radius);
+    volume.max = baseCenter + glm::vec3(radius, height, radius);
+    volume.probe = probe;
+    volume.worldMask = worldMask;
+    volume.tag = tag;
+    volume.user = user;
+    return add(volume);
+}
+
+TriggerSystem::Handle TriggerSystem::addBox(const glm::vec3 &min, const glm::vec3 &max, Probe probe, uint32_t worldMask, int tag, void *user)
+{
+    Volume volume;
+    volume.shape = Shape::BOX;
+    volume.center = (min + max) * 0.5f;
+    volume.radius = 0.0f;
+    volume.min = min;
+    volume.max = max;
+    volume.probe = probe;
+    volume.worldMask = worldMask;
+    volume.tag = tag;
+    volume.user = user;
+    return add(volume);
+}
+
+TriggerSystem::Handle TriggerSystem::add(Volume volume)
+{
+    Handle handle = static_cast<Handle>(volumes.size());
+    volume.cells = getCells(volume);
+    volumes.push_back(volume);
+    insert(handle);
+    return handle;
+}
+
+void TriggerSystem::setCenter(Handle handle, const glm::vec3 &center)
+{
+    Volume &volume = volumes[handle];
+    glm::vec3 offset = center - volume.center;
+    volume.center = center;
+    volume.min += offset;
+    volume.max += offset;
+    rebin(handle);
+}
+
+void TriggerSystem::setBox(Handle handle, const glm::vec3 &min, const glm::vec3 &max)
+{
+    Volume &volume = volumes[handle];
+    volume.min = min;
+    volume.max = max;
+    volume.center = (min + max) * 0.5f;
+    rebin(handle);
+}
+
+void TriggerSystem::setEnabled(Handle handle, bool enabled)
+{
+    // a disabled volume the player is in reports its exit with the next update
+    volumes[handle].enabled = enabled;
+}
+
+glm::ivec4 TriggerSystem::getCells(const Volume &volume) const
+{
+    return glm::ivec4(static_cast<int>(std::floor(volume.min.x / cellSize)), static_cast<int>(std::floor(volume.min.z / cellSize)),
+                      static_cast<int>(std::floor(volume.max.x / cellSize)), static_cast<int>(std::floor(volume.max.z / cellSize)));
+}
+
+void TriggerSystem::insert(Handle handle)
+{
+    const glm::ivec4 &cells = volumes[handle].cells;
+    for (int x = cells.x; x <= cells.z; x++)
+    {
+        for (int z = cells.y; z <= cells.w; z++)
+            grid[getKey(x, z)].push_back(handle);
+    }
+}
+
+void TriggerSystem::remove(Handle handle)
+{
+    const glm::ivec4 &cells = volumes[handle].cells;
+    for (int x = cells.x; x <= cells.z; x++)
+    {
+        for (int z = cells.y; z <= cells.w; z++)
+        {
+            std::vector<Handle> &cell = grid[getKey(x, z)];
+            cell.erase(std::remove(cell.begin(), cell.end(), handle), cell.end());
+        }
+    }
+}
+
+void TriggerSystem::rebin(Handle handle)
+{
+    glm::ivec4 cells = getCells(volumes[handle]);
+    if (cells == volumes[handle].cells)
+        return;
+    remove(handle);
+    volumes[handle].cells = cells;
+    insert(handle);
+}
+
+bool TriggerSystem::contains(const Volume &volume, const glm::vec3 &point) const
+{
+    switch (volume.shape)
+    {
+    case Shape::SPHERE:
+    {
+        glm::vec3 offset = point - volume.center;
+        return glm::dot(offset, offset) <= volume.radius * volume.radius;
+    }
+    case Shape::CYLINDER:
+    {
+        glm::vec2 offset(point.x - volume.center.x, point.z - volume.center.z);
+        return glm::dot(offset, offset) <= volume.radius * volume.radius && point.y >= volume.min.y && point.y <= volume.max.y;
+    }
+    case Shape::BOX:
+        return glm::all(glm::greaterThanEqual(point, volume.min)) && glm::all(glm::lessThanEqual(point, volume.max));
+    }
+    return false;
+}
+
+void TriggerSystem::update(const glm::vec3 &head, const glm::vec3 &feet, uint32_t worldMask)
+{
+    events.clear();
+    tested = 0;
+    stamp++;
+
+    // a volume the player left may not be in the current cells any more
+    std::vector<Handle> previous = insideVolumes;
+    for (Handle handle : previous)
+        test(handle, head, feet, worldMask);
+
+    for (const glm::vec3 &probe : {head, feet})
+    {
+        auto cell = grid.find(getKey(static_cast<int>(std::floor(probe.x / cellSize)), static_cast<int>(std::floor(probe.z / cellSize))));
+        if (cell == grid.end())
+            continue;
+        for (Handle handle : cell->second)
+            test(handle, head, feet, worldMask);
+    }
+}
+
+void TriggerSystem::test(Handle handle, const glm::vec3 &head, const glm::vec3 &feet, uint32_t worldMask)
+{
+    Volume &volume = volumes[handle];
+    if (volume.stamp == stamp)
+        return;
+    volume.stamp = stamp;
+    tested++;
+
+    bool inside = volume.enabled && (volume.worldMask & worldMask) != 0 &&
+                  contains(volume, volume.probe == Probe::HEAD ? head : feet);
+    if (inside == volume.inside)
+        return;
+
+    volume.inside = inside;
+    if (inside)
+        insideVolumes.push_back(handle);
+    else
+        insideVolumes.erase(std::remove(insideVolumes.begin(), insideVolumes.end(), handle), insideVolumes.end());
+    events.push_back({inside, handle, volume.tag, volume.user});
+}
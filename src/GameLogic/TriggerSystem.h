@@ -0,0 +1,102 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/*!
+ * Interaction volumes around the player. Volumes are binned into a uniform grid over x/z, each
+ * update only tests the volumes in the cells of the player's probes and the ones the player was
+ * inside last frame. Crossing a volume's border emits an enter or exit event; gameplay and the
+ * HUD read the events of the frame instead of measuring distances to every interactable.
+ */
+class TriggerSystem
+{
+public:
+    using Handle = int;
+
+    enum class Shape
+    {
+        SPHERE,
+        CYLINDER, // upright, center is the middle of the base circle at y = min
+        BOX
+    };
+
+    // the point of the player a volume is tested against
+    enum class Probe
+    {
+        HEAD,
+        FEET
+    };
+
+    struct Event
+    {
+        bool entered;
+        Handle volume;
+        int tag;
+        void *user;
+    };
+
+    explicit TriggerSystem(float cellSize = 4.0f);
+
+    /*!
+     * @param worldMask: worlds the volume exists in, the player leaves it when switching to another one
+     * @param tag: free for the caller, handed back with every event
+     */
+    Handle addSphere(const glm::vec3 &center, float radius, Probe probe, uint32_t worldMask, int tag, void *user = nullptr);
+    Handle addCylinder(const glm::vec3 &baseCenter, float radius, float height, Probe probe, uint32_t worldMask, int tag, void *user = nullptr);
+    Handle addBox(const glm::vec3 &min, const glm::vec3 &max, Probe probe, uint32_t worldMask, int tag, void *user = nullptr);
+
+    /*!
+     * Moves a sphere or cylinder, re-binned only when it changes cells
+     */
+    void setCenter(Handle volume, const glm::vec3 &center);
+    void setBox(Handle volume, const glm::vec3 &min, const glm::vec3 &max);
+    void setEnabled(Handle volume, bool enabled);
+
+    /*!
+     * Tests the probes against the nearby volumes and replaces the events of the last update
+     */
+    void update(const glm::vec3 &head, const glm::vec3 &feet, uint32_t worldMask);
+
+    const std::vector<Event> &getEvents() const { return events; }
+    bool isInside(Handle volume) const { return volumes[volume].inside; }
+
+    // volumes tested by the last update
+    unsigned int getTestedCount() const { return tested; }
+
+private:
+    struct Volume
+    {
+        Shape shape;
+        Probe probe;
+        glm::vec3 min, max; // bounds, the box itself for BOX
+        glm::vec3 center;
+        float radius;
+        uint32_t worldMask;
+        int tag;
+        void *user;
+        bool enabled = true;
+        bool inside = false;
+        unsigned int stamp = 0;
+        glm::ivec4 cells; // x0, z0, x1, z1
+    };
+
+    float cellSize;
+    std::vector<Volume> volumes;
+    std::unordered_map<uint64_t, std::vector<Handle>> grid;
+    std::vector<Handle> insideVolumes;
+    std::vector<Event> events;
+    unsigned int stamp = 0, tested = 0;
+
+    Handle add(Volume volume);
+    glm::ivec4 getCells(const Volume &volume) const;
+    // shifted unsigned, cells at negative coordinates would make a signed shift undefined
+    uint64_t getKey(int x, int z) const { return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z); }
+    void insert(Handle handle);
+    void remove(Handle handle);
+    void rebin(Handle handle);
+    bool contains(const Volume &volume, const glm::vec3 &point) const;
+    void test(Handle handle, const glm::vec3 &head, const glm::vec3 &feet, uint32_t worldMask);
+};
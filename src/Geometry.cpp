@@ -5,6 +5,8 @@
  */
 
 #include "Geometry.h"
+#include "Render/DrawDataBuffer.h"
+#include "Log.h"
 #include <glm/glm.hpp>
 
 #undef min
@@ -18,13 +20,11 @@ Geometry::Geometry(glm::mat4 modelMatrix, const GeometryData &data)
 Geometry::Geometry(glm::mat4 modelMatrix, const GeometryData &data, uint32_t worldMask)
     : elements{static_cast<unsigned int>(data.indices.size())}, modelMatrix{modelMatrix}, geometryData{data}, worldMask{worldMask}
 {
-    std::cout << "Creating VAO for Geometry: " << vao << std::endl;
-
     // create VAO
     glGenVertexArrays(1, &vao);
     glBindVertexArray(vao);
 
-    std::cout << "Generated VAO: " << vao << std::endl;
+    LOG_DEBUG(Log::RENDER, "generated VAO %u for %zu vertices", vao, data.positions.size());
 
     // create positions VBO
     glGenBuffers(1, &vboPositions);
@@ -111,36 +111,33 @@ Geometry::~Geometry()
     glDeleteBuffers(1, &vboIndices);
 }
 
-void Geometry::drawInWorld(uint32_t worldFlag, bool underwater)
+Material *Geometry::getMaterialForWorld(uint32_t worldFlag, bool underwater) const
 {
-
     if ((worldMask & worldFlag) == 0)
-        return;
+        return nullptr;
 
-    auto material = (worldFlag == WORLD_BLOOM) && !underwater ? bloomyMaterial : ditherMaterial;
-    if (!material)
-    {
-        std::cerr << "[Geometry] Warning: no material for worldFlag " << worldFlag << "\n";
-        return;
-    }
+    return (worldFlag == WORLD_BLOOM) && !underwater ? bloomyMaterial.get() : ditherMaterial.get();
+}
 
-    Shader *shader = material->getShader();
-    if (!shader)
-    {
-        std::cerr << "[Geometry] Warning: material has no shader\n";
-        return;
-    }
+void Geometry::setDrawData(GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    drawDataBuffer = buffer;
+    drawDataOffset = offset;
+    drawDataSize = size;
+}
+
+void Geometry::drawDepthOnly()
+{
+    glBindBufferRange(GL_UNIFORM_BUFFER, DrawDataBuffer::BINDING, drawDataBuffer, drawDataOffset, drawDataSize);
 
-    shader->use();
-    // std::cout << "Drawing with shader ID: " << material->getShader()->getID() << std::endl;
-    material->setUniforms();
-    this->draw(shader);
+    glBindVertexArray(vao);
+    glDrawElements(GL_TRIANGLES, elements, GL_UNSIGNED_INT, 0);
+    glBindVertexArray(0);
 }
 
 void Geometry::draw(Shader *shader)
 {
-    shader->setUniform("modelMatrix", modelMatrix);
-    shader->setUniform("normalMatrix", glm::mat3(glm::transpose(glm::inverse(modelMatrix))));
+    glBindBufferRange(GL_UNIFORM_BUFFER, DrawDataBuffer::BINDING, drawDataBuffer, drawDataOffset, drawDataSize);
 
     glBindVertexArray(vao);
 
@@ -111,6 +111,13 @@ protected:
    */
   glm::mat4 modelMatrix;
 
+  /*!
+   * This frame's DrawData record, written by the DrawDataBuffer
+   */
+  GLuint drawDataBuffer = 0;
+  GLintptr drawDataOffset = 0;
+  GLsizeiptr drawDataSize = 0;
+
   GLuint ssboNeighbors;
   GLuint ssboNeighborOffsets;
   GLuint ssboGlobalPositions;
@@ -135,7 +142,20 @@ public:
 
   void draw();
 
-  void Geometry::drawInWorld(uint32_t worldFlag, bool underwater);
+  /*!
+   * @return the material used in the given world, nullptr if the object is not drawn there
+   */
+  Material *getMaterialForWorld(uint32_t worldFlag, bool underwater) const;
+
+  /*!
+   * Sets where this frame's per-draw record lives, draws bind it as the DrawData block
+   */
+  void setDrawData(GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+  /*!
+   * Issues a draw call without material state, used by depth-only passes
+   */
+  void drawDepthOnly();
   /*!
    * Draws the object
    * Issues a draw call
@@ -0,0 +1,203 @@
+#include "InputRecorder.h"
+#include "Log.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+InputRecorder::Mode InputRecorder::mode = InputRecorder::Mode::OFF;
+std::string InputRecorder::path;
+std::vector<InputRecorder::Frame> InputRecorder::frames;
+size_t InputRecorder::frame = 0;
+InputRecorder::Frame InputRecorder::current = {};
+std::vector<float> InputRecorder::frameTimes;
+
+bool InputRecorder::init(Mode mode, const std::string &path)
+{
+    InputRecorder::mode = mode;
+    InputRecorder::path = path;
+    frames.clear();
+    frameTimes.clear();
+    frame = 0;
+
+    if (mode == Mode::REPLAY && !readRecording())
+    {
+        LOG_ERROR(Log::GAME, "could not read input recording %s", path.c_str());
+        InputRecorder::mode = Mode::OFF;
+        return false;
+    }
+
+    if (mode == Mode::RECORD)
+        LOG_INFO(Log::GAME, "recording input to %s", path.c_str());
+    else if (mode == Mode::REPLAY)
+        LOG_INFO(Log::GAME, "replaying %zu frames of input from %s", frames.size(), path.c_str());
+    return true;
+}
+
+float InputRecorder::beginFrame(GLFWwindow *window, float deltaTime)
+{
+    if (mode == Mode::OFF)
+        return deltaTime;
+
+    frameTimes.push_back(deltaTime);
+
+    if (mode == Mode::REPLAY)
+    {
+        // an exhausted replay holds the last input still until Main notices and finishes
+        current = frame < frames.size() ? frames[frame] : Frame{0, 0, 0.0f, current.cursorX, current.cursorY};
+        frame++;
+        return current.deltaTime;
+    }
+
+    current = {};
+    for (size_t i = 0; i < std::size(KEYS); ++i)
+    {
+        if (glfwGetKey(window, KEYS[i]) == GLFW_PRESS)
+            current.keys |= 1u << i;
+    }
+    for (int button = 0; button < MOUSE_BUTTONS; ++button)
+    {
+        if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_1 + button) == GLFW_PRESS)
+            current.buttons |= 1u << button;
+    }
+    glfwGetCursorPos(window, &current.cursorX, &current.cursorY);
+    current.deltaTime = deltaTime;
+    frames.push_back(current);
+    return deltaTime;
+}
+
+int InputRecorder::getKey(GLFWwindow *window, int key)
+{
+    int index = keyIndex(key);
+    if (mode == Mode::OFF || (mode == Mode::RECORD && index < 0))
+        return glfwGetKey(window, key);
+    if (index < 0)
+        return GLFW_RELEASE;
+    return (current.keys >> index) & 1u ? GLFW_PRESS : GLFW_RELEASE;
+}
+
+int InputRecorder::getMouseButton(GLFWwindow *window, int button)
+{
+    if (mode == Mode::OFF)
+        return glfwGetMouseButton(window, button);
+    if (button < GLFW_MOUSE_BUTTON_1 || button >= GLFW_MOUSE_BUTTON_1 + MOUSE_BUTTONS)
+        return GLFW_RELEASE;
+    return (current.buttons >> (button - GLFW_MOUSE_BUTTON_1)) & 1u ? GLFW_PRESS : GLFW_RELEASE;
+}
+
+void InputRecorder::getCursorPos(GLFWwindow *window, double *x, double *y)
+{
+    if (mode == Mode::OFF)
+    {
+        glfwGetCursorPos(window, x, y);
+        return;
+    }
+    *x = current.cursorX;
+    *y = current.cursorY;
+}
+
+void InputRecorder::finish(uint64_t stateChecksum)
+{
+    if (mode == Mode::OFF)
+        return;
+
+    if (mode == Mode::RECORD && !writeRecording())
+        LOG_ERROR(Log::GAME, "could not write input recording %s", path.c_str());
+    writeReport(stateChecksum);
+    mode = Mode::OFF;
+}
+
+int InputRecorder::keyIndex(int key)
+{
+    const int *found = std::find(std::begin(KEYS), std::end(KEYS), key);
+    return found == std::end(KEYS) ? -1 : static_cast<int>(found - std::begin(KEYS));
+}
+
+bool InputRecorder::writeRecording()
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    auto put = [&file](const auto &value)
+    { file.write(reinterpret_cast<const char *>(&value), sizeof(value)); };
+
+    put(MAGIC);
+    put(VERSION);
+    put(static_cast<uint32_t>(frames.size()));
+    // field by field, the struct's padding would take a quarter of the file
+    for (const Frame &f : frames)
+    {
+        put(f.keys);
+        put(f.buttons);
+        put(f.deltaTime);
+        put(f.cursorX);
+        put(f.cursorY);
+    }
+    return static_cast<bool>(file);
+}
+
+bool InputRecorder::readRecording()
+{
+    std::ifstream file(path, std::ios::binary);
+    auto get = [&file](auto &value)
+    { return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(value))); };
+
+    uint32_t magic = 0, version = 0, count = 0;
+    if (!get(magic) || !get(version) || !get(count) || magic != MAGIC)
+        return false;
+    if (version != VERSION)
+    {
+        LOG_ERROR(Log::GAME, "input recording version %u does not match version %u", version, VERSION);
+        return false;
+    }
+
+    frames.resize(count);
+    for (Frame &f : frames)
+    {
+        if (!get(f.keys) || !get(f.buttons) || !get(f.deltaTime) || !get(f.cursorX) || !get(f.cursorY))
+            return false;
+    }
+    return true;
+}
+
+void InputRecorder::writeReport(uint64_t stateChecksum)
+{
+    std::vector<float> sorted = frameTimes;
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](float p)
+    { return sorted.empty() ? 0.0f : sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))] * 1000.0f; };
+
+    float wallTime = 0.0f, gameTime = 0.0f;
+    for (float frameTime : frameTimes)
+        wallTime += frameTime;
+    for (size_t i = 0; i < std::min(frame, frames.size()); ++i)
+        gameTime += frames[i].deltaTime;
+    if (mode == Mode::RECORD)
+        gameTime = wallTime;
+
+    std::string reportPath = path + ".report.txt";
+    std::ofstream report(reportPath, std::ios::trunc);
+    char line[128];
+    auto print = [&report, &line]()
+    { report << line << '\n'; };
+
+    std::snprintf(line, sizeof(line), "mode        %s", mode == Mode::RECORD ? "record" : "replay");
+    print();
+    std::snprintf(line, sizeof(line), "frames      %zu", frameTimes.size());
+    print();
+    std::snprintf(line, sizeof(line), "game time   %.3f s", gameTime);
+    print();
+    std::snprintf(line, sizeof(line), "wall time   %.3f s", wallTime);
+    print();
+    std::snprintf(line, sizeof(line), "frame ms    avg %.3f, min %.3f, max %.3f",
+                  frameTimes.empty() ? 0.0f : wallTime * 1000.0f / frameTimes.size(), percentile(0.0f), percentile(1.0f));
+    print();
+    std::snprintf(line, sizeof(line), "percentile  50%% %.3f, 95%% %.3f, 99%% %.3f", percentile(0.5f), percentile(0.95f), percentile(0.99f));
+    print();
+    std::snprintf(line, sizeof(line), "checksum    %016" PRIx64, stateChecksum);
+    print();
+
+    if (!report)
+        LOG_ERROR(Log::GAME, "could not write %s", reportPath.c_str());
+    LOG_INFO(Log::GAME, "%s finished after %zu frames, state checksum %016" PRIx64 ", report in %s",
+             mode == Mode::RECORD ? "recording" : "replay", frameTimes.size(), stateChecksum, reportPath.c_str());
+}
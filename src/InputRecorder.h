@@ -0,0 +1,94 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*!
+ * Records the gameplay input of every frame to a file and plays it back, for benchmark runs that
+ * behave exactly like real play. A frame stores the state of the keys in KEYS, the mouse buttons,
+ * the cursor position and the frame delta. Game reads its input through getKey, getMouseButton
+ * and getCursorPos, which return the captured state while recording and the file's state while
+ * replaying, and advances its clock by the delta beginFrame returns, so the replay steps the
+ * simulation with the recorded deltas no matter how fast it runs.
+ * finish writes a report next to the file with the real frame times and a checksum of the final
+ * game state, equal checksums mean the replay ended where the recording did.
+ *
+ *   doppel --record run.input
+ *   doppel --replay run.input
+ */
+class InputRecorder
+{
+public:
+    enum class Mode
+    {
+        OFF,
+        RECORD,
+        REPLAY
+    };
+
+    /*!
+     * @return false when the replay file can not be read, the recorder then stays off
+     */
+    static bool init(Mode mode, const std::string &path);
+
+    static Mode getMode() { return mode; }
+    static bool isActive() { return mode != Mode::OFF; }
+    /*!
+     * The replay used up its last frame
+     */
+    static bool isReplayFinished() { return mode == Mode::REPLAY && frame >= frames.size(); }
+
+    /*!
+     * Captures or loads the input of the coming game frame
+     * @param deltaTime: wall clock time since the last frame
+     * @return the time step the game should take
+     */
+    static float beginFrame(GLFWwindow *window, float deltaTime);
+
+    // GLFW_PRESS or GLFW_RELEASE, like the glfw functions they stand in for
+    static int getKey(GLFWwindow *window, int key);
+    static int getMouseButton(GLFWwindow *window, int button);
+    static void getCursorPos(GLFWwindow *window, double *x, double *y);
+
+    /*!
+     * Writes the recording and the report, then turns the recorder off
+     * @param stateChecksum: see Game::getStateChecksum
+     */
+    static void finish(uint64_t stateChecksum);
+
+private:
+    static constexpr uint32_t MAGIC = 0x4e495044; // "DPIN"
+    static constexpr uint32_t VERSION = 1;
+
+    // escape is left out on purpose, pausing during a recording must not pause the replay
+    static constexpr int KEYS[] = {
+        GLFW_KEY_W, GLFW_KEY_A, GLFW_KEY_S, GLFW_KEY_D, GLFW_KEY_SPACE, GLFW_KEY_LEFT_SHIFT,
+        GLFW_KEY_E, GLFW_KEY_F, GLFW_KEY_Q, GLFW_KEY_N, GLFW_KEY_ENTER,
+        GLFW_KEY_F1, GLFW_KEY_F2, GLFW_KEY_F3, GLFW_KEY_F4, GLFW_KEY_F5, GLFW_KEY_F6, GLFW_KEY_F7,
+        GLFW_KEY_F8, GLFW_KEY_F9};
+    static_assert(sizeof(KEYS) / sizeof(KEYS[0]) <= 32, "recorded keys are stored in a 32 bit mask");
+    static constexpr int MOUSE_BUTTONS = 3;
+
+    struct Frame
+    {
+        uint32_t keys;
+        uint8_t buttons;
+        float deltaTime;
+        double cursorX, cursorY;
+    };
+
+    static Mode mode;
+    static std::string path;
+    static std::vector<Frame> frames;
+    static size_t frame;
+    static Frame current;
+    static std::vector<float> frameTimes;
+
+    static int keyIndex(int key);
+    static bool writeRecording();
+    static bool readRecording();
+    static void writeReport(uint64_t stateChecksum);
+};
@@ -7,6 +7,8 @@
 
 
 #include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
 
 /*!
  * Directional light, a light that gets emitted in a specific direction
@@ -87,5 +89,21 @@ struct PointLight {
      * The light's attenuation (x = constant, y = linear, z = quadratic)
      */
     glm::vec3 attenuation;
+
+    /*!
+     * Distance at which the attenuated light drops below the given intensity,
+     * beyond it the light is cut off and not assigned to any cluster
+     * @param threshold: the smallest intensity that still counts as lit
+     */
+    float getRange(float threshold = 0.01f) const {
+        float intensity = std::max(color.r, std::max(color.g, color.b));
+        // solve quadratic * d^2 + linear * d + constant = intensity / threshold
+        float c = attenuation.x - intensity / threshold;
+        if (attenuation.z > 0.0f)
+            return std::max((-attenuation.y + std::sqrt(attenuation.y * attenuation.y - 4.0f * attenuation.z * c)) / (2.0f * attenuation.z), 0.0f);
+        if (attenuation.y > 0.0f)
+            return std::max(-c / attenuation.y, 0.0f);
+        return 100.0f;
+    }
 };
 
@@ -0,0 +1,303 @@
+#include "Log.h"
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+struct Record
+{
+    Clock::time_point time;
+    Log::Level level;
+    uint32_t category;
+    uint32_t suppressed;
+    const char *file;
+    int line;
+    char text[200];
+};
+
+// single producer (the owning thread), single consumer (the sink)
+struct ThreadRing
+{
+    static constexpr size_t CAPACITY = 1024;
+    std::array<Record, CAPACITY> records;
+    std::atomic<size_t> head{0}; // next slot the owner writes
+    std::atomic<size_t> tail{0}; // next slot the sink reads
+    unsigned int thread;
+};
+
+std::mutex ringsMutex;
+std::vector<std::unique_ptr<ThreadRing>> rings;
+
+std::thread sink;
+std::mutex sinkMutex;
+std::condition_variable sinkWake;
+std::atomic<bool> running{false};
+// producers between their running check and the end of their push, shutdown waits for them
+std::atomic<int> writers{0};
+bool stopping = false;
+bool console = true;
+std::ofstream file;
+Clock::time_point startTime = Clock::now();
+
+ThreadRing &getRing()
+{
+    // rings outlive their threads, the sink may still be draining one
+    thread_local ThreadRing *ring = nullptr;
+    if (!ring)
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        rings.push_back(std::make_unique<ThreadRing>());
+        ring = rings.back().get();
+        ring->thread = static_cast<unsigned int>(rings.size() - 1);
+    }
+    return *ring;
+}
+
+const char *getLevelName(Log::Level level)
+{
+    switch (level)
+    {
+    case Log::Level::TRACE:
+        return "trace";
+    case Log::Level::DEBUG:
+        return "debug";
+    case Log::Level::INFO:
+        return "info";
+    case Log::Level::WARN:
+        return "warn";
+    case Log::Level::ERR:
+        return "error";
+    default:
+        return "";
+    }
+}
+
+const char *getCategoryName(uint32_t category)
+{
+    switch (category)
+    {
+    case Log::RENDER:
+        return "render";
+    case Log::PHYSICS:
+        return "physics";
+    case Log::GAME:
+        return "game";
+    case Log::ASSETS:
+        return "assets";
+    default:
+        return "general";
+    }
+}
+
+void output(const Record &record, unsigned int thread)
+{
+    const char *fileName = std::max(std::strrchr(record.file, '/'), std::strrchr(record.file, '\\'));
+    fileName = fileName ? fileName + 1 : record.file;
+
+    char line[320];
+    int length = std::snprintf(line, sizeof(line), "%9.3f [%s] %s (%s:%d, thread %u): %s",
+                               std::chrono::duration<double>(record.time - startTime).count(), getLevelName(record.level),
+                               getCategoryName(record.category), fileName, record.line, thread, record.text);
+    if (record.suppressed > 0 && length > 0 && length < static_cast<int>(sizeof(line)))
+        std::snprintf(line + length, sizeof(line) - length, " (%u similar suppressed)", record.suppressed);
+
+    if (console)
+        (record.level >= Log::Level::WARN ? std::cerr : std::cout) << line << '\n';
+    if (file.is_open())
+        file << line << '\n';
+}
+
+void drain()
+{
+    std::vector<ThreadRing *> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        for (const auto &ring : rings)
+            snapshot.push_back(ring.get());
+    }
+
+    for (ThreadRing *ring : snapshot)
+    {
+        size_t tail = ring->tail.load(std::memory_order_relaxed);
+        size_t head = ring->head.load(std::memory_order_acquire);
+        for (; tail != head; tail++)
+            output(ring->records[tail % ThreadRing::CAPACITY], ring->thread);
+        ring->tail.store(tail, std::memory_order_release);
+    }
+}
+
+void runSink()
+{
+    std::unique_lock<std::mutex> lock(sinkMutex);
+    while (!stopping)
+    {
+        // writers never signal, a short poll keeps them free of syscalls
+        sinkWake.wait_for(lock, std::chrono::milliseconds(10));
+        lock.unlock();
+        drain();
+        std::cout.flush();
+        if (file.is_open())
+            file.flush();
+        lock.lock();
+    }
+}
+} // namespace
+
+std::atomic<Log::Level> Log::runtimeLevel{Log::Level::INFO};
+std::atomic<uint32_t> Log::runtimeCategories{Log::ALL_CATEGORIES};
+std::atomic<unsigned int> Log::ratePerSecond{20};
+std::atomic<uint64_t> Log::dropped{0};
+
+void Log::init(Level level, uint32_t categories, bool toConsole, const std::string &filePath, unsigned int rate)
+{
+    shutdown();
+
+    runtimeLevel = level;
+    runtimeCategories = categories;
+    ratePerSecond = rate;
+    console = toConsole;
+    if (!filePath.empty())
+    {
+        file.open(filePath, std::ios::out | std::ios::trunc);
+        if (!file)
+            std::cerr << "Could not open log file " << filePath << std::endl;
+    }
+
+    stopping = false;
+    running = true;
+    sink = std::thread(runSink);
+}
+
+void Log::shutdown()
+{
+    if (!running)
+        return;
+
+    // new messages print directly from here on, the ones already on their way into a ring
+    // land before the sink's last drain
+    running.store(false);
+    while (writers.load() > 0)
+        std::this_thread::yield();
+
+    {
+        std::lock_guard<std::mutex> lock(sinkMutex);
+        stopping = true;
+    }
+    sinkWake.notify_one();
+    sink.join();
+
+    drain();
+    if (dropped > 0)
+        std::cerr << "Log: " << dropped << " messages dropped, the rings were full" << std::endl;
+    std::cout.flush();
+    if (file.is_open())
+        file.close();
+}
+
+Log::Level Log::parseLevel(const std::string &name)
+{
+    if (name == "trace")
+        return Level::TRACE;
+    if (name == "debug")
+        return Level::DEBUG;
+    if (name == "warn")
+        return Level::WARN;
+    if (name == "error")
+        return Level::ERR;
+    if (name == "off")
+        return Level::OFF;
+    return Level::INFO;
+}
+
+uint32_t Log::parseCategories(const std::string &names)
+{
+    uint32_t categories = 0;
+    std::stringstream stream(names);
+    std::string name;
+    while (std::getline(stream, name, ','))
+    {
+        name.erase(std::remove(name.begin(), name.end(), ' '), name.end());
+        if (name == "all")
+            categories |= ALL_CATEGORIES;
+        else if (name == "general")
+            categories |= GENERAL;
+        else if (name == "render")
+            categories |= RENDER;
+        else if (name == "physics")
+            categories |= PHYSICS;
+        else if (name == "game")
+            categories |= GAME;
+        else if (name == "assets")
+            categories |= ASSETS;
+        else
+            std::cerr << "Unknown log category " << name << std::endl;
+    }
+    return categories;
+}
+
+bool Log::allow(Site &site)
+{
+    unsigned int rate = ratePerSecond.load(std::memory_order_relaxed);
+    if (rate == 0)
+        return true;
+
+    // fixed one second windows, racing threads may let a message or two more through
+    int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now().time_since_epoch()).count();
+    int64_t windowStart = site.windowStart.load(std::memory_order_relaxed);
+    if (now - windowStart >= 1000 && site.windowStart.compare_exchange_strong(windowStart, now, std::memory_order_relaxed))
+        site.count.store(0, std::memory_order_relaxed);
+
+    if (site.count.fetch_add(1, std::memory_order_relaxed) < rate)
+        return true;
+    site.suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void Log::write(Level level, uint32_t category, const char *file, int line, uint32_t suppressed, const char *format, ...)
+{
+    Record record;
+    record.time = Clock::now();
+    record.level = level;
+    record.category = category;
+    record.suppressed = suppressed;
+    record.file = file;
+    record.line = line;
+
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(record.text, sizeof(record.text), format, args);
+    va_end(args);
+
+    ThreadRing &ring = getRing();
+    writers.fetch_add(1);
+    if (!running.load())
+    {
+        writers.fetch_sub(1);
+        // before init and after shutdown there is no sink, print right away
+        output(record, ring.thread);
+        return;
+    }
+
+    size_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= ThreadRing::CAPACITY)
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    else
+    {
+        ring.records[head % ThreadRing::CAPACITY] = record;
+        ring.head.store(head + 1, std::memory_order_release);
+    }
+    writers.fetch_sub(1);
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/*!
+ * Asynchronous logging. A call formats its message into a fixed size record in a ring buffer of
+ * the calling thread, a background thread drains all rings into the console and/or a log file.
+ * Writers never lock or touch the console, a full ring drops the message and counts it.
+ * Levels and categories below LOG_MIN_LEVEL or outside LOG_CATEGORIES are compiled out entirely,
+ * their arguments are not even evaluated. Every call site allows a limited number of messages
+ * per second and reports how many it suppressed with its next message.
+ *
+ *   LOG_WARN(Log::PHYSICS, "lost %u contacts", count);
+ */
+class Log
+{
+public:
+    // ERROR is a windows.h macro
+    enum class Level
+    {
+        TRACE,
+        DEBUG,
+        INFO,
+        WARN,
+        ERR,
+        OFF
+    };
+
+    enum Category : uint32_t
+    {
+        GENERAL = 1 << 0,
+        RENDER = 1 << 1,
+        PHYSICS = 1 << 2,
+        GAME = 1 << 3,
+        ASSETS = 1 << 4,
+        ALL_CATEGORIES = 0xffffffffu
+    };
+
+    // per call site state of the rate limit
+    struct Site
+    {
+        std::atomic<int64_t> windowStart{0};
+        std::atomic<uint32_t> count{0};
+        std::atomic<uint32_t> suppressed{0};
+    };
+
+    /*!
+     * Starts the background sink, messages written before are printed synchronously
+     * @param filePath: log file, empty for none
+     * @param ratePerSecond: messages each call site may log per second, 0 for no limit
+     */
+    static void init(Level level, uint32_t categories, bool console, const std::string &filePath, unsigned int ratePerSecond);
+
+    /*!
+     * Drains everything that is left and stops the sink
+     */
+    static void shutdown();
+
+    /*!
+     * "trace", "debug", "info", "warn", "error" or "off", anything else is info
+     */
+    static Level parseLevel(const std::string &name);
+    /*!
+     * Comma separated category names or "all"
+     */
+    static uint32_t parseCategories(const std::string &names);
+
+    static constexpr bool isCompiledIn(Level level, uint32_t category);
+    static bool isEnabled(Level level, uint32_t category)
+    {
+        return level >= runtimeLevel.load(std::memory_order_relaxed) && (category & runtimeCategories.load(std::memory_order_relaxed)) != 0;
+    }
+
+    static bool allow(Site &site);
+    static void write(Level level, uint32_t category, const char *file, int line, uint32_t suppressed, const char *format, ...);
+
+    static uint64_t getDroppedCount() { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    static std::atomic<Level> runtimeLevel;
+    static std::atomic<uint32_t> runtimeCategories;
+    static std::atomic<unsigned int> ratePerSecond;
+    static std::atomic<uint64_t> dropped;
+};
+
+#ifndef LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define LOG_MIN_LEVEL Log::Level::INFO
+#else
+#define LOG_MIN_LEVEL Log::Level::TRACE
+#endif
+#endif
+
+#ifndef LOG_CATEGORIES
+#define LOG_CATEGORIES Log::ALL_CATEGORIES
+#endif
+
+constexpr bool Log::isCompiledIn(Level level, uint32_t category)
+{
+    return level >= LOG_MIN_LEVEL && (category & static_cast<uint32_t>(LOG_CATEGORIES)) != 0;
+}
+
+#define LOG_AT(level, category, ...)                                                                         \
+    do                                                                                                       \
+    {                                                                                                        \
+        if constexpr (Log::isCompiledIn(level, category))                                                    \
+        {                                                                                                    \
+            static Log::Site logSite;                                                                        \
+            if (Log::isEnabled(level, category) && Log::allow(logSite))                                      \
+                Log::write(level, category, __FILE__, __LINE__, logSite.suppressed.exchange(0), __VA_ARGS__); \
+        }                                                                                                    \
+    } while (0)
+
+#define LOG_TRACE(category, ...) LOG_AT(Log::Level::TRACE, category, __VA_ARGS__)
+#define LOG_DEBUG(category, ...) LOG_AT(Log::Level::DEBUG, category, __VA_ARGS__)
+#define LOG_INFO(category, ...) LOG_AT(Log::Level::INFO, category, __VA_ARGS__)
+#define LOG_WARN(category, ...) LOG_AT(Log::Level::WARN, category, __VA_ARGS__)
+#define LOG_ERROR(category, ...) LOG_AT(Log::Level::ERR, category, __VA_ARGS__)
@@ -12,6 +12,12 @@
 #include "imgui.h"
 #include "GameLogic/Game.h"
 #include "GameLogic/GameState.h"
+#include "ProgramCache.h"
+#include "ShaderBuildQueue.h"
+#include "FramePacer.h"
+#include "Log.h"
+#include "InputRecorder.h"
+#include "Entities/EntityBenchmark.h"
 
 using namespace physx;
 #undef min
@@ -29,6 +35,7 @@ void GLAPIENTRY DebugCallbackDefault(GLenum source,
                                      const GLchar *message,
                                      const void *userParam);
 static std::string FormatDebugOutput(GLenum source, GLenum type, GLuint id, GLenum severity, const char *msg);
+static std::unique_ptr<Game> CreateGame(GLFWwindow *window);
 
 /* --------------------------------------------- */
 // Global variables
@@ -44,6 +51,24 @@ int main(int argc, char **argv)
 {
     std::cout << ":::::: Running Doppel... ::::::" << std::endl;
 
+    INIReader logging_reader("assets/settings/logging.ini");
+    Log::init(Log::parseLevel(logging_reader.Get("logging", "level", "info")),
+              Log::parseCategories(logging_reader.Get("logging", "categories", "all")),
+              logging_reader.GetBoolean("logging", "console", true),
+              logging_reader.Get("logging", "file", ""),
+              static_cast<unsigned int>(std::max(0L, logging_reader.GetInteger("logging", "rate_limit", 20))));
+
+    // --entity-benchmark [entities] only measures the entity systems, see EntityBenchmark
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::string(argv[i]) == "--entity-benchmark")
+        {
+            EntityBenchmark::run(i + 1 < argc ? std::max(1, std::atoi(argv[i + 1])) : 10000);
+            Log::shutdown();
+            return EXIT_SUCCESS;
+        }
+    }
+
     /* --------------------------------------------- */
     // Load settings.ini
     /* --------------------------------------------- */
@@ -103,8 +128,9 @@ int main(int argc, char **argv)
     glfwWindowHint(GLFW_REFRESH_RATE, refresh_rate);               // Set refresh rate
     glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
 
-    // Enable antialiasing (4xMSAA)
-    glfwWindowHint(GLFW_SAMPLES, 4);
+    // The scene is anti-aliased in its own render targets (see [renderer] antialiasing),
+    // the default framebuffer only receives the final image
+    glfwWindowHint(GLFW_SAMPLES, 0);
 
     // Open window
     GLFWmonitor *monitor = nullptr;
@@ -159,6 +185,30 @@ int main(int argc, char **argv)
     const char *version = (const char *)glGetString(GL_VERSION);
     std::cout << "OpenGL Version: " << version << std::endl;
 
+    INIReader graphics_reader("assets/settings/graphics.ini");
+    ProgramCache::init(
+        graphics_reader.Get("renderer", "program_cache_dir", "shader_cache"),
+        graphics_reader.GetBoolean("renderer", "program_cache", true));
+    ShaderBuildQueue::init();
+    FramePacer::init(window,
+                     FramePacer::parseVSync(graphics_reader.Get("frame_pacing", "vsync", "on")),
+                     static_cast<int>(graphics_reader.GetInteger("frame_pacing", "fps_limit", 0)),
+                     graphics_reader.GetBoolean("frame_pacing", "low_latency", true),
+                     static_cast<int>(graphics_reader.GetInteger("frame_pacing", "max_queued_frames", 1)));
+
+    // --record <file> captures the input of the run, --replay <file> plays it back, see InputRecorder
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--record" || arg == "--replay")
+        {
+            InputRecorder::Mode mode = arg == "--record" ? InputRecorder::Mode::RECORD : InputRecorder::Mode::REPLAY;
+            // both runs skip the menu so they start from the same state
+            if (InputRecorder::init(mode, argv[++i]))
+                g_GameState = GameState::Playing;
+        }
+    }
+
     /* --------------------------------------------- */
     // Initialize scene and render loop
     /* --------------------------------------------- */
@@ -166,10 +216,15 @@ int main(int argc, char **argv)
         GUIManager guiManager;
         guiManager.Init(window);
         Menu menu(window_width, window_height);
-        std::unique_ptr<Game> game = std::make_unique<Game>(window);
+        std::unique_ptr<Game> game = CreateGame(window);
 
         while (!glfwWindowShouldClose(window))
         {
+            // input is polled after the limiter's wait, as close to the simulation as possible
+            FramePacer::waitForNextFrame();
+            glfwPollEvents();
+            FramePacer::markInputSampled();
+
             guiManager.BeginFrame();
 
             switch (g_GameState)
@@ -179,6 +234,7 @@ int main(int argc, char **argv)
             case GameState::Won:
             case GameState::GameOver:
                 glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+                menu.canRetryCheckpoint = game->hasCheckpoint();
                 menu.Render();
                 break;
             case GameState::Quitting:
@@ -192,9 +248,13 @@ int main(int argc, char **argv)
                 g_GameState = GameState::Playing;
 
                 std::cerr << ">>> GAME CONSTRUCTOR START\n";
-                game = std::make_unique<Game>(window);
+                game = CreateGame(window);
                 std::cerr << ">>> GAME CONSTRUCTOR DONE\n";
                 break;
+            case GameState::RetryingCheckpoint:
+                // a checkpoint that does not fit the scene falls back to a new game
+                g_GameState = game->retryFromCheckpoint() ? GameState::Playing : GameState::Restarting;
+                break;
             case GameState::Playing:
                 game->Run();
                 break;
@@ -204,8 +264,21 @@ int main(int argc, char **argv)
 
             guiManager.EndFrame();
             glfwSwapBuffers(window);
-            glfwPollEvents();
+            FramePacer::endFrame();
+
+            // a recorded or replayed run ends with the input or the game
+            if (InputRecorder::isActive() &&
+                (InputRecorder::isReplayFinished() || g_GameState == GameState::GameOver || g_GameState == GameState::Won))
+            {
+                InputRecorder::finish(game->getStateChecksum());
+                glfwSetWindowShouldClose(window, true);
+            }
         }
+
+        if (InputRecorder::isActive())
+            InputRecorder::finish(game->getStateChecksum());
+
+        FramePacer::shutdown();
     }
 
     /* --------------------------------------------- */
@@ -219,10 +292,23 @@ int main(int argc, char **argv)
     /* --------------------------------------------- */
 
     glfwTerminate();
+    Log::shutdown();
 
     return EXIT_SUCCESS;
 }
 
+static std::unique_ptr<Game> CreateGame(GLFWwindow *window)
+{
+    ProgramCache::resetStats();
+    // the Game finishes the queue once its assets are loaded, before the first shader is used
+    ShaderBuildQueue::begin();
+    std::unique_ptr<Game> game = std::make_unique<Game>(window);
+    std::cout << "Shader programs:  " << ProgramCache::getHits() << " from cache, "
+              << ProgramCache::getMisses() << " compiled, "
+              << ProgramCache::getBuildTime() << " ms" << std::endl;
+    return game;
+}
+
 void GLAPIENTRY DebugCallbackDefault(GLenum source,
                                      GLenum type,
                                      GLuint id,
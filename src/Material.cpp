@@ -9,36 +9,33 @@
 // Base material
 /* --------------------------------------------- */
 
-Material::Material(std::shared_ptr<Shader> shader, glm::vec3 color, glm::vec3 materialCoefficients, float alpha)
+Material::Material(std::shared_ptr<ShaderPermutations> shader, glm::vec3 color, glm::vec3 materialCoefficients, float alpha)
     : _shader(shader)
     , _color(color)
     , _materialCoefficients(materialCoefficients)
     , _alpha(alpha) {}
 
-Material::Material(std::shared_ptr<Shader> shader, glm::vec3 materialCoefficients, float alpha)
+Material::Material(std::shared_ptr<ShaderPermutations> shader, glm::vec3 materialCoefficients, float alpha)
     : _shader(shader)
+    , _color(1.0f)
     , _materialCoefficients(materialCoefficients)
     , _alpha(alpha) {}
 
 Material::~Material() {}
 
-Shader* Material::getShader() { return _shader.get(); }
+Shader* Material::getShader() { return _shader->getActive(); }
 
-void Material::setUniforms() {
-    _shader->setUniform("materialColor", _color);
-    _shader->setUniform("materialCoefficients", _materialCoefficients);
-    _shader->setUniform("specularAlpha", _alpha);
-}
+void Material::setUniforms() {}
 
 /* --------------------------------------------- */
 // Texture material
 /* --------------------------------------------- */
 
-TextureMaterial::TextureMaterial(std::shared_ptr<Shader> shader, glm::vec3 materialCoefficients, float alpha, std::shared_ptr<Texture> diffuseTexture)
+TextureMaterial::TextureMaterial(std::shared_ptr<ShaderPermutations> shader, glm::vec3 materialCoefficients, float alpha, std::shared_ptr<Texture> diffuseTexture)
     : Material(shader, materialCoefficients, alpha)
     , _diffuseTexture(diffuseTexture) {}
 
-    TextureMaterial::TextureMaterial(std::shared_ptr<Shader> shader,
+    TextureMaterial::TextureMaterial(std::shared_ptr<ShaderPermutations> shader,
         glm::vec3 materialCoefficients,
         float alpha,
         std::shared_ptr<Texture> diffuseTexture,
@@ -49,23 +46,7 @@ _normalMapTexture(normalMapTexture) {}
 
 TextureMaterial::~TextureMaterial() {}
 
-void TextureMaterial::setUniforms() {
-    Material::setUniforms();
-
-    if (_diffuseTexture) {
-        // std::cout << "  → Binding diffuse texture ID: " << _diffuseTexture->getID() << " to unit 0" << std::endl;
-        _diffuseTexture->bind(0);
-        _shader->setUniform("diffuseTexture", 0);
-    }
-
-    glActiveTexture(GL_TEXTURE0 + 1);
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    // Bind normal map texture if present
-    if (_normalMapTexture) {
-        // std::cout << "  → Binding normal texture ID: " << _normalMapTexture->getID() << " to unit 1" << std::endl;
-        _normalMapTexture->bind(1);
-        _shader->setUniform("normalTexture", 1);
-    }
+void TextureMaterial::releaseTextures() {
+    _diffuseTexture = nullptr;
+    _normalMapTexture = nullptr;
 }
-
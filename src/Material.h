@@ -5,7 +5,7 @@
  */
 #pragma once
 
-#include "Shader.h"
+#include "ShaderPermutations.h"
 #include <glm/glm.hpp>
 #include <memory>
 #include "Texture.h"
@@ -17,9 +17,9 @@
 class Material {
   protected:
     /*!
-     * The shader used for rendering this material
+     * The shader variants used for rendering this material
      */
-    std::shared_ptr<Shader> _shader;
+    std::shared_ptr<ShaderPermutations> _shader;
     /*!
      * The material's color
      */
@@ -35,6 +35,16 @@ class Material {
      */
     float _alpha;
 
+    /*!
+     * Whether geometry with this material is laid down in the depth pre-pass
+     */
+    bool _depthPrepass = true;
+
+    /*!
+     * Row of this material in the MaterialTable
+     */
+    unsigned int _materialIndex = 0;
+
   public:
     /*!
      * Base material constructor
@@ -43,26 +53,42 @@ class Material {
      * @param materialCoefficients: The material's coefficients (x = ambient, y = diffuse, z = specular)
      * @param alpha: Alpha value, i.e. the shininess constant
      */
-    Material(std::shared_ptr<Shader> shader, glm::vec3 color, glm::vec3 materialCoefficients, float alpha);
+    Material(std::shared_ptr<ShaderPermutations> shader, glm::vec3 color, glm::vec3 materialCoefficients, float alpha);
     /*!
      * Base material constructor
      * @param shader: The shader used for rendering this material
      * @param materialCoefficients: The material's coefficients (x = ambient, y = diffuse, z = specular)
      * @param alpha: Alpha value, i.e. the shininess constant
      */
-    Material(std::shared_ptr<Shader> shader, glm::vec3 materialCoefficients, float alpha);
+    Material(std::shared_ptr<ShaderPermutations> shader, glm::vec3 materialCoefficients, float alpha);
 
     virtual ~Material();
 
     /*!
-     * @return The shader associated with this material
+     * @return The shader variant for the active shader features
      */
     Shader* getShader();
+    ShaderPermutations* getShaderPermutations() const { return _shader.get(); }
 
     /*!
-     * Sets this material's parameters as uniforms in the shader
+     * Binds per-material state that is not in the MaterialTable,
+     * color, coefficients, alpha and textures all live there
      */
     virtual void setUniforms();
+
+    glm::vec3 getColor() const { return _color; }
+    glm::vec3 getCoefficients() const { return _materialCoefficients; }
+    float getAlpha() const { return _alpha; }
+
+    void setMaterialIndex(unsigned int index) { _materialIndex = index; }
+    unsigned int getMaterialIndex() const { return _materialIndex; }
+
+    /*!
+     * Materials whose vertex shader moves vertices (e.g. water waves) must opt out,
+     * the position-only pre-pass would write a different depth than the color pass
+     */
+    void setDepthPrepass(bool enabled) { _depthPrepass = enabled; }
+    bool usesDepthPrepass() const { return _depthPrepass; }
 };
 
 
@@ -85,17 +111,20 @@ class TextureMaterial : public Material {
      * @param alpha: Alpha value, i.e. the shininess constant
      * @param diffuseTexture: The diffuse texture of this material
      */
-    TextureMaterial(std::shared_ptr<Shader> shader, glm::vec3 materialCoefficients, float alpha, std::shared_ptr<Texture> diffuseTexture);
+    TextureMaterial(std::shared_ptr<ShaderPermutations> shader, glm::vec3 materialCoefficients, float alpha, std::shared_ptr<Texture> diffuseTexture);
 
-    TextureMaterial(std::shared_ptr<Shader> shader, glm::vec3 materialCoefficients, float alpha,
+    TextureMaterial(std::shared_ptr<ShaderPermutations> shader, glm::vec3 materialCoefficients, float alpha,
       std::shared_ptr<Texture> diffuseTexture,
       std::shared_ptr<Texture> normalMapTexture);
 
     virtual ~TextureMaterial();
 
+    std::shared_ptr<Texture> getDiffuseTexture() const { return _diffuseTexture; }
+    std::shared_ptr<Texture> getNormalTexture() const { return _normalMapTexture; }
+
     /*!
-     * Set's this material's parameters as uniforms in the shader
+     * Drops the textures once the MaterialTable copied them into its texture arrays
      */
-    virtual void setUniforms();
+    void releaseTextures();
 };
 
@@ -18,29 +18,18 @@ glm::vec3 calculateRayDirection(float mouseX, float mouseY, const glm::mat4& pro
     return glm::normalize(glm::vec3(rayWorld));
 }
 
-RenderObject* pickObject(double mouseX, double mouseY, int width, int height, const POVCamera& camera, physx::PxScene* scene) {
+void requestPick(const POVCamera& camera, SceneQueries& queries, std::function<void(RenderObject*)> onPicked) {
 
     // Kamera-Position und -Richtung
-    glm::vec3 rayOrigin = camera.getPosition();
-    glm::vec3 rayDir = glm::normalize(camera.forward);  
-
-    rayOrigin += rayDir * 0.21f;
-
-    // Umwandlung in PhysX-Vektoren
-    physx::PxVec3 originPx(rayOrigin.x, rayOrigin.y, rayOrigin.z);
-    physx::PxVec3 dirPx(rayDir.x, rayDir.y, rayDir.z);
-
-    // Raycast durchführen
-    physx::PxRaycastBuffer hit;
-    physx::PxHitFlags hitFlags = physx::PxHitFlag::ePOSITION | physx::PxHitFlag::eNORMAL;
-    bool hitSomething = scene->raycast(originPx, dirPx, 5.0f, hit, hitFlags);  // kurze Reichweite!
-
-    if (hitSomething && hit.hasBlock) {
-        return reinterpret_cast<RenderObject*>(hit.block.actor->userData);
-    }
-
-    return nullptr;
-
+    glm::vec3 rayDir = glm::normalize(camera.forward);
+    glm::vec3 rayOrigin = camera.getPosition() + rayDir * 0.21f;
+
+    // kurze Reichweite!
+    queries.raycast(rayOrigin, rayDir, 5.0f, physx::PxQueryFilterData(),
+                    [onPicked](const SceneQueries::Result& hit) {
+                        EntityInfo* entity = hit.hasBlock ? EntityInfo::fromActor(hit.actor) : nullptr;
+                        onPicked(entity ? entity->renderObject : nullptr);
+                    });
 }
 
-}
\ No newline at end of file
+}
@@ -2,10 +2,15 @@
 
 #include "RenderObject.h"
 #include "POVCamera.h"
+#include "SceneQueries.h"
+#include <functional>
 #include <vector>
 #include <PxPhysicsAPI.h>
 
 namespace ObjectPicker {
     glm::vec3 calculateRayDirection(double mouseX, double mouseY, int width, int height, const POVCamera& camera);
-    RenderObject* pickObject(double mouseX, double mouseY, int width, int height, const POVCamera& camera, physx::PxScene* scene);
-}
\ No newline at end of file
+    /*!
+     * Enqueues a short ray along the view direction, onPicked gets the hit object (or nullptr) when the queries execute
+     */
+    void requestPick(const POVCamera& camera, SceneQueries& queries, std::function<void(RenderObject*)> onPicked);
+}
@@ -1,4 +1,5 @@
 #include "POVCamera.h"
+#include "PhysicsTelemetry.h"
 #include <iostream>
 #define M_PI 3.14159265358979323846
 
@@ -22,6 +23,7 @@ POVCamera::POVCamera(glm::vec3 startPosition, float width, float height, Physics
     isGrounded = false;
     // cameraBody = physics.createCameraBody(position);
     characterController = physics.createCharacterController(position);
+    updateControllerFilters();
     updateCameraVectors();
 }
 
@@ -30,6 +32,14 @@ void POVCamera::setSprinting(bool sprinting)
     isSprinting = sprinting;
 }
 
+void POVCamera::setInBloomyWorld(bool bloomy)
+{
+    if (inBloomyWorld == bloomy)
+        return;
+    inBloomyWorld = bloomy;
+    updateControllerFilters();
+}
+
 float POVCamera::getFootPos() const
 {
     return (float)characterController->getFootPosition().y;
@@ -49,12 +59,9 @@ void POVCamera::updateCameraVectors()
     upward = glm::normalize(glm::cross(right, forward));
 }
 
-// Update camera position based on PhysX controller
+// Moves the controller by the frame's input and gravity, then updates the camera position
 void POVCamera::updateFromPhysics(physx::PxScene *gScene, float deltaTime)
 {
-    physx::PxExtendedVec3 extendedPos = characterController->getPosition();
-    position = glm::vec3(extendedPos.x, extendedPos.y, extendedPos.z);
-
     const float gravity = -9.81f;
 
     verticalVelocity += gravity * deltaTime;
@@ -70,8 +77,13 @@ void POVCamera::updateFromPhysics(physx::PxScene *gScene, float deltaTime)
         verticalVelocity = 0.0f;
     }
 
-    glm::vec3 movement(0.0f, verticalVelocity * deltaTime, 0.0f);
-    moveWithDynamicFilters(movement, deltaTime);
+    // one sweep per frame, grounded state always comes from the complete movement
+    glm::vec3 movement = pendingDisplacement + glm::vec3(0.0f, verticalVelocity * deltaTime, 0.0f);
+    pendingDisplacement = glm::vec3(0.0f);
+    moveController(movement, deltaTime);
+
+    physx::PxExtendedVec3 extendedPos = characterController->getPosition();
+    position = glm::vec3(extendedPos.x, extendedPos.y, extendedPos.z);
 }
 
 glm::vec3 POVCamera::getForward() const
@@ -87,9 +99,9 @@ void POVCamera::processKeyboard(char direction, float deltaTime)
     glm::vec3 forwardFlat = glm::normalize(glm::vec3(forward.x, 0.0f, forward.z)); // Nur x und z
     glm::vec3 rightFlat = glm::normalize(glm::cross(upward, forwardFlat));         // Nur x und z
 
-    glm::vec3 movement(0.0f, 0.0f, 0.0f);
+    glm::vec3 &movement = pendingDisplacement;
 
-    // calculate movement
+    // accumulate movement, updateFromPhysics applies it
     if (direction == 'W')
     {
         movement += forwardFlat * moveStep;
@@ -114,8 +126,6 @@ void POVCamera::processKeyboard(char direction, float deltaTime)
         isGrounded = false;
         groundedTimer = 0.0f;
     }
-
-    moveWithDynamicFilters(movement, deltaTime);
 }
 
 // mouse control (view around)
@@ -197,44 +207,38 @@ void POVCamera::setPosition(glm::vec3 positionVec)
     position = positionVec;
 }
 
+void POVCamera::teleport(const glm::vec3 &positionVec)
+{
+    characterController->setPosition(physx::PxExtendedVec3(positionVec.x, positionVec.y, positionVec.z));
+    position = positionVec;
+    pendingDisplacement = glm::vec3(0.0f);
+    updateCameraVectors();
+}
+
 glm::mat4 POVCamera::getShadowProjectionMatrix() const
 {
     return glm::perspective(glm::radians(90.0f), width / height, 0.1f, 20.0f);
 }
 
-void POVCamera::moveWithDynamicFilters(const glm::vec3 &displacement, float deltaTime)
+void POVCamera::updateControllerFilters()
 {
-    // Create the filter data based on the world the player is in
-    physx::PxFilterData filterData;
-    if (inBloomyWorld)
-    {
-        filterData.word0 = WORLD_BLOOM;                // Set the world the controller belongs to
-        filterData.word1 = WORLD_BLOOM | WORLD_STATIC; // Collide with Bloomy world objects and static ones
-    }
-    else
-    {
-        filterData.word0 = WORLD_DITHER;                // Set the world the controller belongs to
-        filterData.word1 = WORLD_DITHER | WORLD_STATIC; // Collide with Dither world objects and static ones
-    }
-
-    // Create PxControllerFilters with the dynamically updated filter data
-    physx::PxControllerFilters controllerFilters;
-    controllerFilters.mFilterData = &filterData;
-
-    // Create the custom filter callback
-    // CustomFilterCallback* filterCallback = new CustomFilterCallback();
-    // controllerFilters.mFilterCallback = filterCallback;  // Use the custom filter callback
+    // the controller belongs to the world the player is in and collides with it and static objects
+    uint32_t world = inBloomyWorld ? WORLD_BLOOM : WORLD_DITHER;
+    controllerFilterData = physx::PxFilterData(world, world | WORLD_STATIC, 0, 0);
     controllerFilters.mFilterFlags = physx::PxQueryFlags(physx::PxQueryFlag::eSTATIC | physx::PxQueryFlag::eDYNAMIC | physx::PxQueryFlag::ePREFILTER);
+}
+
+void POVCamera::moveController(const glm::vec3 &displacement, float deltaTime)
+{
+    // set here rather than once, the camera is copied into the player after construction
+    controllerFilters.mFilterData = &controllerFilterData;
 
-    // Convert displacement to PxVec3 for movement
     physx::PxVec3 disp(displacement.x, displacement.y, displacement.z);
 
     // Define a minimum distance for movement to consider
     PxF32 minDist = 0.001f;
-
-    // Use the move function with the updated filter
-    PxF32 elapsedTime = deltaTime; // Time elapsed since last frame
-    PxControllerCollisionFlags flags = characterController->move(disp, minDist, elapsedTime, controllerFilters);
+    PxControllerCollisionFlags flags = characterController->move(disp, minDist, deltaTime, controllerFilters);
+    PhysicsTelemetry::countControllerMove();
 
     // the very smart isGrounded condition
     if (flags & PxControllerCollisionFlag::eCOLLISION_DOWN)
@@ -249,4 +253,4 @@ void POVCamera::moveWithDynamicFilters(const glm::vec3 &displacement, float delt
         if (groundedTimer < 0.0f)
             groundedTimer = 0.0f;
     }
-}
\ No newline at end of file
+}
@@ -12,6 +12,14 @@ class POVCamera
 private:
     void updateCameraVectors();
     float POVCamera::getBodySize();
+    void updateControllerFilters();
+    void moveController(const glm::vec3 &displacement, float deltaTime);
+
+    // walking input of the frame, applied together with gravity in a single controller move
+    glm::vec3 pendingDisplacement = glm::vec3(0.0f);
+    // only change on a world switch, see setInBloomyWorld
+    physx::PxFilterData controllerFilterData;
+    physx::PxControllerFilters controllerFilters;
 
 public:
     // bool isGrounded(physx::PxScene *scene);
@@ -31,11 +39,16 @@ public:
     void processKeyboard(char direction, float deltaTime);
     void processMouseMovement(float xoffset, float yoffset);
     void POVCamera::setSprinting(bool isSprinting);
+    void setInBloomyWorld(bool bloomy);
     glm::mat4 getViewProjectionMatrix() const;
     glm::mat4 getProjectionMatrix() const;
     glm::mat4 getViewMatrix() const;
     glm::vec3 getPosition() const;
     void setPosition(glm::vec3 position);
+    /*!
+     * Moves the character controller without sweeping, for checkpoints
+     */
+    void teleport(const glm::vec3 &position);
     glm::mat4 projection;
     bool headBobActive;
     bool isJumping;
@@ -55,5 +68,4 @@ public:
     physx::PxRigidDynamic *cameraBody;
     physx::PxCapsuleController *characterController;
     glm::mat4 getShadowProjectionMatrix() const;
-    void POVCamera::moveWithDynamicFilters(const glm::vec3 &displacement, float deltaTime);
 };
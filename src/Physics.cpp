@@ -1,4 +1,8 @@
 #include "Physics.h"
+#include "Log.h"
+#include "PhysicsTelemetry.h"
+#include <algorithm>
+#include <chrono>
 
 static physx::PxFilterFlags WorldFilterShader(
     physx::PxFilterObjectAttributes attributes0,
@@ -11,13 +15,15 @@ static physx::PxFilterFlags WorldFilterShader(
 {
     // Check if the objects should interact based on the filter data
     if ((filterData0.word0 & filterData1.word1) == 0 || (filterData1.word0 & filterData0.word1) == 0)
+    {
+        PhysicsTelemetry::countKilledPair();
         return physx::PxFilterFlag::eKILL;
+    }
 
     // Enable both trigger events and collision events for the pair
     pairFlags = physx::PxPairFlag::eCONTACT_DEFAULT | physx::PxPairFlag::eTRIGGER_DEFAULT; // Allow both
 
-    std::cout << "filterData0.word0: " << filterData0.word0 << ", filterData0.word1: " << filterData0.word1 << std::endl;
-    std::cout << "filterData1.word0: " << filterData1.word0 << ", filterData1.word1: " << filterData1.word1 << std::endl;
+    LOG_TRACE(Log::PHYSICS, "pair filter %u/%u against %u/%u", filterData0.word0, filterData0.word1, filterData1.word0, filterData1.word1);
     return physx::PxFilterFlag::eDEFAULT;
 }
 
@@ -233,14 +239,8 @@ physx::PxCapsuleController *Physics::createCharacterController(const glm::vec3 &
     return capsuleController;
 }
 
-physx::PxRigidActor *Physics::createMeshFromGeometry(const GeometryData &geometryData, RigidBodyType bodyType)
+physx::PxRigidActor *Physics::createMeshFromGeometry(const GeometryData &geometryData, RigidBodyType bodyType, const CollisionProxy::Settings &proxySettings)
 {
-    std::vector<physx::PxVec3> pxVertices;
-    for (const auto &vertex : geometryData.positions)
-    {
-        pxVertices.push_back(physx::PxVec3(vertex.x, vertex.y, vertex.z));
-    }
-
     // === COMMON SETUP ===
     PxTolerancesScale scale;
     PxCookingParams cookingParams(scale);
@@ -251,49 +251,49 @@ physx::PxRigidActor *Physics::createMeshFromGeometry(const GeometryData &geometr
     PxShape *shape = nullptr;
     PxRigidActor *actor = nullptr;
 
-    if (bodyType == RigidBodyType::STATIC)
+    // === HEIGHT FIELD FOR FLOORS, the triangle mesh stays the fallback ===
+    CollisionProxy::HeightField heightField;
+    if (bodyType == RigidBodyType::STATIC && proxySettings.type == CollisionProxy::Type::HEIGHTFIELD)
     {
-        // === TRIANGLE MESH FOR STATIC ===
-        std::vector<physx::PxU32> pxIndices;
-        for (size_t i = 0; i < geometryData.indices.size(); i += 3)
-        {
-            pxIndices.push_back(geometryData.indices[i]);
-            pxIndices.push_back(geometryData.indices[i + 1]);
-            pxIndices.push_back(geometryData.indices[i + 2]);
-        }
-
-        PxTriangleMeshDesc meshDesc;
-        meshDesc.points.count = static_cast<physx::PxU32>(pxVertices.size());
-        meshDesc.points.stride = sizeof(physx::PxVec3);
-        meshDesc.points.data = pxVertices.data();
-
-        meshDesc.triangles.count = static_cast<physx::PxU32>(pxIndices.size() / 3);
-        meshDesc.triangles.stride = 3 * sizeof(physx::PxU32);
-        meshDesc.triangles.data = pxIndices.data();
+        auto start = std::chrono::steady_clock::now();
+        if (CollisionProxy::buildHeightField(geometryData, proxySettings, heightField))
+            shape = createHeightFieldShape(heightField);
 
-        PxDefaultMemoryOutputStream writeBuffer;
-        PxTriangleMeshCookingResult::Enum result;
-        bool status = PxCookTriangleMesh(cookingParams, meshDesc, writeBuffer, &result);
-        if (!status)
+        // walls and creases the grid cut out collide as a small triangle mesh on the same actor
+        PxShape *holeShape = nullptr;
+        if (shape && !heightField.meshIndices.empty())
         {
-            std::cerr << "Failed to cook the triangle mesh." << std::endl;
-            return nullptr;
+            holeShape = createTriangleMeshShape(heightField.meshPositions, heightField.meshIndices, cookingParams);
+            if (!holeShape)
+            {
+                shape->release();
+                shape = nullptr;
+            }
         }
 
-        PxDefaultMemoryInputData readBuffer(writeBuffer.getData(), writeBuffer.getSize());
-        PxTriangleMesh *triangleMesh = gPhysics->createTriangleMesh(readBuffer);
-        if (!triangleMesh)
+        if (shape)
         {
-            std::cerr << "Failed to create the triangle mesh." << std::endl;
-            return nullptr;
+            LOG_INFO(Log::PHYSICS, "collision proxy: height field %dx%d (%zu KB) and %zu hole triangles instead of %zu triangles in %.2f ms",
+                     heightField.rows, heightField.columns, heightField.heights.size() * sizeof(PxHeightFieldSample) / 1024,
+                     heightField.meshIndices.size() / 3, geometryData.indices.size() / 3,
+                     std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+            PxRigidStatic *rigidStatic = gPhysics->createRigidStatic(transform);
+            rigidStatic->attachShape(*shape);
+            if (holeShape)
+                rigidStatic->attachShape(*holeShape);
+            gScene->addActor(*rigidStatic);
+            return rigidStatic;
         }
+        LOG_INFO(Log::PHYSICS, "collision proxy: mesh is not a height field, cooking the triangle mesh");
+    }
 
-        shape = gPhysics->createShape(PxTriangleMeshGeometry(triangleMesh), *defaultMaterial);
+    if (bodyType == RigidBodyType::STATIC)
+    {
+        // === TRIANGLE MESH FOR STATIC ===
+        shape = createTriangleMeshShape(geometryData.positions, geometryData.indices, cookingParams);
         if (!shape)
-        {
-            std::cerr << "Failed to create shape from triangle mesh." << std::endl;
             return nullptr;
-        }
 
         PxRigidStatic *rigidStatic = gPhysics->createRigidStatic(transform);
         rigidStatic->attachShape(*shape);
@@ -301,40 +301,29 @@ physx::PxRigidActor *Physics::createMeshFromGeometry(const GeometryData &geometr
     }
     else // DYNAMIC
     {
-        // === CONVEX MESH FOR DYNAMIC ===
-        PxConvexMeshDesc convexDesc;
-        convexDesc.points.count = static_cast<physx::PxU32>(pxVertices.size());
-        convexDesc.points.stride = sizeof(physx::PxVec3);
-        convexDesc.points.data = pxVertices.data();
-        convexDesc.flags = PxConvexFlag::eCOMPUTE_CONVEX;
-
-        PxDefaultMemoryOutputStream writeBuffer;
-        bool status = PxCookConvexMesh(cookingParams, convexDesc, writeBuffer);
-        if (!status)
-        {
-            std::cerr << "Failed to cook convex mesh." << std::endl;
-            return nullptr;
-        }
+        // === COLLISION PROXY FOR DYNAMIC ===
+        auto start = std::chrono::steady_clock::now();
+        CollisionProxy proxy = CollisionProxy::build(geometryData, proxySettings);
 
-        PxDefaultMemoryInputData readBuffer(writeBuffer.getData(), writeBuffer.getSize());
-        PxConvexMesh *convexMesh = gPhysics->createConvexMesh(readBuffer);
-        if (!convexMesh)
+        PxRigidDynamic *rigidDynamic = gPhysics->createRigidDynamic(transform);
+        for (const CollisionProxy::Part &part : proxy.getParts())
         {
-            std::cerr << "Failed to create convex mesh." << std::endl;
-            return nullptr;
+            shape = createProxyShape(part, cookingParams, proxySettings.maxHullVertices);
+            if (shape)
+                rigidDynamic->attachShape(*shape);
         }
-
-        shape = gPhysics->createShape(PxConvexMeshGeometry(convexMesh), *defaultMaterial);
-        if (!shape)
+        if (rigidDynamic->getNbShapes() == 0)
         {
-            std::cerr << "Failed to create shape from convex mesh." << std::endl;
+            std::cerr << "Failed to create any collision shape for the dynamic mesh." << std::endl;
+            rigidDynamic->release();
             return nullptr;
         }
-
-        PxRigidDynamic *rigidDynamic = gPhysics->createRigidDynamic(transform);
-        rigidDynamic->attachShape(*shape);
         PxRigidBodyExt::updateMassAndInertia(*rigidDynamic, 10.0f);
         actor = rigidDynamic;
+
+        LOG_INFO(Log::PHYSICS, "collision proxy: %s with %zu shape(s) from %zu vertices in %.2f ms",
+                 CollisionProxy::getTypeName(proxy.getType()), proxy.getParts().size(), geometryData.positions.size(),
+                 std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count());
     }
 
     if (actor)
@@ -343,6 +332,163 @@ physx::PxRigidActor *Physics::createMeshFromGeometry(const GeometryData &geometr
     return actor;
 }
 
+PxShape *Physics::createTriangleMeshShape(const std::vector<glm::vec3> &positions, const std::vector<unsigned int> &indices, const PxCookingParams &cookingParams)
+{
+    std::vector<physx::PxVec3> pxVertices;
+    for (const auto &vertex : positions)
+    {
+        pxVertices.push_back(physx::PxVec3(vertex.x, vertex.y, vertex.z));
+    }
+
+    std::vector<physx::PxU32> pxIndices;
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        pxIndices.push_back(indices[i]);
+        pxIndices.push_back(indices[i + 1]);
+        pxIndices.push_back(indices[i + 2]);
+    }
+
+    PxTriangleMeshDesc meshDesc;
+    meshDesc.points.count = static_cast<physx::PxU32>(pxVertices.size());
+    meshDesc.points.stride = sizeof(physx::PxVec3);
+    meshDesc.points.data = pxVertices.data();
+
+    meshDesc.triangles.count = static_cast<physx::PxU32>(pxIndices.size() / 3);
+    meshDesc.triangles.stride = 3 * sizeof(physx::PxU32);
+    meshDesc.triangles.data = pxIndices.data();
+
+    PxDefaultMemoryOutputStream writeBuffer;
+    PxTriangleMeshCookingResult::Enum result;
+    bool status = PxCookTriangleMesh(cookingParams, meshDesc, writeBuffer, &result);
+    if (!status)
+    {
+        std::cerr << "Failed to cook the triangle mesh." << std::endl;
+        return nullptr;
+    }
+
+    PxDefaultMemoryInputData readBuffer(writeBuffer.getData(), writeBuffer.getSize());
+    PxTriangleMesh *triangleMesh = gPhysics->createTriangleMesh(readBuffer);
+    if (!triangleMesh)
+    {
+        std::cerr << "Failed to create the triangle mesh." << std::endl;
+        return nullptr;
+    }
+
+    PxShape *shape = gPhysics->createShape(PxTriangleMeshGeometry(triangleMesh), *defaultMaterial);
+    if (!shape)
+    {
+        std::cerr << "Failed to create shape from triangle mesh." << std::endl;
+        return nullptr;
+    }
+    return shape;
+}
+
+PxShape *Physics::createHeightFieldShape(const CollisionProxy::HeightField &heightField)
+{
+    std::vector<PxHeightFieldSample> samples(heightField.heights.size());
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        samples[i].height = heightField.heights[i];
+        samples[i].materialIndex0 = heightField.holes[i] ? PxHeightFieldMaterial::eHOLE : 0;
+        samples[i].materialIndex1 = heightField.holes[i] ? PxHeightFieldMaterial::eHOLE : 0;
+    }
+
+    PxHeightFieldDesc desc;
+    desc.format = PxHeightFieldFormat::eS16_TM;
+    desc.nbRows = static_cast<PxU32>(heightField.rows);
+    desc.nbColumns = static_cast<PxU32>(heightField.columns);
+    desc.samples.data = samples.data();
+    desc.samples.stride = sizeof(PxHeightFieldSample);
+
+    PxDefaultMemoryOutputStream writeBuffer;
+    if (!PxCookHeightField(desc, writeBuffer))
+    {
+        std::cerr << "Failed to cook the height field." << std::endl;
+        return nullptr;
+    }
+    PxDefaultMemoryInputData readBuffer(writeBuffer.getData(), writeBuffer.getSize());
+    PxHeightField *field = gPhysics->createHeightField(readBuffer);
+    if (!field)
+    {
+        std::cerr << "Failed to create the height field." << std::endl;
+        return nullptr;
+    }
+
+    PxHeightFieldGeometry geometry(field, PxMeshGeometryFlags(), heightField.heightScale, heightField.cellSize, heightField.cellSize);
+    PxShape *shape = gPhysics->createShape(geometry, *defaultMaterial);
+    if (!shape)
+    {
+        std::cerr << "Failed to create shape from height field." << std::endl;
+        return nullptr;
+    }
+    shape->setLocalPose(PxTransform(PxVec3(heightField.origin.x, heightField.origin.y, heightField.origin.z)));
+    return shape;
+}
+
+PxShape *Physics::createProxyShape(const CollisionProxy::Part &part, const PxCookingParams &cookingParams, unsigned int maxHullVertices)
+{
+    PxTransform localPose(PxVec3(part.center.x, part.center.y, part.center.z),
+                          PxQuat(part.rotation.x, part.rotation.y, part.rotation.z, part.rotation.w));
+    PxShape *shape = nullptr;
+
+    switch (part.type)
+    {
+    case CollisionProxy::Type::SPHERE:
+        shape = gPhysics->createShape(PxSphereGeometry(part.halfExtents.x), *defaultMaterial);
+        break;
+    case CollisionProxy::Type::CAPSULE:
+        shape = gPhysics->createShape(PxCapsuleGeometry(part.halfExtents.y, part.halfExtents.x), *defaultMaterial);
+        break;
+    case CollisionProxy::Type::CONVEX_HULL:
+    {
+        std::vector<PxVec3> points;
+        points.reserve(part.points.size());
+        for (const glm::vec3 &point : part.points)
+            points.push_back(PxVec3(point.x, point.y, point.z));
+
+        // the vertex limit bounds the hull the narrow phase works with, quantizing bounds the cooking input
+        PxConvexMeshDesc convexDesc;
+        convexDesc.points.count = static_cast<PxU32>(points.size());
+        convexDesc.points.stride = sizeof(PxVec3);
+        convexDesc.points.data = points.data();
+        convexDesc.flags = PxConvexFlag::eCOMPUTE_CONVEX | PxConvexFlag::eSHIFT_VERTICES;
+        convexDesc.vertexLimit = static_cast<PxU16>(std::clamp(maxHullVertices, 8u, 255u));
+        if (points.size() > convexDesc.quantizedCount)
+            convexDesc.flags |= PxConvexFlag::eQUANTIZE_INPUT;
+
+        PxDefaultMemoryOutputStream writeBuffer;
+        PxConvexMesh *convexMesh = nullptr;
+        if (PxCookConvexMesh(cookingParams, convexDesc, writeBuffer))
+        {
+            PxDefaultMemoryInputData readBuffer(writeBuffer.getData(), writeBuffer.getSize());
+            convexMesh = gPhysics->createConvexMesh(readBuffer);
+        }
+        if (convexMesh)
+        {
+            shape = gPhysics->createShape(PxConvexMeshGeometry(convexMesh), *defaultMaterial);
+            // hull vertices are relative to the part, the pose stays at the origin
+            return shape;
+        }
+
+        // flat or degenerate parts do not cook, their bounding box is close enough
+        std::cerr << "Failed to cook convex mesh, using the bounding box." << std::endl;
+        shape = gPhysics->createShape(PxBoxGeometry(part.halfExtents.x, part.halfExtents.y, part.halfExtents.z), *defaultMaterial);
+        break;
+    }
+    default:
+        shape = gPhysics->createShape(PxBoxGeometry(part.halfExtents.x, part.halfExtents.y, part.halfExtents.z), *defaultMaterial);
+        break;
+    }
+
+    if (!shape)
+    {
+        std::cerr << "Failed to create collision proxy shape." << std::endl;
+        return nullptr;
+    }
+    shape->setLocalPose(localPose);
+    return shape;
+}
+
 physx::PxRigidActor *Physics::createPressurePlate(const glm::vec3 &position, const glm::vec3 &size)
 {
     physx::PxVec3 pxSize(size.x, size.y, size.z);
@@ -362,7 +508,9 @@ physx::PxRigidActor *Physics::createPressurePlate(const glm::vec3 &position, con
 
     gScene->addActor(*pressurePlateActor);
 
-    pressurePlateActor->userData = (void *)"PressurePlate";
+    pressurePlateEntity.name = NameTable::intern("pressure plate");
+    pressurePlateEntity.tags = TAG_PRESSURE_PLATE | TAG_TRIGGER;
+    pressurePlateActor->userData = &pressurePlateEntity;
 
     return pressurePlateActor;
 }
@@ -5,8 +5,10 @@
 #include <glm/glm.hpp>
 #include "Geometry.h"
 #include "RenderObject.h"
+#include "CollisionProxy.h"
 #include <iostream>
 #include "PressurePlateTriggerListener.h"
+#include "Log.h"
 #include <PxControllerManager.h>
 #include <PxCapsuleController.h>
 #include <PxController.h>
@@ -34,10 +36,16 @@ public:
     PxMaterial *defaultMaterial;
     PressurePlateTriggerListener *triggerListener;
     PxControllerManager *gControllerManager = nullptr;
+    EntityInfo pressurePlateEntity;
     PxController *characterController = nullptr;
     Physics();
     void initPhysX();
-    physx::PxRigidActor *Physics::createMeshFromGeometry(const GeometryData &geometryData, RigidBodyType bodyType);
+    /*!
+     * Static bodies get the triangle mesh, or a height field when proxySettings asks for one and the mesh
+     * is a floor. Dynamic bodies get the collision proxy described by proxySettings
+     */
+    physx::PxRigidActor *Physics::createMeshFromGeometry(const GeometryData &geometryData, RigidBodyType bodyType,
+                                                         const CollisionProxy::Settings &proxySettings = CollisionProxy::Settings());
     PxRigidStatic *createPlane();
     float getCharacterSize();
     PxRigidDynamic *createCameraBody(glm::vec3 startPosition);
@@ -47,6 +55,11 @@ public:
     physx::PxRigidActor *createPressurePlate(const glm::vec3 &position, const glm::vec3 &size);
     void shutdownPhysX();
     physx::PxCapsuleController *Physics::createCharacterController(const glm::vec3 &startPosition);
+
+private:
+    PxShape *createTriangleMeshShape(const std::vector<glm::vec3> &positions, const std::vector<unsigned int> &indices, const PxCookingParams &cookingParams);
+    PxShape *createHeightFieldShape(const CollisionProxy::HeightField &heightField);
+    PxShape *createProxyShape(const CollisionProxy::Part &part, const PxCookingParams &cookingParams, unsigned int maxHullVertices);
 };
 
 class CustomFilterCallback : public physx::PxQueryFilterCallback
@@ -60,7 +73,7 @@ public:
         physx::PxHitFlags &queryFlags) override
     {
 
-        std::cout << "Pre-filtering: " << filterData.word0 << ", " << filterData.word1 << std::endl;
+        LOG_TRACE(Log::PHYSICS, "pre-filtering %u, %u", filterData.word0, filterData.word1);
 
         // Example filtering logic based on world mask (filterData.word0 and word1)
         if ((filterData.word0 & filterData.word1) == 0)
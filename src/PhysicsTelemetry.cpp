@@ -0,0 +1,86 @@
+#include "PhysicsTelemetry.h"
+#include "Log.h"
+
+void PhysicsTelemetry::record(physx::PxScene *scene, float simulateMs, float fetchResultsMs, uint32_t sceneQueries)
+{
+    // taken even while disabled so the first sample after enabling only holds its own step
+    uint32_t killed = killedPairs.exchange(0, std::memory_order_relaxed);
+    uint32_t moves = controllerMoves.exchange(0, std::memory_order_relaxed);
+    if (!isEnabled())
+        return;
+
+    physx::PxSimulationStatistics stats;
+    scene->getSimulationStatistics(stats);
+
+    Sample &sample = history[next];
+    sample.simulateMs = simulateMs;
+    sample.fetchResultsMs = fetchResultsMs;
+    sample.activeDynamicBodies = stats.nbActiveDynamicBodies;
+    sample.dynamicBodies = stats.nbDynamicBodies;
+    sample.staticBodies = stats.nbStaticBodies;
+    sample.broadPhaseAdds = stats.getNbBroadPhaseAdds();
+    sample.broadPhaseRemoves = stats.getNbBroadPhaseRemoves();
+    sample.contactPairs = stats.nbDiscreteContactPairsTotal;
+    sample.contactPairsTouching = stats.nbDiscreteContactPairsWithContacts;
+    sample.newTouches = stats.nbNewTouches;
+    sample.lostTouches = stats.nbLostTouches;
+    sample.partitions = stats.nbPartitions;
+    sample.killedPairs = killed;
+    sample.controllerMoves = moves;
+    sample.sceneQueries = sceneQueries;
+
+    next = (next + 1) % HISTORY;
+    if (count < HISTORY)
+        count++;
+
+    if (csv.is_open())
+        writeCsvRow(csv, sample);
+}
+
+bool PhysicsTelemetry::dumpCsv(const std::string &path)
+{
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+    {
+        LOG_ERROR(Log::PHYSICS, "could not write physics telemetry to %s", path.c_str());
+        return false;
+    }
+
+    writeCsvHeader(out);
+    for (int i = 0; i < count; ++i)
+        writeCsvRow(out, getSample(i));
+
+    LOG_INFO(Log::PHYSICS, "wrote %d physics steps to %s", count, path.c_str());
+    return true;
+}
+
+bool PhysicsTelemetry::startCsv(const std::string &path)
+{
+    csv.close();
+    csv.open(path, std::ios::trunc);
+    if (!csv)
+    {
+        LOG_ERROR(Log::PHYSICS, "could not write physics telemetry to %s", path.c_str());
+        csv.close();
+        return false;
+    }
+
+    writeCsvHeader(csv);
+    return true;
+}
+
+void PhysicsTelemetry::writeCsvHeader(std::ostream &out)
+{
+    out << "simulate_ms,fetch_results_ms,active_dynamic,dynamic,static,broadphase_adds,broadphase_removes,"
+           "contact_pairs,touching_pairs,new_touches,lost_touches,partitions,killed_pairs,controller_moves,scene_queries\n";
+}
+
+void PhysicsTelemetry::writeCsvRow(std::ostream &out, const Sample &sample)
+{
+    out << sample.simulateMs << ',' << sample.fetchResultsMs << ','
+        << sample.activeDynamicBodies << ',' << sample.dynamicBodies << ',' << sample.staticBodies << ','
+        << sample.broadPhaseAdds << ',' << sample.broadPhaseRemoves << ','
+        << sample.contactPairs << ',' << sample.contactPairsTouching << ','
+        << sample.newTouches << ',' << sample.lostTouches << ',' << sample.partitions << ','
+        << sample.killedPairs << ',' << sample.controllerMoves << ',' << sample.sceneQueries << '\n';
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <PxPhysicsAPI.h>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+/*!
+ * What PhysX did each step, kept as a rolling history for the physics panel.
+ * Game::updatePhysics calls record once per step with the step timing, the statistics come from
+ * PxScene::getSimulationStatistics. Counters that PhysX does not provide (pairs killed by the
+ * filter shader, character controller moves) are counted where they happen and reset by record.
+ * Nothing is gathered while disabled, the counters then cost one relaxed atomic add.
+ */
+class PhysicsTelemetry
+{
+public:
+    static constexpr int HISTORY = 240;
+
+    struct Sample
+    {
+        float simulateMs;
+        float fetchResultsMs;
+        uint32_t activeDynamicBodies;
+        uint32_t dynamicBodies;
+        uint32_t staticBodies;
+        uint32_t broadPhaseAdds;
+        uint32_t broadPhaseRemoves;
+        uint32_t contactPairs;
+        uint32_t contactPairsTouching;
+        uint32_t newTouches;
+        uint32_t lostTouches;
+        uint32_t partitions;
+        uint32_t killedPairs;
+        uint32_t controllerMoves;
+        uint32_t sceneQueries;
+    };
+
+    static void setEnabled(bool enabled) { PhysicsTelemetry::enabled = enabled; }
+    static bool isEnabled() { return enabled || csv.is_open(); }
+
+    // called from the filter shader, which runs on the PhysX worker threads
+    static void countKilledPair() { killedPairs.fetch_add(1, std::memory_order_relaxed); }
+    static void countControllerMove() { controllerMoves.fetch_add(1, std::memory_order_relaxed); }
+
+    /*!
+     * Adds the sample of the step that just finished, the scene must not be simulating
+     */
+    static void record(physx::PxScene *scene, float simulateMs, float fetchResultsMs, uint32_t sceneQueries);
+
+    static const Sample &getLatest() { return history[(next + HISTORY - 1) % HISTORY]; }
+    /*!
+     * @param age: 0 is the oldest sample still in the history, count() - 1 the latest
+     */
+    static const Sample &getSample(int age) { return history[(next + HISTORY - count + age) % HISTORY]; }
+    static int getCount() { return count; }
+
+    /*!
+     * Writes the rolling history as CSV, oldest first
+     */
+    static bool dumpCsv(const std::string &path);
+    /*!
+     * Appends every following sample to a CSV file until stopCsv, keeps gathering while the panel is closed
+     */
+    static bool startCsv(const std::string &path);
+    static void stopCsv() { csv.close(); }
+    static bool isWritingCsv() { return csv.is_open(); }
+
+private:
+    static void writeCsvHeader(std::ostream &out);
+    static void writeCsvRow(std::ostream &out, const Sample &sample);
+
+    inline static bool enabled = false;
+    inline static std::atomic<uint32_t> killedPairs{0};
+    inline static std::atomic<uint32_t> controllerMoves{0};
+
+    inline static Sample history[HISTORY] = {};
+    inline static int next = 0;
+    inline static int count = 0;
+    inline static std::ofstream csv;
+};
@@ -0,0 +1,153 @@
+#include "PreprocessedShader.h"
+#include "ProgramCache.h"
+#include "Render/DrawDataBuffer.h"
+#include "ShaderBuildQueue.h"
+#include "ShaderPreprocessor.h"
+#include <chrono>
+
+PreprocessedShader::PreprocessedShader(
+    const std::string &vs,
+    const std::string &fs,
+    const std::vector<std::string> &defines)
+    : defines(defines)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    _vs = vs;
+    _fs = fs;
+
+    std::string vSource, fSource;
+    if (!ShaderPreprocessor::load(vs, defines, vSource, vPath, &vFiles))
+    {
+        std::cerr << "Failed to load vertex shader: " << vs << std::endl;
+        return;
+    }
+    if (!ShaderPreprocessor::load(fs, defines, fSource, fPath, &fFiles))
+    {
+        std::cerr << "Failed to load fragment shader: " << fs << std::endl;
+        return;
+    }
+
+    cacheKey = ProgramCache::makeKey({vSource, fSource});
+    if (ProgramCache::load(cacheKey, program))
+    {
+        DrawDataBuffer::bindProgram(program);
+        _handle = program;
+    }
+    else
+    {
+        program = glCreateProgram();
+
+        if (program == 0)
+        {
+            std::cerr << "Failed to create shader program." << std::endl;
+            return;
+        }
+
+        // no status queries until finalize(), they would wait for the compiler
+        const char *src = vSource.c_str();
+        vShader = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(vShader, 1, &src, nullptr);
+        glCompileShader(vShader);
+
+        src = fSource.c_str();
+        fShader = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(fShader, 1, &src, nullptr);
+        glCompileShader(fShader);
+
+        glAttachShader(program, vShader);
+        glAttachShader(program, fShader);
+
+        if (ProgramCache::isEnabled())
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        glLinkProgram(program);
+
+        pending = true;
+        if (ShaderBuildQueue::isOpen())
+            ShaderBuildQueue::add(this);
+        else
+            finalize();
+    }
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+    ProgramCache::addBuildTime(elapsed.count());
+}
+
+PreprocessedShader::~PreprocessedShader()
+{
+    if (pending)
+    {
+        ShaderBuildQueue::remove(this);
+        glDeleteShader(vShader);
+        glDeleteShader(fShader);
+        glDeleteProgram(program);
+    }
+}
+
+bool PreprocessedShader::isReady() const
+{
+    if (!pending || !ShaderBuildQueue::hasParallelCompile())
+        return true;
+
+    GLint done = GL_FALSE;
+    glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &done);
+    return done == GL_TRUE;
+}
+
+bool PreprocessedShader::finalize()
+{
+    if (!pending)
+        return program != 0 && _handle == program;
+    pending = false;
+
+    bool compiled = checkShader(vShader, vPath, vFiles);
+    compiled = checkShader(fShader, fPath, fFiles) && compiled;
+
+    GLint linked = GL_FALSE;
+    if (compiled)
+    {
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (!linked)
+        {
+            char log[1024];
+            glGetProgramInfoLog(program, 1024, NULL, log);
+            std::cerr << "Shader program linking failed: " << _vs << ", " << _fs << "\n"
+                      << log << std::endl;
+        }
+    }
+
+    glDetachShader(program, vShader);
+    glDetachShader(program, fShader);
+    glDeleteShader(vShader);
+    glDeleteShader(fShader);
+    vShader = fShader = 0;
+
+    if (!linked)
+    {
+        glDeleteProgram(program);
+        program = 0;
+        return false;
+    }
+
+    ProgramCache::store(cacheKey, program);
+    DrawDataBuffer::bindProgram(program);
+    _handle = program;
+    return true;
+}
+
+bool PreprocessedShader::checkShader(GLuint shader, const std::string &path, const std::vector<std::string> &files)
+{
+    GLint compiled;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (!compiled)
+    {
+        char log[1024];
+        glGetShaderInfoLog(shader, 1024, nullptr, log);
+        std::cerr << "Failed to compile shader: " << path << "\n"
+                  << log << std::endl;
+        for (size_t i = 0; i < files.size(); i++)
+            std::cerr << "  source " << i << ": " << files[i] << std::endl;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Shader.h"
+#include <cstdint>
+#include <vector>
+
+/*!
+ * Vertex/fragment shader whose sources go through the ShaderPreprocessor,
+ * so they can #include shared modules and be specialized with #defines.
+ * Linked programs are restored from the ProgramCache when possible.
+ * While the ShaderBuildQueue is open the constructor only submits the
+ * compile and link, the queue finalizes the program later.
+ */
+class PreprocessedShader : public Shader {
+    public:
+        /*!
+         * @param vs: path to the vertex shader
+         * @param fs: path to the fragment shader
+         * @param defines: names defined in both stages, e.g. "NORMAL_MAP"
+         */
+        PreprocessedShader(
+            const std::string& vs,
+            const std::string& fs,
+            const std::vector<std::string>& defines = {}
+        );
+
+        ~PreprocessedShader();
+
+        /*!
+         * @return if the driver finished compiling and linking, never blocks
+         */
+        bool isReady() const;
+
+        /*!
+         * Checks compile and link status and stores the binary in the ProgramCache,
+         * blocks until the driver is done
+         * @return if the program linked
+         */
+        bool finalize();
+
+    private:
+        std::vector<std::string> defines;
+
+        // state of a submitted but not yet finalized build
+        bool pending = false;
+        GLuint program = 0, vShader = 0, fShader = 0;
+        uint64_t cacheKey = 0;
+        std::string vPath, fPath;
+        std::vector<std::string> vFiles, fFiles;
+
+        bool checkShader(GLuint shader, const std::string& path, const std::vector<std::string>& files);
+    };
@@ -1,6 +1,7 @@
 #include <physx/PxPhysicsAPI.h>
 #include "GameLogic/GameState.h"
-#include <iostream>
+#include "Log.h"
+#include "EntityInfo.h"
 
 class PressurePlateTriggerListener : public physx::PxSimulationEventCallback
 {
@@ -42,10 +43,9 @@ public:
 
 
                 // Check if one of the colliders is the pressure plate and the other is the remote
-                if ((pairHeader.actors[0]->userData == (void*)"PressurePlate" && pairHeader.actors[1]->userData == (void*)"Remote") ||
-                    (pairHeader.actors[1]->userData == (void*)"PressurePlate" && pairHeader.actors[0]->userData == (void*)"Remote"))
+                if (isPlateAndRemote(pairHeader.actors[0], pairHeader.actors[1]) || isPlateAndRemote(pairHeader.actors[1], pairHeader.actors[0]))
                 {
-                    std::cout << "Pressure Plate and Remote are in contact!" << std::endl;
+                    LOG_INFO(Log::PHYSICS, "pressure plate and remote are in contact");
                     triggerWinScreen();  // Trigger the win screen
                 } 
             }
@@ -53,10 +53,9 @@ public:
             if (pair.flags.isSet(physx::PxContactPairFlag::eACTOR_PAIR_LOST_TOUCH)) // When the objects stop touching (exit)
             {
                 // Check if one of the colliders is the pressure plate and the other is the remote
-                if ((pairHeader.actors[0]->userData == (void*)"PressurePlate" && pairHeader.actors[1]->userData == (void*)"Remote") ||
-                    (pairHeader.actors[1]->userData == (void*)"PressurePlate" && pairHeader.actors[0]->userData == (void*)"Remote"))
+                if (isPlateAndRemote(pairHeader.actors[0], pairHeader.actors[1]) || isPlateAndRemote(pairHeader.actors[1], pairHeader.actors[0]))
                 {
-                    std::cout << "Pressure Plate and Remote are no longer in contact!" << std::endl;
+                    LOG_INFO(Log::PHYSICS, "pressure plate and remote are no longer in contact");
                 }
             }
         }
@@ -77,21 +76,20 @@ public:
             if (pairs[i].status == physx::PxPairFlag::eNOTIFY_TOUCH_FOUND || pairs[i].status == physx::PxPairFlag::eNOTIFY_TOUCH_LOST)
             {
                 // Check if the trigger is the pressure plate and the other actor is the remote
-                if (triggerShape->getActor()->userData == (void*)"PressurePlate" &&
-                    otherActor->userData == (void*)"Remote")
+                if (isPlateAndRemote(triggerShape->getActor(), otherActor))
                 {
                     if (pairs[i].status == physx::PxPairFlag::eNOTIFY_TOUCH_FOUND)
                     {
-                        std::cout << "Pressure Plate Triggered! Remote is on the plate." << std::endl;
+                        LOG_INFO(Log::PHYSICS, "pressure plate triggered, the remote is on the plate");
                         g_GameState = GameState::Won;
                     }
                     else if (pairs[i].status == physx::PxPairFlag::eNOTIFY_TOUCH_LOST)
                     {
-                        std::cout << "Remote has left the pressure plate." << std::endl;
+                        LOG_INFO(Log::PHYSICS, "the remote has left the pressure plate");
                     }
                 }
             }  else {
-                std::cout << "notify faulty" << std::endl;
+                LOG_WARN(Log::PHYSICS, "unexpected trigger status %d", static_cast<int>(pairs[i].status));
             }
         }
     }
@@ -103,6 +101,13 @@ public:
     }
 
 private:
+    static bool isPlateAndRemote(const physx::PxActor* plate, const physx::PxActor* remote)
+    {
+        const EntityInfo* plateEntity = EntityInfo::fromActor(plate);
+        const EntityInfo* remoteEntity = EntityInfo::fromActor(remote);
+        return plateEntity && remoteEntity && plateEntity->hasTag(TAG_PRESSURE_PLATE) && remoteEntity->hasTag(TAG_REMOTE);
+    }
+
     void triggerWinScreen()
     {
         g_GameState = GameState::Won;
@@ -0,0 +1,205 @@
+#include "ProgramCache.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    const uint32_t CACHE_MAGIC = 0x43535044; // "DPSC"
+    const uint32_t CACHE_VERSION = 1;
+
+    struct CacheHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t key;
+        uint32_t format;
+        uint32_t size;
+        uint64_t checksum;
+    };
+
+    // FNV-1a, stable across runs and platforms unlike std::hash
+    uint64_t fnv1a(const void *data, size_t size, uint64_t hash = 14695981039346656037ull)
+    {
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    uint64_t fnv1a(const std::string &text, uint64_t hash)
+    {
+        // hash the length too, so ("ab", "c") and ("a", "bc") differ
+        uint64_t size = text.size();
+        hash = fnv1a(&size, sizeof(size), hash);
+        return fnv1a(text.data(), text.size(), hash);
+    }
+
+    std::string glString(GLenum name)
+    {
+        const char *value = reinterpret_cast<const char *>(glGetString(name));
+        return value ? value : "";
+    }
+}
+
+bool ProgramCache::enabled = false;
+std::string ProgramCache::directory;
+uint64_t ProgramCache::driverHash = 0;
+std::vector<GLint> ProgramCache::formats;
+int ProgramCache::hits = 0;
+int ProgramCache::misses = 0;
+double ProgramCache::buildMs = 0.0;
+
+void ProgramCache::init(const std::string &cacheDirectory, bool cacheEnabled)
+{
+    resetStats();
+    directory = cacheDirectory;
+
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    formats.assign(formatCount, 0);
+    if (formatCount > 0)
+        glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data());
+
+    enabled = cacheEnabled && formatCount > 0;
+    if (cacheEnabled && !enabled)
+        std::cerr << "Program binary cache disabled: driver exposes no binary formats" << std::endl;
+
+    driverHash = fnv1a(glString(GL_VENDOR), 14695981039346656037ull);
+    driverHash = fnv1a(glString(GL_RENDERER), driverHash);
+    driverHash = fnv1a(glString(GL_VERSION), driverHash);
+    driverHash = fnv1a(formats.data(), formats.size() * sizeof(GLint), driverHash);
+
+    if (enabled)
+    {
+        std::error_code error;
+        fs::create_directories(directory, error);
+        if (error)
+        {
+            std::cerr << "Cannot create program cache directory: " << directory << std::endl;
+            enabled = false;
+        }
+    }
+}
+
+uint64_t ProgramCache::makeKey(const std::vector<std::string> &sources)
+{
+    uint64_t key = fnv1a(&CACHE_VERSION, sizeof(CACHE_VERSION), driverHash);
+    for (const std::string &source : sources)
+        key = fnv1a(source, key);
+    return key;
+}
+
+std::string ProgramCache::getPath(uint64_t key)
+{
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return (fs::path(directory) / name.str()).string();
+}
+
+bool ProgramCache::load(uint64_t key, GLuint &program)
+{
+    program = 0;
+    if (!enabled)
+        return false;
+
+    std::ifstream in(getPath(key), std::ios::in | std::ios::binary);
+    if (!in)
+    {
+        misses++;
+        return false;
+    }
+
+    CacheHeader header{};
+    std::vector<char> binary;
+    bool valid = static_cast<bool>(in.read(reinterpret_cast<char *>(&header), sizeof(header))) &&
+                 header.magic == CACHE_MAGIC && header.version == CACHE_VERSION && header.key == key &&
+                 std::find(formats.begin(), formats.end(), static_cast<GLint>(header.format)) != formats.end();
+    if (valid)
+    {
+        binary.resize(header.size);
+        valid = static_cast<bool>(in.read(binary.data(), binary.size())) &&
+                fnv1a(binary.data(), binary.size()) == header.checksum;
+    }
+    in.close();
+
+    if (valid)
+    {
+        program = glCreateProgram();
+        glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+        // the driver may reject a binary it wrote itself (e.g. after an update that kept the version string)
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (!linked)
+        {
+            glDeleteProgram(program);
+            program = 0;
+            valid = false;
+        }
+    }
+
+    if (!valid)
+    {
+        std::error_code error;
+        fs::remove(getPath(key), error);
+        misses++;
+        return false;
+    }
+
+    hits++;
+    return true;
+}
+
+void ProgramCache::store(uint64_t key, GLuint program)
+{
+    if (!enabled)
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0)
+        return;
+    binary.resize(written);
+
+    CacheHeader header{};
+    header.magic = CACHE_MAGIC;
+    header.version = CACHE_VERSION;
+    header.key = key;
+    header.format = format;
+    header.size = static_cast<uint32_t>(binary.size());
+    header.checksum = fnv1a(binary.data(), binary.size());
+
+    // write to a temporary file first, a crash mid-write must not leave a truncated entry behind
+    std::string path = getPath(key);
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out)
+            return;
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(binary.data(), binary.size());
+        if (!out)
+            return;
+    }
+
+    std::error_code error;
+    fs::rename(tempPath, path, error);
+    if (error)
+        fs::remove(tempPath, error);
+}
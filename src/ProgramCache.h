@@ -0,0 +1,66 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*!
+ * On-disk cache of linked program binaries (glGetProgramBinary / glProgramBinary).
+ * Entries are keyed by a hash of the preprocessed sources and the driver's
+ * vendor, renderer, version and binary formats, so a driver update or a shader
+ * edit simply misses the cache. Broken or rejected entries are recompiled.
+ */
+class ProgramCache
+{
+public:
+    /*!
+     * Has to be called with a current context before the first shader is built
+     * @param directory: folder the binaries are stored in, created on demand
+     * @param enabled: false compiles every program from source
+     */
+    static void init(const std::string &directory, bool enabled);
+
+    static bool isEnabled() { return enabled; }
+
+    /*!
+     * @param sources: preprocessed source of every stage, in attach order
+     * @return the cache key for the sources on this driver
+     */
+    static uint64_t makeKey(const std::vector<std::string> &sources);
+
+    /*!
+     * Creates a program from the cached binary
+     * @return if a valid binary was found and linked, program is 0 otherwise
+     */
+    static bool load(uint64_t key, GLuint &program);
+
+    /*!
+     * Stores the binary of a linked program, it has to be linked with
+     * GL_PROGRAM_BINARY_RETRIEVABLE_HINT set
+     */
+    static void store(uint64_t key, GLuint program);
+
+    /*!
+     * Build statistics since the last resetStats
+     */
+    static void resetStats() { hits = misses = 0; buildMs = 0.0; }
+    static int getHits() { return hits; }
+    static int getMisses() { return misses; }
+
+    /*!
+     * Adds time spent building programs (cached or compiled)
+     */
+    static void addBuildTime(double ms) { buildMs += ms; }
+    static double getBuildTime() { return buildMs; }
+
+private:
+    static bool enabled;
+    static std::string directory;
+    static uint64_t driverHash;
+    static std::vector<GLint> formats;
+    static int hits, misses;
+    static double buildMs;
+
+    static std::string getPath(uint64_t key);
+};
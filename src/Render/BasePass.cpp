@@ -1,123 +1,336 @@
 #include "BasePass.h"
+#include <algorithm>
 
-BasePass::BasePass(int width, int height, std::vector<std::shared_ptr<RenderObject>> &renderObjects, Player *player, bool &inBloomyWorld, bool &underwater)
-    : RenderPass(width, height, renderObjects), player(player), inBloomyWorld(inBloomyWorld), underwater(underwater)
+BasePass::BasePass(int width, int height, const SceneDrawLists &drawLists, Player *player, bool &inBloomyWorld)
+    : RenderPass(width, height), player(player), drawLists(drawLists), inBloomyWorld(inBloomyWorld),
+      renderWidth(width), renderHeight(height)
 {
     Init();
 }
 void BasePass::Init()
 {
-    glGenFramebuffers(1, &hdrFBO);
-    glGenTextures(1, &hdrBuffer);
-    glBindFramebuffer(GL_FRAMEBUFFER, hdrFBO);
+    // render targets are owned by the render graph, see buildGraph
+}
 
-    glBindTexture(GL_TEXTURE_2D, hdrBuffer);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+void BasePass::setAntialiasing(Antialiasing mode, int samples)
+{
+    GLint maxColorSamples = 1, maxDepthSamples = 1;
+    glGetIntegerv(GL_MAX_COLOR_TEXTURE_SAMPLES, &maxColorSamples);
+    glGetIntegerv(GL_MAX_DEPTH_TEXTURE_SAMPLES, &maxDepthSamples);
+    msaaSamples = std::max(1, std::min({samples, int(maxColorSamples), int(maxDepthSamples)}));
+    setAntialiasingMode(mode);
+}
 
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, hdrBuffer, 0);
+void BasePass::setAntialiasingMode(Antialiasing mode)
+{
+    antialiasing = mode == Antialiasing::MSAA && msaaSamples < 2 ? Antialiasing::OFF : mode;
+    if (shadowPass && waterPass)
+        buildGraph(shadowPass, waterPass);
+}
 
-    glGenRenderbuffers(1, &rboDepth);
-    glBindRenderbuffer(GL_RENDERBUFFER, rboDepth);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rboDepth);
+void BasePass::configureDynamicResolution(float targetMilliseconds, float minScale, float maxScale, float sharpness)
+{
+    dynamicResolution.configure(targetMilliseconds, minScale, maxScale);
+    this->sharpness = std::max(sharpness, 0.0f);
+}
 
-    glGenTextures(1, &brightBuffer);
+void BasePass::setDynamicResolution(bool enabled)
+{
+    dynamicResolution.setEnabled(enabled);
+    renderWidth = width;
+    renderHeight = height;
+    if (shadowPass && waterPass)
+        buildGraph(shadowPass, waterPass);
+}
 
-    glBindTexture(GL_TEXTURE_2D, brightBuffer);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, brightBuffer, 0);
+BasePass::Antialiasing BasePass::parseAntialiasing(const std::string &name)
+{
+    if (name == "msaa")
+        return Antialiasing::MSAA;
+    if (name == "fxaa")
+        return Antialiasing::FXAA;
+    return Antialiasing::OFF;
+}
 
-    GLuint attachments[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
-    glDrawBuffers(2, attachments);
+const char *BasePass::getAntialiasingName(Antialiasing mode)
+{
+    switch (mode)
+    {
+    case Antialiasing::MSAA:
+        return "MSAA";
+    case Antialiasing::FXAA:
+        return "FXAA";
+    default:
+        return "off";
+    }
+}
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+void BasePass::buildGraph(RenderPass *shadowPass, RenderPass *waterPass)
+{
+    this->shadowPass = shadowPass;
+    this->waterPass = waterPass;
+    graph.clear();
 
-    glGenFramebuffers(2, pingpongFBO);
+    RenderGraph::Resource shadowMap = graph.import("shadow map", shadowPass->getTexture(),
+                                                   {shadowPass->getWidth(), shadowPass->getHeight(), GL_DEPTH_COMPONENT});
+    RenderGraph::Resource waterHeightfield = graph.import("water heightfield", waterPass->getTexture(),
+                                                          {waterPass->getWidth(), waterPass->getHeight(), GL_RGBA16F});
+    RenderGraph::Resource backbuffer = graph.importBackbuffer(width, height);
 
-    glGenTextures(2, pingpongBuffers);
-    for (unsigned int i = 0; i < 2; i++)
+    graph.addPass("shadow map", [&](RenderGraph::Builder &builder)
+                  { builder.write(shadowMap); },
+                  [shadowPass](const RenderGraph::Context &)
+                  { shadowPass->Execute(); });
+
+    graph.addPass("water heightfield", [&](RenderGraph::Builder &builder)
+                  { builder.write(waterHeightfield); },
+                  [waterPass](const RenderGraph::Context &)
+                  { waterPass->Execute(); });
+
+    // the bright target is RGBA16F like the blur targets, so the blur chain can reuse it.
+    // Everything up to the composite only fills the lower left renderWidth x renderHeight part,
+    // targets are linear filtered for the upscale
+    int samples = antialiasing == Antialiasing::MSAA ? msaaSamples : 1;
+    RenderGraph::Resource hdr = RenderGraph::INVALID, bright = RenderGraph::INVALID;
+    graph.addPass("scene", [&](RenderGraph::Builder &builder)
+                  {
+                      builder.read(shadowMap, SHADOW_MAP_UNIT);
+                      builder.read(waterHeightfield, WATER_HEIGHTFIELD_UNIT);
+                      hdr = builder.create("hdr", {width, height, GL_RGB16F, samples, GL_LINEAR});
+                      bright = builder.create("bright", {width, height, GL_RGBA16F, samples, GL_LINEAR});
+                      builder.create("depth", {width, height, GL_DEPTH_COMPONENT24, samples});
+                  },
+                  [this](const RenderGraph::Context &context)
+                  {
+                      context.bindTarget();
+                      setRenderViewport();
+                      drawScene();
+                  });
+
+    // bloom and composite work on single sampled copies
+    if (samples > 1)
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, pingpongFBO[i]);
-        glBindTexture(GL_TEXTURE_2D, pingpongBuffers[i]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, pingpongBuffers[i], 0);
+        RenderGraph::Resource hdrSamples = hdr, brightSamples = bright;
+        graph.addPass("msaa resolve", [&](RenderGraph::Builder &builder)
+                      {
+                          builder.read(hdrSamples, RenderGraph::NO_UNIT);
+                          builder.read(brightSamples, RenderGraph::NO_UNIT);
+                          hdr = builder.create("hdr resolved", {width, height, GL_RGB16F, 1, GL_LINEAR});
+                          bright = builder.create("bright resolved", {width, height, GL_RGBA16F, 1, GL_LINEAR});
+                      },
+                      [=](const RenderGraph::Context &context)
+                      {
+                          context.bindTarget();
+                          context.resolve(hdrSamples, hdr, renderWidth, renderHeight);
+                          context.resolve(brightSamples, bright, renderWidth, renderHeight);
+                      });
     }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        std::cerr << "BasePass FBO not complete!" << std::endl;
+    RenderGraph::Resource bloom = bright;
+    for (int i = 0; i < BLOOM_BLUR_PASSES; i++)
+    {
+        RenderGraph::Resource source = bloom;
+        bool horizontal = i % 2 == 0;
+        graph.addPass("bloom blur " + std::to_string(i), [&](RenderGraph::Builder &builder)
+                      {
+                          builder.read(source, 0);
+                          bloom = builder.create("bloom " + std::to_string(i), {width, height, GL_RGBA16F, 1, GL_LINEAR});
+                      },
+                      [this, horizontal](const RenderGraph::Context &context)
+                      {
+                          context.bindTarget();
+                          setRenderViewport();
+                          blurShader->use();
+                          blurShader->setUniform("horizontal", horizontal);
+                          blurShader->setUniform("image", 0);
+                          blurShader->setUniform("renderScale", getRenderScale());
+                          drawFullScreenQuad();
+                      });
+    }
+
+    // FXAA and sharpening filter the full resolution image, every step but the last needs a target of its own
+    bool fxaa = antialiasing == Antialiasing::FXAA;
+    bool sharpen = dynamicResolution.isEnabled() && sharpness > 0.0f;
+    auto output = [&](RenderGraph::Builder &builder, const std::string &name, bool last)
+    {
+        if (!last)
+            return builder.create(name, {width, height, GL_RGBA8, 1, GL_LINEAR});
+        builder.write(backbuffer);
+        return backbuffer;
+    };
+
+    RenderGraph::Resource composited = backbuffer;
+    graph.addPass("composite", [&](RenderGraph::Builder &builder)
+                  {
+                      builder.read(hdr, 0);
+                      builder.read(bloom, 1);
+                      composited = output(builder, "composited", !fxaa && !sharpen);
+                  },
+                  [this](const RenderGraph::Context &context)
+                  {
+                      context.bindTarget();
+                      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+                      compositeShader->use();
+                      compositeShader->setUniform("scene", 0);
+                      compositeShader->setUniform("bloomBlur", 1);
+                      compositeShader->setUniform("exposure", 1.0f);
+                      compositeShader->setUniform("renderScale", getRenderScale());
+                      drawFullScreenQuad();
+                  });
+
+    if (fxaa)
+    {
+        graph.addPass("fxaa", [&](RenderGraph::Builder &builder)
+                      {
+                          builder.read(composited, 0);
+                          composited = output(builder, "antialiased", !sharpen);
+                      },
+                      [this](const RenderGraph::Context &context)
+                      {
+                          context.bindTarget();
+                          fxaaShader->use();
+                          fxaaShader->setUniform("image", 0);
+                          fxaaShader->setUniform("inverseScreenSize", glm::vec2(1.0f / width, 1.0f / height));
+                          drawFullScreenQuad();
+                      });
+    }
+
+    if (sharpen)
+    {
+        graph.addPass("sharpen", [&](RenderGraph::Builder &builder)
+                      {
+                          builder.read(composited, 0);
+                          builder.write(backbuffer);
+                      },
+                      [this](const RenderGraph::Context &context)
+                      {
+                          context.bindTarget();
+                          sharpenShader->use();
+                          sharpenShader->setUniform("image", 0);
+                          // nothing to restore at full resolution
+                          sharpenShader->setUniform("sharpness", renderWidth < width ? std::min(sharpness, 1.0f) : 0.0f);
+                          drawFullScreenQuad();
+                      });
+    }
+
+    graph.compile();
+    graph.printReport();
 }
 
 void BasePass::Execute()
 {
-    glBindFramebuffer(GL_FRAMEBUFFER, hdrFBO);
-    glViewport(0, 0, width, height);
+    dynamicResolution.beginFrame();
+    graph.execute();
+    dynamicResolution.endFrame();
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // the next frame's size is known before its per-frame uniforms are set
+    float scale = dynamicResolution.getScale();
+    renderWidth = std::clamp(static_cast<int>(width * scale + 0.5f), 1, width);
+    renderHeight = std::clamp(static_cast<int>(height * scale + 0.5f), 1, height);
+}
+
+void BasePass::drawScene()
+{
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     skybox.draw(player->getCamera().getViewProjNoTransforms(), inBloomyWorld);
 
-    int worldMask = inBloomyWorld ? WORLD_BLOOM : WORLD_DITHER;
-    for (const auto &renderObject : *renderObjects)
+    if (depthPrepass)
     {
-        if (renderObject->isRendered == true)
-        {
-            renderObject->geometry->drawInWorld(worldMask, underwater);
-        }
+        depthPrepassTimer.begin();
+        drawDepthPrepass();
+        depthPrepassTimer.end();
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glViewport(0, 0, width, height);
 
-    bool horizontal = true;
-    int amount = 10;
-    blurShader->use();
+    GpuTimer &colorTimer = depthPrepass ? colorTimerWithPrepass : colorTimerWithoutPrepass;
+    colorTimer.begin();
+    drawOpaque();
+    colorTimer.end();
+}
 
-    for (unsigned int i = 0; i < amount; i++)
+void BasePass::drawDepthPrepass()
+{
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+    depthPrepassShader->use();
+    depthPrepassShader->setUniform("viewProjMatrix", player->getViewProjectionMatrix());
+
+    for (const SceneDrawLists::DrawItem &item : drawLists.getPrepassable())
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, pingpongFBO[horizontal]);
-        blurShader->setUniform("horizontal", horizontal);
-        blurShader->setUniform("image", 0);
-        glActiveTexture(GL_TEXTURE0);
+        if (!item.occluded)
+            item.geometry->drawDepthOnly();
+    }
 
-        if (i == 0)
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+}
+
+void BasePass::drawOpaque()
+{
+    // pre-passed geometry only shades the pixels it won in the pre-pass
+    if (depthPrepass)
+    {
+        glDepthFunc(GL_EQUAL);
+        glDepthMask(GL_FALSE);
+    }
+
+    drawItems(drawLists.getPrepassable());
+
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+
+    // everything left out of the pre-pass (displaced water, tessellated meshes) is depth tested as usual
+    drawItems(drawLists.getRemaining());
+}
+
+void BasePass::drawItems(const std::vector<SceneDrawLists::DrawItem> &items)
+{
+    // the lists are sorted by shader and material, state only changes between runs
+    ShaderPermutations *boundPermutations = nullptr;
+    Material *boundMaterial = nullptr;
+    Shader *shader = nullptr;
+    for (const SceneDrawLists::DrawItem &item : items)
+    {
+        if (item.occluded)
+            continue;
+        if (item.shader != boundPermutations)
         {
-            glBindTexture(GL_TEXTURE_2D, brightBuffer);
+            shader = item.material->getShader();
+            shader->use();
+            boundPermutations = item.shader;
+            boundMaterial = nullptr;
         }
-        else
+        if (item.material != boundMaterial)
         {
-            glBindTexture(GL_TEXTURE_2D, pingpongBuffers[!horizontal]);
+            item.material->setUniforms();
+            boundMaterial = item.material;
         }
-
-        drawFullScreenQuad();
-        horizontal = !horizontal;
+        item.geometry->draw(shader);
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glViewport(0, 0, width, height);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-    compositeShader->use();
-    compositeShader->setUniform("scene", 0);
-    compositeShader->setUniform("bloomBlur", 1);
-
-    compositeShader->setUniform("exposure", 1.0f);
+}
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, hdrBuffer);
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, pingpongBuffers[!horizontal]);
+void BasePass::getStats(FrameStats &stats) const
+{
+    stats.depthPrepassEnabled = depthPrepass;
+    stats.depthPrepassMs = depthPrepassTimer.getMilliseconds();
+    stats.colorPassMsWithPrepass = colorTimerWithPrepass.getMilliseconds();
+    stats.colorPassMsWithoutPrepass = colorTimerWithoutPrepass.getMilliseconds();
+    stats.colorPassMs = depthPrepass ? stats.colorPassMsWithPrepass : stats.colorPassMsWithoutPrepass;
 
-    drawFullScreenQuad();
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    const RenderGraph::Stats &graphStats = graph.getStats();
+    stats.graphPasses = graphStats.passes;
+    stats.graphCulledPasses = graphStats.culledPasses;
+    stats.renderTargets = graphStats.physicalTargets;
+    stats.renderTargetBytes = graphStats.transientBytes;
+    stats.renderTargetBytesUnaliased = graphStats.unaliasedBytes;
+    stats.antialiasing = getAntialiasingName(antialiasing);
+    stats.dynamicResolution = dynamicResolution.isEnabled();
+    stats.renderWidth = renderWidth;
+    stats.renderHeight = renderHeight;
+    stats.gpuFrameMs = dynamicResolution.getGpuMilliseconds();
+    stats.targetFrameMs = dynamicResolution.getTargetMilliseconds();
+    stats.msaaSamples = antialiasing == Antialiasing::MSAA ? msaaSamples : 0;
 }
 
 void BasePass::drawFullScreenQuad()
@@ -3,21 +3,111 @@
 #include "RenderPass.h"
 #include "../Skybox.h"
 #include "../GameLogic/Player.h"
+#include "GpuTimer.h"
+#include "FrameStats.h"
+#include "RenderGraph.h"
+#include "DynamicResolution.h"
 class BasePass : public RenderPass
 {
 public:
-    BasePass(int width, int height, std::vector<std::shared_ptr<RenderObject>> &renderObjects, Player *player, bool &inBloomyWorld, bool &underwater);
+    enum class Antialiasing
+    {
+        OFF,
+        MSAA, // multisampled scene targets, resolved before bloom
+        FXAA  // post filter on the composited image
+    };
+
+    BasePass(int width, int height, const SceneDrawLists &drawLists, Player *player, bool &inBloomyWorld);
+
+    // texture units the scene shaders sample the graph's inputs from
+    static constexpr GLuint SHADOW_MAP_UNIT = 5;
+    static constexpr GLuint WATER_HEIGHTFIELD_UNIT = 6;
 
     void Init() override;
     void Execute();
 
+    /*!
+     * Declares the frame (shadow map, water heightfield, scene, bloom, composite) in the render
+     * graph and compiles it. Both passes have to outlive this one.
+     */
+    void buildGraph(RenderPass *shadowPass, RenderPass *waterPass);
+
+    /*!
+     * With the pre-pass on, opaque geometry is first drawn depth-only and the color pass
+     * then shades each pixel once with GL_EQUAL and depth writes off
+     */
+    void setDepthPrepass(bool enabled) { depthPrepass = enabled; }
+    bool isDepthPrepassEnabled() const { return depthPrepass; }
+
+    /*!
+     * Rebuilds the graph if it was already built. Shading stays per pixel with MSAA,
+     * so the ordered dither pattern and the pre-pass depth test look the same in every mode.
+     * @param samples: MSAA sample count, clamped to what the driver supports
+     */
+    void setAntialiasing(Antialiasing mode, int samples);
+    /*!
+     * Switches the mode and keeps the sample count of the last setAntialiasing
+     */
+    void setAntialiasingMode(Antialiasing mode);
+    Antialiasing getAntialiasing() const { return antialiasing; }
+
+    /*!
+     * "msaa", "fxaa" or "off", anything else is off
+     */
+    static Antialiasing parseAntialiasing(const std::string &name);
+    static const char *getAntialiasingName(Antialiasing mode);
+
+    /*!
+     * Renders the scene and bloom into a scaled down part of the targets and upscales it in the
+     * composite pass (Catmull-Rom, then RCAS sharpening), the scale follows the GPU frame time
+     * @param targetMilliseconds: GPU frame time to hold, usually derived from the refresh rate
+     * @param minScale, maxScale: bounds of the render scale relative to the window size
+     * @param sharpness: strength of the RCAS pass after upscaling, 0 skips it
+     */
+    void configureDynamicResolution(float targetMilliseconds, float minScale, float maxScale, float sharpness);
+    void setDynamicResolution(bool enabled);
+    bool isDynamicResolutionEnabled() const { return dynamicResolution.isEnabled(); }
+
+    /*!
+     * Size the next frame renders at, passes that depend on the pixel grid (clustered lighting) need it
+     */
+    int getRenderWidth() const { return renderWidth; }
+    int getRenderHeight() const { return renderHeight; }
+
+    /*!
+     * Fills in the GPU timings of the last finished frames and the render graph's numbers
+     */
+    void getStats(FrameStats &stats) const;
+
 private:
-    GLuint colorBuffers[2], rboDepth, pingpongFBO[2], pingpongBuffers[2], brightFBO, brightBuffer, hdrBuffer, hdrFBO;
-    std::shared_ptr<Shader> blurShader = std::make_shared<Shader>("assets/shaders/gaussianBlur.vert", "assets/shaders/gaussianBlur.frag");
-    std::shared_ptr<Shader> compositeShader = std::make_shared<Shader>("assets/shaders/composite.vert", "assets/shaders/composite.frag");
+    static constexpr int BLOOM_BLUR_PASSES = 10;
+
+    RenderGraph graph;
+    std::shared_ptr<Shader> blurShader = std::make_shared<PreprocessedShader>("assets/shaders/gaussianBlur.vert", "assets/shaders/gaussianBlur.frag");
+    std::shared_ptr<Shader> compositeShader = std::make_shared<PreprocessedShader>("assets/shaders/composite.vert", "assets/shaders/composite.frag");
+    std::shared_ptr<Shader> fxaaShader = std::make_shared<PreprocessedShader>("assets/shaders/composite.vert", "assets/shaders/fxaa.frag");
+    std::shared_ptr<Shader> sharpenShader = std::make_shared<PreprocessedShader>("assets/shaders/composite.vert", "assets/shaders/rcas.frag");
+    std::shared_ptr<Shader> depthPrepassShader = std::make_shared<PreprocessedShader>("assets/shaders/depthPrepass.vert", "assets/shaders/depthPrepass.frag");
     Player *player;
     Skybox skybox;
+    const SceneDrawLists &drawLists;
     bool &inBloomyWorld;
-    bool &underwater;
+    bool depthPrepass = true;
+    Antialiasing antialiasing = Antialiasing::OFF;
+    int msaaSamples = 1;
+    RenderPass *shadowPass = nullptr;
+    RenderPass *waterPass = nullptr;
+    DynamicResolution dynamicResolution;
+    float sharpness = 0.0f;
+    int renderWidth, renderHeight;
+    // one color timer per mode, so both numbers stay around for the comparison
+    GpuTimer depthPrepassTimer, colorTimerWithPrepass, colorTimerWithoutPrepass;
+
+    void drawDepthPrepass();
+    void drawOpaque();
+    void drawItems(const std::vector<SceneDrawLists::DrawItem> &items);
+    void drawScene();
+    void setRenderViewport() const { glViewport(0, 0, renderWidth, renderHeight); }
+    glm::vec2 getRenderScale() const { return glm::vec2(float(renderWidth) / width, float(renderHeight) / height); }
     void drawFullScreenQuad();
 };
\ No newline at end of file
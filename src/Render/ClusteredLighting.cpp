@@ -0,0 +1,203 @@
+#include "ClusteredLighting.h"
+#include <algorithm>
+#include <cmath>
+
+ClusteredLighting::ClusteredLighting(int width, int height)
+    : width(width), height(height), renderWidth(width), renderHeight(height)
+{
+    glGenBuffers(1, &lightBuffer);
+    glGenBuffers(1, &clusterBuffer);
+    glGenBuffers(1, &lightIndexBuffer);
+
+    clusterRanges.resize(CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z);
+}
+
+ClusteredLighting::~ClusteredLighting()
+{
+    glDeleteBuffers(1, &lightBuffer);
+    glDeleteBuffers(1, &clusterBuffer);
+    glDeleteBuffers(1, &lightIndexBuffer);
+}
+
+float ClusteredLighting::sliceDepth(unsigned int slice) const
+{
+    return zNear * std::pow(zFar / zNear, float(slice) / float(CLUSTERS_Z));
+}
+
+unsigned int ClusteredLighting::depthToSlice(float depth) const
+{
+    float slice = std::floor(std::log(depth / zNear) * float(CLUSTERS_Z) / std::log(zFar / zNear));
+    return static_cast<unsigned int>(std::clamp(slice, 0.0f, float(CLUSTERS_Z - 1)));
+}
+
+void ClusteredLighting::buildClusterBounds(const glm::mat4 &projection)
+{
+    zNear = projection[3][2] / (projection[2][2] - 1.0f);
+    zFar = projection[3][2] / (projection[2][2] + 1.0f);
+
+    glm::mat4 inverseProjection = glm::inverse(projection);
+    auto unprojectToNear = [&](float x, float y)
+    {
+        glm::vec4 p = inverseProjection * glm::vec4(x, y, -1.0f, 1.0f);
+        return glm::vec3(p) / p.w;
+    };
+
+    clusterBounds.resize(CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z);
+    for (unsigned int z = 0; z < CLUSTERS_Z; z++)
+    {
+        float depthNear = sliceDepth(z);
+        float depthFar = sliceDepth(z + 1);
+
+        for (unsigned int y = 0; y < CLUSTERS_Y; y++)
+        {
+            for (unsigned int x = 0; x < CLUSTERS_X; x++)
+            {
+                glm::vec3 tileMin = unprojectToNear(-1.0f + 2.0f * x / CLUSTERS_X, -1.0f + 2.0f * y / CLUSTERS_Y);
+                glm::vec3 tileMax = unprojectToNear(-1.0f + 2.0f * (x + 1) / CLUSTERS_X, -1.0f + 2.0f * (y + 1) / CLUSTERS_Y);
+
+                // the tile corners lie on the near plane, scale them along their view ray to the slice depths
+                glm::vec3 corners[4] = {
+                    tileMin * (depthNear / zNear), tileMax * (depthNear / zNear),
+                    tileMin * (depthFar / zNear), tileMax * (depthFar / zNear)};
+
+                ClusterBounds &bounds = clusterBounds[x + CLUSTERS_X * (y + CLUSTERS_Y * z)];
+                bounds.min = corners[0];
+                bounds.max = corners[0];
+                for (const glm::vec3 &corner : corners)
+                {
+                    bounds.min = glm::min(bounds.min, corner);
+                    bounds.max = glm::max(bounds.max, corner);
+                }
+            }
+        }
+    }
+}
+
+void ClusteredLighting::update(const std::vector<PointLight> &lights, const glm::mat4 &projection, const glm::mat4 &viewProjection)
+{
+    if (projection != clusterProjection)
+    {
+        buildClusterBounds(projection);
+        clusterProjection = projection;
+    }
+
+    glm::mat4 view = glm::inverse(projection) * viewProjection;
+
+    gpuLights.clear();
+    assignments.clear();
+
+    for (const PointLight &light : lights)
+    {
+        if (!light.enabled)
+            continue;
+
+        float range = light.getRange();
+        glm::vec3 center = glm::vec3(view * glm::vec4(light.position, 1.0f));
+        float depth = -center.z;
+        if (depth + range < zNear || depth - range > zFar)
+            continue;
+
+        unsigned int minX = 0, maxX = CLUSTERS_X - 1;
+        unsigned int minY = 0, maxY = CLUSTERS_Y - 1;
+
+        // lights crossing the near plane can cover any tile, otherwise project their bounding box
+        if (depth - range > zNear)
+        {
+            glm::vec2 ndcMin(1.0f), ndcMax(-1.0f);
+            for (int i = 0; i < 8; i++)
+            {
+                glm::vec3 corner = center + range * glm::vec3(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f);
+                glm::vec4 clip = projection * glm::vec4(corner, 1.0f);
+                glm::vec2 ndc = glm::vec2(clip) / clip.w;
+                ndcMin = glm::min(ndcMin, ndc);
+                ndcMax = glm::max(ndcMax, ndc);
+            }
+
+            if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f)
+                continue;
+
+            auto toTile = [](float ndc, unsigned int count)
+            {
+                float tile = std::floor((ndc * 0.5f + 0.5f) * count);
+                return static_cast<unsigned int>(std::clamp(tile, 0.0f, float(count - 1)));
+            };
+            minX = toTile(ndcMin.x, CLUSTERS_X);
+            maxX = toTile(ndcMax.x, CLUSTERS_X);
+            minY = toTile(ndcMin.y, CLUSTERS_Y);
+            maxY = toTile(ndcMax.y, CLUSTERS_Y);
+        }
+
+        unsigned int minZ = depthToSlice(std::max(depth - range, zNear));
+        unsigned int maxZ = depthToSlice(std::min(depth + range, zFar));
+
+        GLuint lightIndex = static_cast<GLuint>(gpuLights.size());
+        gpuLights.push_back({glm::vec4(light.position, range), glm::vec4(light.color, 1.0f), glm::vec4(light.attenuation, 0.0f)});
+
+        for (unsigned int z = minZ; z <= maxZ; z++)
+        {
+            for (unsigned int y = minY; y <= maxY; y++)
+            {
+                for (unsigned int x = minX; x <= maxX; x++)
+                {
+                    unsigned int clusterIndex = x + CLUSTERS_X * (y + CLUSTERS_Y * z);
+                    const ClusterBounds &bounds = clusterBounds[clusterIndex];
+
+                    glm::vec3 closest = glm::clamp(center, bounds.min, bounds.max);
+                    glm::vec3 offset = closest - center;
+                    if (glm::dot(offset, offset) <= range * range)
+                        assignments.push_back(glm::uvec2(clusterIndex, lightIndex));
+                }
+            }
+        }
+    }
+
+    // counting sort of the (cluster, light) pairs into one compact index list
+    std::fill(clusterRanges.begin(), clusterRanges.end(), glm::uvec2(0));
+    for (const glm::uvec2 &assignment : assignments)
+        clusterRanges[assignment.x].y++;
+
+    GLuint offset = 0;
+    for (glm::uvec2 &range : clusterRanges)
+    {
+        range.x = offset;
+        offset += range.y;
+        range.y = 0;
+    }
+
+    lightIndices.resize(assignments.size());
+    for (const glm::uvec2 &assignment : assignments)
+    {
+        glm::uvec2 &range = clusterRanges[assignment.x];
+        lightIndices[range.x + range.y++] = assignment.y;
+    }
+
+    lightCount = static_cast<unsigned int>(gpuLights.size());
+
+    upload(lightBuffer, LIGHT_BINDING, lightBufferSize, gpuLights.data(), gpuLights.size() * sizeof(GpuLight));
+    upload(clusterBuffer, CLUSTER_BINDING, clusterBufferSize, clusterRanges.data(), clusterRanges.size() * sizeof(glm::uvec2));
+    upload(lightIndexBuffer, LIGHT_INDEX_BINDING, lightIndexBufferSize, lightIndices.data(), lightIndices.size() * sizeof(GLuint));
+}
+
+void ClusteredLighting::upload(GLuint buffer, GLuint binding, size_t &capacity, const void *data, size_t size)
+{
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+
+    // grow with some headroom, so a few more lights do not reallocate every frame
+    if (size > capacity || capacity == 0)
+    {
+        capacity = std::max<size_t>(size + size / 2, 256);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, capacity, nullptr, GL_DYNAMIC_DRAW);
+    }
+    if (size > 0)
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, data);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, buffer);
+}
+
+void ClusteredLighting::setUniforms(Shader *shader) const
+{
+    shader->setUniform("clusterTileSize", glm::vec2(float(renderWidth) / CLUSTERS_X, float(renderHeight) / CLUSTERS_Y));
+    shader->setUniform("clusterNear", zNear);
+    shader->setUniform("clusterFar", zFar);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "../Light.h"
+#include "../Shader.h"
+
+/*!
+ * Clustered forward lighting.
+ * The view frustum is split into a grid of froxels (screen tiles x exponential depth slices).
+ * Every frame the point lights are assigned to the froxels they touch on the CPU and uploaded
+ * into shader storage buffers, so a fragment only loops over the lights of its own cluster.
+ */
+class ClusteredLighting
+{
+public:
+    static constexpr unsigned int CLUSTERS_X = 16;
+    static constexpr unsigned int CLUSTERS_Y = 9;
+    static constexpr unsigned int CLUSTERS_Z = 24;
+
+    // shader storage binding points, must match the layout(binding) in the shaders
+    static constexpr GLuint LIGHT_BINDING = 2;
+    static constexpr GLuint CLUSTER_BINDING = 3;
+    static constexpr GLuint LIGHT_INDEX_BINDING = 4;
+
+    ClusteredLighting(int width, int height);
+    ~ClusteredLighting();
+
+    ClusteredLighting(const ClusteredLighting &) = delete;
+    ClusteredLighting &operator=(const ClusteredLighting &) = delete;
+
+    /*!
+     * Assigns the lights to clusters, uploads light data and light lists and binds the buffers
+     * @param lights: all point lights of the frame, in world space
+     * @param projection: the camera's projection matrix
+     * @param viewProjection: the camera's view projection matrix used for rendering
+     */
+    void update(const std::vector<PointLight> &lights, const glm::mat4 &projection, const glm::mat4 &viewProjection);
+
+    /*!
+     * Sets the uniforms needed to find the cluster of a fragment
+     */
+    void setUniforms(Shader *shader) const;
+
+    /*!
+     * Size of the viewport the scene is rendered into, the froxel grid is spread over it
+     */
+    void setRenderSize(int width, int height)
+    {
+        renderWidth = width;
+        renderHeight = height;
+    }
+
+    unsigned int getLightCount() const { return lightCount; }
+    unsigned int getAssignedLightCount() const { return static_cast<unsigned int>(lightIndices.size()); }
+
+private:
+    /*!
+     * Layout of a light in the shader storage buffer (std430)
+     */
+    struct GpuLight
+    {
+        glm::vec4 positionRange;
+        glm::vec4 color;
+        glm::vec4 attenuation;
+    };
+
+    struct ClusterBounds
+    {
+        glm::vec3 min;
+        glm::vec3 max;
+    };
+
+    int width, height;
+    int renderWidth, renderHeight;
+    float zNear = 0.0f, zFar = 0.0f;
+    glm::mat4 clusterProjection = glm::mat4(0.0f);
+
+    GLuint lightBuffer = 0, clusterBuffer = 0, lightIndexBuffer = 0;
+    size_t lightBufferSize = 0, clusterBufferSize = 0, lightIndexBufferSize = 0;
+    unsigned int lightCount = 0;
+
+    // view space bounds of every cluster, rebuilt when the projection changes
+    std::vector<ClusterBounds> clusterBounds;
+
+    std::vector<GpuLight> gpuLights;
+    std::vector<glm::uvec2> clusterRanges;
+    std::vector<GLuint> lightIndices;
+    std::vector<glm::uvec2> assignments;
+
+    void buildClusterBounds(const glm::mat4 &projection);
+    float sliceDepth(unsigned int slice) const;
+    unsigned int depthToSlice(float depth) const;
+    static void upload(GLuint buffer, GLuint binding, size_t &capacity, const void *data, size_t size);
+};
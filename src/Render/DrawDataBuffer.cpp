@@ -0,0 +1,154 @@
+#include "DrawDataBuffer.h"
+#include "SceneDrawLists.h"
+#include "../Geometry.h"
+#include "../Log.h"
+#include <algorithm>
+#include <cstring>
+
+static_assert(sizeof(DrawDataBuffer::DrawRecord) == 128, "DrawRecord must match the std140 DrawData block");
+
+DrawDataBuffer::DrawDataBuffer(size_t capacity)
+{
+    create(capacity);
+}
+
+DrawDataBuffer::~DrawDataBuffer()
+{
+    destroy();
+}
+
+void DrawDataBuffer::create(size_t newCapacity)
+{
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    stride = (sizeof(DrawRecord) + alignment - 1) / alignment * alignment;
+    capacity = std::max<size_t>(newCapacity, 64);
+
+    GLsizeiptr size = static_cast<GLsizeiptr>(stride * capacity * FRAMES);
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+
+    persistent = GLEW_ARB_buffer_storage != 0;
+    if (persistent)
+    {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_UNIFORM_BUFFER, size, nullptr, flags);
+        mapped = static_cast<char *>(glMapBufferRange(GL_UNIFORM_BUFFER, 0, size, flags));
+        persistent = mapped != nullptr;
+    }
+    if (!persistent)
+    {
+        // without buffer storage every frame maps its own region unsynchronized, the fences still apply
+        glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+        mapped = nullptr;
+    }
+
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void DrawDataBuffer::destroy()
+{
+    for (GLsync &fence : fences)
+        wait(fence);
+
+    if (persistent)
+    {
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+        glUnmapBuffer(GL_UNIFORM_BUFFER);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+    glDeleteBuffers(1, &buffer);
+    buffer = 0;
+    mapped = nullptr;
+}
+
+void DrawDataBuffer::wait(GLsync &fence)
+{
+    if (!fence)
+        return;
+
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+    while (result == GL_TIMEOUT_EXPIRED)
+        result = glClientWaitSync(fence, 0, 1000000000);
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void DrawDataBuffer::update(const SceneDrawLists &drawLists)
+{
+    const auto &visible = drawLists.getVisible();
+    if (visible.size() > capacity)
+    {
+        destroy();
+        create(visible.size() + visible.size() / 2);
+    }
+
+    frame = (frame + 1) % FRAMES;
+    wait(fences[frame]);
+
+    size_t regionOffset = stride * capacity * frame;
+    char *region;
+    bool regionMapped = false;
+    if (persistent)
+    {
+        region = mapped + regionOffset;
+    }
+    else
+    {
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+        region = static_cast<char *>(glMapBufferRange(GL_UNIFORM_BUFFER, regionOffset, stride * capacity,
+                                                      GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+        regionMapped = region != nullptr;
+        if (!regionMapped)
+        {
+            // the records are uploaded with glBufferSubData below, draws never see a stale region
+            static bool reported = false;
+            if (!reported)
+                LOG_WARN(Log::RENDER, "mapping the draw data buffer failed, uploading with glBufferSubData");
+            reported = true;
+            staging.resize(stride * visible.size());
+            region = staging.data();
+        }
+    }
+
+    drawCount = 0;
+    for (const SceneDrawLists::DrawItem &item : visible)
+    {
+        Geometry *geometry = item.geometry;
+
+        DrawRecord record;
+        record.modelMatrix = geometry->getModelMatrix();
+        glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(record.modelMatrix)));
+        for (int i = 0; i < 3; i++)
+            record.normalMatrix[i] = glm::vec4(normalMatrix[i], 0.0f);
+
+        record.materialIndex = item.material ? item.material->getMaterialIndex() : 0;
+
+        size_t offset = stride * drawCount;
+        std::memcpy(region + offset, &record, sizeof(DrawRecord));
+        geometry->setDrawData(buffer, static_cast<GLintptr>(regionOffset + offset), sizeof(DrawRecord));
+        drawCount++;
+    }
+
+    if (!persistent)
+    {
+        if (regionMapped)
+            glUnmapBuffer(GL_UNIFORM_BUFFER);
+        else if (drawCount > 0)
+            glBufferSubData(GL_UNIFORM_BUFFER, static_cast<GLintptr>(regionOffset), static_cast<GLsizeiptr>(stride * drawCount), staging.data());
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+}
+
+void DrawDataBuffer::endFrame()
+{
+    fences[frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void DrawDataBuffer::bindProgram(GLuint program)
+{
+    GLuint index = glGetUniformBlockIndex(program, "DrawData");
+    if (index != GL_INVALID_INDEX)
+        glUniformBlockBinding(program, index, BINDING);
+}
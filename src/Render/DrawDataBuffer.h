@@ -0,0 +1,73 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+class SceneDrawLists;
+
+/*!
+ * Per-draw values (model/normal matrix, MaterialTable row) of a frame.
+ * All records are written in one linear pass into a triple-buffered ring that stays
+ * persistently mapped (ARB_buffer_storage), every draw then only binds its record with
+ * glBindBufferRange instead of setting the values as uniforms. A fence per frame keeps the
+ * CPU from overwriting a region the GPU still reads.
+ */
+class DrawDataBuffer
+{
+public:
+    // uniform block binding point, PreprocessedShader binds the DrawData block to it
+    static constexpr GLuint BINDING = 0;
+    static constexpr int FRAMES = 3;
+
+    /*!
+     * Layout of the DrawData uniform block (std140), see include/drawData.glsl
+     */
+    struct DrawRecord
+    {
+        glm::mat4 modelMatrix;
+        glm::vec4 normalMatrix[3];
+        GLuint materialIndex;
+        GLuint padding[3];
+    };
+
+    explicit DrawDataBuffer(size_t capacity = 1024);
+    ~DrawDataBuffer();
+
+    DrawDataBuffer(const DrawDataBuffer &) = delete;
+    DrawDataBuffer &operator=(const DrawDataBuffer &) = delete;
+
+    /*!
+     * Writes the records of all objects visible in the current draw lists and hands every
+     * geometry the offset of its record
+     */
+    void update(const SceneDrawLists &drawLists);
+
+    /*!
+     * Fences the frame's region, call after the last draw that uses it
+     */
+    void endFrame();
+
+    /*!
+     * Points the DrawData block of a linked program at BINDING
+     */
+    static void bindProgram(GLuint program);
+
+    bool isPersistent() const { return persistent; }
+    size_t getDrawCount() const { return drawCount; }
+
+private:
+    GLuint buffer = 0;
+    bool persistent = false;
+    char *mapped = nullptr;
+    size_t capacity = 0, stride = 0, drawCount = 0;
+    int frame = 0;
+    GLsync fences[FRAMES] = {};
+    // records of a frame whose region could not be mapped
+    std::vector<char> staging;
+
+    void create(size_t capacity);
+    void destroy();
+    void wait(GLsync &fence);
+};
@@ -0,0 +1,88 @@
+#include "DynamicResolution.h"
+#include <algorithm>
+#include <cmath>
+
+DynamicResolution::DynamicResolution()
+{
+    glGenQueries(QUERY_COUNT * 2, &queries[0][0]);
+}
+
+DynamicResolution::~DynamicResolution()
+{
+    glDeleteQueries(QUERY_COUNT * 2, &queries[0][0]);
+}
+
+void DynamicResolution::configure(float targetMilliseconds, float minScale, float maxScale)
+{
+    this->targetMilliseconds = std::max(targetMilliseconds, 1.0f);
+    this->maxScale = std::clamp(maxScale, 0.25f, 1.0f);
+    this->minScale = std::clamp(minScale, 0.25f, this->maxScale);
+    scale = std::clamp(scale, this->minScale, this->maxScale);
+}
+
+void DynamicResolution::setEnabled(bool enabled)
+{
+    this->enabled = enabled;
+    scale = maxScale;
+}
+
+void DynamicResolution::beginFrame()
+{
+    // a slot that is still in flight after QUERY_COUNT frames is skipped instead of waited on
+    if (pending[current])
+        return;
+
+    glQueryCounter(queries[current][0], GL_TIMESTAMP);
+}
+
+void DynamicResolution::endFrame()
+{
+    if (!pending[current])
+    {
+        glQueryCounter(queries[current][1], GL_TIMESTAMP);
+        pending[current] = true;
+    }
+    current = (current + 1) % QUERY_COUNT;
+
+    // newest finished frame wins, older ones are only drained
+    bool measured = false;
+    for (int i = 0; i < QUERY_COUNT; ++i)
+        measured |= collect((current + i) % QUERY_COUNT);
+
+    if (measured && enabled)
+        adjust();
+}
+
+bool DynamicResolution::collect(int index)
+{
+    if (!pending[index])
+        return false;
+
+    GLint available = 0;
+    glGetQueryObjectiv(queries[index][1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+        return false;
+
+    GLuint64 begin = 0, end = 0;
+    glGetQueryObjectui64v(queries[index][0], GL_QUERY_RESULT, &begin);
+    glGetQueryObjectui64v(queries[index][1], GL_QUERY_RESULT, &end);
+    pending[index] = false;
+
+    float sample = static_cast<float>(end - begin) / 1000000.0f;
+    gpuMilliseconds = gpuMilliseconds == 0.0f ? sample : gpuMilliseconds + (sample - gpuMilliseconds) * 0.2f;
+    return true;
+}
+
+void DynamicResolution::adjust()
+{
+    if (gpuMilliseconds <= 0.0f)
+        return;
+
+    // within a few percent of the target the scale is left alone, otherwise it would never settle
+    float ratio = targetMilliseconds / gpuMilliseconds;
+    if (ratio > 0.95f && ratio < 1.05f)
+        return;
+
+    float desired = scale * std::sqrt(ratio);
+    scale = std::clamp(scale + (desired - scale) * 0.1f, minScale, maxScale);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <GL/glew.h>
+
+/*!
+ * Picks the internal render scale from the measured GPU frame time.
+ * The frame is bracketed by GL_TIMESTAMP queries (these, unlike GL_TIME_ELAPSED, may enclose
+ * the pass timers), results are read a few frames late and the scale is steered towards the
+ * target frame time. Render cost is roughly proportional to the pixel count, so the scale
+ * follows the square root of the time ratio.
+ */
+class DynamicResolution
+{
+public:
+    DynamicResolution();
+    ~DynamicResolution();
+
+    DynamicResolution(const DynamicResolution &) = delete;
+    DynamicResolution &operator=(const DynamicResolution &) = delete;
+
+    /*!
+     * @param targetMilliseconds: GPU time the frame should fit into
+     * @param minScale, maxScale: bounds of the render scale, maxScale is at most 1
+     */
+    void configure(float targetMilliseconds, float minScale, float maxScale);
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled; }
+
+    void beginFrame();
+    /*!
+     * Closes the frame's measurement and updates the scale from the newest finished frame
+     */
+    void endFrame();
+
+    /*!
+     * @return the fraction of the full resolution to render at this frame, 1 while disabled
+     */
+    float getScale() const { return enabled ? scale : 1.0f; }
+    float getGpuMilliseconds() const { return gpuMilliseconds; }
+    float getTargetMilliseconds() const { return targetMilliseconds; }
+
+private:
+    static constexpr int QUERY_COUNT = 4;
+
+    GLuint queries[QUERY_COUNT][2];
+    bool pending[QUERY_COUNT] = {};
+    int current = 0;
+
+    bool enabled = false;
+    float scale = 1.0f;
+    float minScale = 0.5f, maxScale = 1.0f;
+    float targetMilliseconds = 16.0f;
+    float gpuMilliseconds = 0.0f;
+
+    bool collect(int index);
+    void adjust();
+};
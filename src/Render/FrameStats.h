@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+
+/*!
+ * Per-frame numbers shown in the performance overlay
+ */
+struct FrameStats
+{
+    float fps = 0.0f;
+    float frameMs = 0.0f;
+
+    // input poll to GPU completion, see FramePacer
+    float latencyMs = 0.0f;
+    const char *vsync = "on";
+    int fpsLimit = 0;
+    bool lowLatency = false;
+
+    bool depthPrepassEnabled = false;
+    float depthPrepassMs = 0.0f;
+    float colorPassMs = 0.0f;
+
+    // last measured color pass time of each mode, used to estimate what the pre-pass saves
+    float colorPassMsWithPrepass = 0.0f;
+    float colorPassMsWithoutPrepass = 0.0f;
+
+    // visible point lights and their total number of cluster entries
+    unsigned int lightCount = 0;
+    unsigned int lightAssignments = 0;
+
+    // per-draw records written this frame and whether the ring buffer is persistently mapped
+    unsigned int drawRecords = 0;
+    bool drawDataPersistent = false;
+    // how often a cached draw list was rebuilt since startup, stays flat while nothing changes
+    unsigned int drawListRebuilds = 0;
+
+    // last batch of gameplay raycasts, sweeps and overlaps
+    unsigned int sceneQueries = 0;
+    float sceneQueryMs = 0.0f;
+
+    // software occlusion culling: rasterized occluders and the fate of the tested draw items
+    bool occlusionCulling = false;
+    unsigned int occluders = 0;
+    unsigned int occluderTriangles = 0;
+    unsigned int occlusionTested = 0;
+    unsigned int occlusionCulled = 0;
+    unsigned int outsideView = 0;
+    float occlusionMs = 0.0f;
+
+    // size of the last saved or restored checkpoint and how long that took
+    unsigned int checkpointBytes = 0;
+    float checkpointMs = 0.0f;
+
+    // render graph passes and the memory of its transient targets with and without aliasing
+    int graphPasses = 0;
+    int graphCulledPasses = 0;
+    int renderTargets = 0;
+    size_t renderTargetBytes = 0;
+    size_t renderTargetBytesUnaliased = 0;
+
+    const char *antialiasing = "off";
+    int msaaSamples = 0;
+
+    // internal render size and the GPU frame time the dynamic resolution controller sees
+    bool dynamicResolution = false;
+    int renderWidth = 0;
+    int renderHeight = 0;
+    float gpuFrameMs = 0.0f;
+    float targetFrameMs = 0.0f;
+};
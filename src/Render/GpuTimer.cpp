@@ -0,0 +1,54 @@
+#include "GpuTimer.h"
+
+GpuTimer::GpuTimer()
+{
+    glGenQueries(QUERY_COUNT, queries);
+}
+
+GpuTimer::~GpuTimer()
+{
+    glDeleteQueries(QUERY_COUNT, queries);
+}
+
+void GpuTimer::begin()
+{
+    // pick up every result that is already available, oldest first
+    for (int i = 0; i < QUERY_COUNT; ++i)
+    {
+        collect((current + i) % QUERY_COUNT, false);
+    }
+
+    // the slot we are about to reuse is QUERY_COUNT frames old, this only waits if the GPU is far behind
+    collect(current, true);
+
+    glBeginQuery(GL_TIME_ELAPSED, queries[current]);
+}
+
+void GpuTimer::end()
+{
+    glEndQuery(GL_TIME_ELAPSED);
+    pending[current] = true;
+    current = (current + 1) % QUERY_COUNT;
+}
+
+void GpuTimer::collect(int index, bool wait)
+{
+    if (!pending[index])
+        return;
+
+    if (!wait)
+    {
+        GLint available = 0;
+        glGetQueryObjectiv(queries[index], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            return;
+    }
+
+    GLuint64 elapsed = 0;
+    glGetQueryObjectui64v(queries[index], GL_QUERY_RESULT, &elapsed);
+    pending[index] = false;
+
+    // exponential smoothing keeps the overlay readable
+    float sample = static_cast<float>(elapsed) / 1000000.0f;
+    milliseconds = milliseconds == 0.0f ? sample : milliseconds + (sample - milliseconds) * 0.1f;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <GL/glew.h>
+
+/*!
+ * Measures the GPU time of a range of commands with GL_TIME_ELAPSED queries.
+ * Results are read back a few frames late, so the CPU never waits for the GPU.
+ */
+class GpuTimer
+{
+public:
+    GpuTimer();
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer &) = delete;
+    GpuTimer &operator=(const GpuTimer &) = delete;
+
+    void begin();
+    void end();
+
+    /*!
+     * @return the smoothed GPU time of the measured range in milliseconds
+     */
+    float getMilliseconds() const { return milliseconds; }
+
+private:
+    static constexpr int QUERY_COUNT = 4;
+
+    GLuint queries[QUERY_COUNT];
+    bool pending[QUERY_COUNT] = {};
+    int current = 0;
+    float milliseconds = 0.0f;
+
+    void collect(int index, bool wait);
+};
@@ -0,0 +1,187 @@
+#include "MaterialTable.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+MaterialTable::MaterialTable(bool allowBindless)
+{
+    bindless = allowBindless && GLEW_ARB_bindless_texture != 0;
+    glGenBuffers(1, &buffer);
+}
+
+MaterialTable::~MaterialTable()
+{
+    for (GLuint64 handle : residentHandles)
+        glMakeTextureHandleNonResidentARB(handle);
+    for (Bucket &bucket : buckets)
+        glDeleteTextures(1, &bucket.array);
+    glDeleteBuffers(1, &buffer);
+}
+
+void MaterialTable::add(const std::shared_ptr<Material> &material)
+{
+    material->setMaterialIndex(static_cast<unsigned int>(materials.size()));
+    materials.push_back(material);
+}
+
+MaterialTable::TextureFormat MaterialTable::queryFormat(GLuint texture)
+{
+    TextureFormat format;
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &format.width);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &format.height);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &format.internalFormat);
+
+    // DDS files do not always carry a full mip chain
+    int maxLevels = 1 + static_cast<int>(std::log2(std::max(format.width, format.height)));
+    while (format.levels < maxLevels)
+    {
+        GLint levelWidth = 0;
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, format.levels, GL_TEXTURE_WIDTH, &levelWidth);
+        if (levelWidth == 0)
+            break;
+        format.levels++;
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return format;
+}
+
+glm::uvec2 MaterialTable::addTexture(const std::shared_ptr<Texture> &texture)
+{
+    if (!texture || !texture->isValid())
+        return glm::uvec2(TEXTURE_NONE);
+
+    TextureFormat format = queryFormat(texture->getID());
+    auto bucket = std::find_if(buckets.begin(), buckets.end(), [&](const Bucket &b)
+                               { return b.format == format; });
+    if (bucket == buckets.end())
+    {
+        if (buckets.size() == MAX_BUCKETS)
+        {
+            std::cerr << "MaterialTable: more than " << MAX_BUCKETS << " texture sizes, texture " << texture->getID() << " dropped" << std::endl;
+            return glm::uvec2(TEXTURE_NONE);
+        }
+        buckets.push_back(Bucket{format, {}, 0});
+        bucket = buckets.end() - 1;
+    }
+
+    // materials sharing a texture share its layer
+    auto source = std::find(bucket->sources.begin(), bucket->sources.end(), texture->getID());
+    if (source == bucket->sources.end())
+    {
+        bucket->sources.push_back(texture->getID());
+        source = bucket->sources.end() - 1;
+    }
+
+    return glm::uvec2(static_cast<GLuint>(bucket - buckets.begin()),
+                      static_cast<GLuint>(source - bucket->sources.begin()));
+}
+
+glm::uvec2 MaterialTable::makeResident(const std::shared_ptr<Texture> &texture)
+{
+    if (!texture || !texture->isValid())
+        return glm::uvec2(0);
+
+    GLuint64 handle = glGetTextureHandleARB(texture->getID());
+    if (std::find(residentHandles.begin(), residentHandles.end(), handle) == residentHandles.end())
+    {
+        glMakeTextureHandleResidentARB(handle);
+        residentHandles.push_back(handle);
+    }
+    return glm::uvec2(static_cast<GLuint>(handle & 0xFFFFFFFFu), static_cast<GLuint>(handle >> 32));
+}
+
+void MaterialTable::build()
+{
+    std::vector<GpuMaterial> rows;
+    rows.reserve(materials.size());
+
+    for (const auto &material : materials)
+    {
+        GpuMaterial row;
+        row.colorAlpha = glm::vec4(material->getColor(), material->getAlpha());
+        row.coefficients = glm::vec4(material->getCoefficients(), 0.0f);
+        row.textureLayers = glm::uvec4(TEXTURE_NONE);
+        row.textureHandles = glm::uvec4(0);
+
+        if (auto textureMaterial = std::dynamic_pointer_cast<TextureMaterial>(material))
+        {
+            std::shared_ptr<Texture> diffuse = textureMaterial->getDiffuseTexture();
+            std::shared_ptr<Texture> normal = textureMaterial->getNormalTexture();
+            if (bindless)
+            {
+                row.textureHandles = glm::uvec4(makeResident(diffuse), makeResident(normal));
+                row.textureLayers = glm::uvec4(0, diffuse ? 0 : TEXTURE_NONE, 0, normal ? 0 : TEXTURE_NONE);
+            }
+            else
+            {
+                row.textureLayers = glm::uvec4(addTexture(diffuse), addTexture(normal));
+            }
+        }
+        rows.push_back(row);
+    }
+
+    // copy every source texture into its bucket's array, mip level by mip level
+    for (Bucket &bucket : buckets)
+    {
+        const TextureFormat &format = bucket.format;
+        glGenTextures(1, &bucket.array);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, bucket.array);
+        glTexStorage3D(GL_TEXTURE_2D_ARRAY, format.levels, format.internalFormat,
+                       format.width, format.height, static_cast<GLsizei>(bucket.sources.size()));
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, format.levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+        for (size_t layer = 0; layer < bucket.sources.size(); layer++)
+        {
+            for (GLint level = 0; level < format.levels; level++)
+            {
+                GLsizei w = std::max(format.width >> level, 1);
+                GLsizei h = std::max(format.height >> level, 1);
+                glCopyImageSubData(bucket.sources[layer], GL_TEXTURE_2D, level, 0, 0, 0,
+                                   bucket.array, GL_TEXTURE_2D_ARRAY, level, 0, 0, static_cast<GLint>(layer),
+                                   w, h, 1);
+            }
+        }
+
+        std::cout << "Material texture array " << format.width << "x" << format.height
+                  << ", " << format.levels << " levels, " << bucket.sources.size() << " layers" << std::endl;
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, std::max<size_t>(rows.size(), 1) * sizeof(GpuMaterial), rows.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    // the arrays hold their own copies now, the per-material textures can go
+    if (!bindless)
+    {
+        for (const auto &material : materials)
+        {
+            if (auto textureMaterial = std::dynamic_pointer_cast<TextureMaterial>(material))
+                textureMaterial->releaseTextures();
+        }
+    }
+}
+
+void MaterialTable::bind() const
+{
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BINDING, buffer);
+    for (size_t i = 0; i < buckets.size(); i++)
+    {
+        glActiveTexture(GL_TEXTURE0 + FIRST_ARRAY_UNIT + static_cast<GLuint>(i));
+        glBindTexture(GL_TEXTURE_2D_ARRAY, buckets[i].array);
+    }
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void MaterialTable::setUniforms(Shader *shader) const
+{
+    if (bindless)
+        return;
+
+    for (unsigned int i = 0; i < MAX_BUCKETS; i++)
+        shader->setUniform("materialTextureArrays[" + std::to_string(i) + "]", static_cast<int>(FIRST_ARRAY_UNIT + i));
+}
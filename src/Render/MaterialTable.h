@@ -0,0 +1,97 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+#include "../Material.h"
+#include "../Shader.h"
+
+/*!
+ * GPU-resident table of all material parameters, indexed per draw through DrawData.materialIndex.
+ * Diffuse and normal maps are copied into GL_TEXTURE_2D_ARRAYs bucketed by size, format and
+ * mip count, or referenced by bindless handle when ARB_bindless_texture is available, so
+ * switching materials between draws needs no uniform or texture binding changes.
+ */
+class MaterialTable
+{
+public:
+    // shader storage binding point, must match include/materials.glsl
+    static constexpr GLuint BINDING = 5;
+    // texture arrays are bound to consecutive units starting here
+    static constexpr GLuint FIRST_ARRAY_UNIT = 8;
+    static constexpr unsigned int MAX_BUCKETS = 8;
+    static constexpr GLuint TEXTURE_NONE = 0xFFFFFFFFu;
+
+    /*!
+     * @param allowBindless: use bindless handles instead of texture arrays if the driver supports them
+     */
+    explicit MaterialTable(bool allowBindless);
+    ~MaterialTable();
+
+    MaterialTable(const MaterialTable &) = delete;
+    MaterialTable &operator=(const MaterialTable &) = delete;
+
+    /*!
+     * Gives the material its row, call for every material before build()
+     */
+    void add(const std::shared_ptr<Material> &material);
+
+    /*!
+     * Packs the textures and uploads the table
+     */
+    void build();
+
+    /*!
+     * Binds the table and the texture arrays
+     */
+    void bind() const;
+
+    /*!
+     * Points the shader's texture array samplers at their units
+     */
+    void setUniforms(Shader *shader) const;
+
+    bool usesBindlessTextures() const { return bindless; }
+    size_t getMaterialCount() const { return materials.size(); }
+    size_t getBucketCount() const { return buckets.size(); }
+
+private:
+    /*!
+     * Layout of a row in the shader storage buffer (std430)
+     */
+    struct GpuMaterial
+    {
+        glm::vec4 colorAlpha;
+        glm::vec4 coefficients;
+        glm::uvec4 textureLayers;
+        glm::uvec4 textureHandles;
+    };
+
+    struct TextureFormat
+    {
+        GLint width = 0, height = 0, internalFormat = 0, levels = 0;
+        bool operator==(const TextureFormat &other) const
+        {
+            return width == other.width && height == other.height &&
+                   internalFormat == other.internalFormat && levels == other.levels;
+        }
+    };
+
+    struct Bucket
+    {
+        TextureFormat format;
+        std::vector<GLuint> sources;
+        GLuint array = 0;
+    };
+
+    std::vector<std::shared_ptr<Material>> materials;
+    std::vector<Bucket> buckets;
+    std::vector<GLuint64> residentHandles;
+    GLuint buffer = 0;
+    bool bindless = false;
+
+    glm::uvec2 addTexture(const std::shared_ptr<Texture> &texture);
+    glm::uvec2 makeResident(const std::shared_ptr<Texture> &texture);
+    static TextureFormat queryFormat(GLuint texture);
+};
@@ -0,0 +1,378 @@
+#include "OcclusionCuller.h"
+#include "../RenderObject.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <execution>
+#include <immintrin.h>
+#include <numeric>
+
+// lane width of the rasterizer, the buffer width is a multiple of TILE_SIZE so a row never ends mid vector
+#if defined(__AVX2__)
+using SimdFloat = __m256;
+static constexpr int LANES = 8;
+static inline SimdFloat simdSet(float value) { return _mm256_set1_ps(value); }
+static inline SimdFloat simdLanes() { return _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f); }
+static inline SimdFloat simdAdd(SimdFloat a, SimdFloat b) { return _mm256_add_ps(a, b); }
+static inline SimdFloat simdMul(SimdFloat a, SimdFloat b) { return _mm256_mul_ps(a, b); }
+static inline SimdFloat simdMin(SimdFloat a, SimdFloat b) { return _mm256_min_ps(a, b); }
+static inline SimdFloat simdInside(SimdFloat e0, SimdFloat e1, SimdFloat e2)
+{
+    SimdFloat zero = _mm256_setzero_ps();
+    return _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(e0, zero, _CMP_GE_OQ), _mm256_cmp_ps(e1, zero, _CMP_GE_OQ)),
+                         _mm256_cmp_ps(e2, zero, _CMP_GE_OQ));
+}
+static inline bool simdAny(SimdFloat mask) { return _mm256_movemask_ps(mask) != 0; }
+static inline SimdFloat simdSelect(SimdFloat mask, SimdFloat a, SimdFloat b) { return _mm256_blendv_ps(b, a, mask); }
+static inline SimdFloat simdLoad(const float *p) { return _mm256_loadu_ps(p); }
+static inline void simdStore(float *p, SimdFloat v) { _mm256_storeu_ps(p, v); }
+#else
+using SimdFloat = __m128;
+static constexpr int LANES = 4;
+static inline SimdFloat simdSet(float value) { return _mm_set1_ps(value); }
+static inline SimdFloat simdLanes() { return _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f); }
+static inline SimdFloat simdAdd(SimdFloat a, SimdFloat b) { return _mm_add_ps(a, b); }
+static inline SimdFloat simdMul(SimdFloat a, SimdFloat b) { return _mm_mul_ps(a, b); }
+static inline SimdFloat simdMin(SimdFloat a, SimdFloat b) { return _mm_min_ps(a, b); }
+static inline SimdFloat simdInside(SimdFloat e0, SimdFloat e1, SimdFloat e2)
+{
+    SimdFloat zero = _mm_setzero_ps();
+    return _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+}
+static inline bool simdAny(SimdFloat mask) { return _mm_movemask_ps(mask) != 0; }
+static inline SimdFloat simdSelect(SimdFloat mask, SimdFloat a, SimdFloat b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+static inline SimdFloat simdLoad(const float *p) { return _mm_loadu_ps(p); }
+static inline void simdStore(float *p, SimdFloat v) { _mm_storeu_ps(p, v); }
+#endif
+
+static_assert(OcclusionCuller::TILE_SIZE % LANES == 0, "rows must hold whole SIMD vectors");
+
+// clip space w below this counts as crossing the near plane
+static constexpr float NEAR_W = 1e-3f;
+
+OcclusionCuller::OcclusionCuller(int width, float aspectRatio)
+{
+    tilesX = std::max(1, (width + TILE_SIZE - 1) / TILE_SIZE);
+    tilesY = std::max(1, static_cast<int>(std::ceil(tilesX * TILE_SIZE / aspectRatio / TILE_SIZE)));
+    this->width = tilesX * TILE_SIZE;
+    height = tilesY * TILE_SIZE;
+    depth.resize(static_cast<size_t>(this->width) * height);
+    tileMaxDepth.resize(static_cast<size_t>(tilesX) * tilesY);
+}
+
+void OcclusionCuller::addOccluder(RenderObject *object, unsigned int maxTriangles)
+{
+    const GeometryData &data = object->geometry->getGeometryData();
+
+    Occluder occluder;
+    occluder.object = object;
+    simplify(data.positions, data.indices, maxTriangles, occluder.positions, occluder.indices);
+    occluders.push_back(std::move(occluder));
+}
+
+void OcclusionCuller::simplify(const std::vector<glm::vec3> &positions, const std::vector<unsigned int> &indices, unsigned int maxTriangles,
+                               std::vector<glm::vec3> &outPositions, std::vector<unsigned int> &outIndices)
+{
+    if (indices.size() / 3 <= maxTriangles || positions.empty())
+    {
+        outPositions = positions;
+        outIndices = indices;
+        return;
+    }
+
+    // a subset of the surface can only hide less than the surface itself: the largest triangles
+    // stay as they are and the rest is dropped. Moving or merging vertices (clustering, edge
+    // collapses) could grow the occluder past the mesh or close its gaps and cull visible objects
+    size_t triangleCount = indices.size() / 3;
+    std::vector<float> areas(triangleCount);
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        const glm::vec3 &a = positions[indices[t * 3]];
+        areas[t] = glm::length(glm::cross(positions[indices[t * 3 + 1]] - a, positions[indices[t * 3 + 2]] - a));
+    }
+
+    std::vector<unsigned int> kept(triangleCount);
+    std::iota(kept.begin(), kept.end(), 0u);
+    std::nth_element(kept.begin(), kept.begin() + maxTriangles, kept.end(), [&](unsigned int a, unsigned int b)
+                     { return areas[a] > areas[b]; });
+    kept.resize(maxTriangles);
+    std::sort(kept.begin(), kept.end());
+
+    std::vector<unsigned int> remap(positions.size(), ~0u);
+    outPositions.clear();
+    outIndices.clear();
+    for (unsigned int t : kept)
+    {
+        for (int v = 0; v < 3; v++)
+        {
+            unsigned int &index = remap[indices[t * 3 + v]];
+            if (index == ~0u)
+            {
+                index = static_cast<unsigned int>(outPositions.size());
+                outPositions.push_back(positions[indices[t * 3 + v]]);
+            }
+            outIndices.push_back(index);
+        }
+    }
+}
+
+void OcclusionCuller::cull(SceneDrawLists &drawLists, uint32_t worldMask, const glm::mat4 &viewProjection)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    setupTriangles(worldMask, viewProjection);
+
+    // bands of tile rows are independent, each worker walks all triangles clipped to its band
+    std::vector<int> tileRows(tilesY);
+    std::iota(tileRows.begin(), tileRows.end(), 0);
+    std::for_each(std::execution::par, tileRows.begin(), tileRows.end(), [this](int tileRow)
+                  {
+                      rasterizeBand(tileRow * TILE_SIZE, tileRow * TILE_SIZE + TILE_SIZE - 1);
+                      buildTiles(tileRow, tileRow);
+                  });
+
+    stats.tested = stats.occluded = stats.outsideView = 0;
+    drawLists.markOccluded([&](const SceneDrawLists::DrawItem &item)
+                           {
+                               stats.tested++;
+                               bool outside = false;
+                               bool occluded = isOccluded(item.geometry, viewProjection, outside);
+                               if (outside)
+                                   stats.outsideView++;
+                               else if (occluded)
+                                   stats.occluded++;
+                               return occluded;
+                           });
+
+    stats.milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void OcclusionCuller::setupTriangles(uint32_t worldMask, const glm::mat4 &viewProjection)
+{
+    triangles.clear();
+    stats.occluders = stats.occluderTriangles = 0;
+
+    for (const Occluder &occluder : occluders)
+    {
+        Geometry *geometry = occluder.object->geometry.get();
+        if (!occluder.object->isRendered || (geometry->getWorldMask() & worldMask) == 0)
+            continue;
+
+        stats.occluders++;
+        glm::mat4 modelViewProjection = viewProjection * geometry->getModelMatrix();
+        std::vector<glm::vec4> clip(occluder.positions.size());
+        for (size_t i = 0; i < clip.size(); i++)
+            clip[i] = modelViewProjection * glm::vec4(occluder.positions[i], 1.0f);
+
+        for (size_t i = 0; i + 2 < occluder.indices.size(); i += 3)
+        {
+            glm::vec4 vertices[3] = {clip[occluder.indices[i]], clip[occluder.indices[i + 1]], clip[occluder.indices[i + 2]]};
+            int behind = (vertices[0].w < NEAR_W) + (vertices[1].w < NEAR_W) + (vertices[2].w < NEAR_W);
+            if (behind == 3)
+                continue;
+            if (behind == 0)
+            {
+                addTriangle(vertices);
+                continue;
+            }
+
+            // clip against the near plane, one or two triangles remain
+            glm::vec4 polygon[4];
+            int count = 0;
+            for (int v = 0; v < 3; v++)
+            {
+                const glm::vec4 &a = vertices[v], &b = vertices[(v + 1) % 3];
+                if (a.w >= NEAR_W)
+                    polygon[count++] = a;
+                if ((a.w >= NEAR_W) != (b.w >= NEAR_W))
+                    polygon[count++] = glm::mix(a, b, (NEAR_W - a.w) / (b.w - a.w));
+            }
+            for (int v = 1; v + 1 < count; v++)
+            {
+                glm::vec4 fan[3] = {polygon[0], polygon[v], polygon[v + 1]};
+                addTriangle(fan);
+            }
+        }
+    }
+    stats.occluderTriangles = static_cast<unsigned int>(triangles.size());
+
+    std::fill(depth.begin(), depth.end(), 1.0f);
+}
+
+void OcclusionCuller::addTriangle(const glm::vec4 clip[3])
+{
+    // depth buffer pixels with their centers at +0.5, depth is NDC z which is affine in screen space
+    glm::vec3 screen[3];
+    for (int i = 0; i < 3; i++)
+    {
+        glm::vec3 ndc = glm::vec3(clip[i]) / clip[i].w;
+        screen[i] = glm::vec3((ndc.x * 0.5f + 0.5f) * width, (ndc.y * 0.5f + 0.5f) * height, ndc.z);
+    }
+
+    float area = (screen[1].x - screen[0].x) * (screen[2].y - screen[0].y) - (screen[2].x - screen[0].x) * (screen[1].y - screen[0].y);
+    if (std::abs(area) < 1e-6f)
+        return;
+
+    Triangle triangle;
+    float minX = std::min({screen[0].x, screen[1].x, screen[2].x});
+    float maxX = std::max({screen[0].x, screen[1].x, screen[2].x});
+    float minY = std::min({screen[0].y, screen[1].y, screen[2].y});
+    float maxY = std::max({screen[0].y, screen[1].y, screen[2].y});
+    triangle.minX = std::max(0, static_cast<int>(std::floor(minX)));
+    triangle.maxX = std::min(width - 1, static_cast<int>(std::ceil(maxX)));
+    triangle.minY = std::max(0, static_cast<int>(std::floor(minY)));
+    triangle.maxY = std::min(height - 1, static_cast<int>(std::ceil(maxY)));
+    if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+        return;
+
+    // both windings are drawn, the edges are flipped so inside is positive
+    float sign = area > 0.0f ? 1.0f : -1.0f;
+    for (int i = 0; i < 3; i++)
+    {
+        const glm::vec3 &a = screen[i], &b = screen[(i + 1) % 3];
+        triangle.edgeA[i] = (a.y - b.y) * sign;
+        triangle.edgeB[i] = (b.x - a.x) * sign;
+        triangle.edgeC[i] = (a.x * b.y - a.y * b.x) * sign;
+    }
+
+    // z = depthA * x + depthB * y + depthC through the three vertices
+    glm::vec3 e1 = screen[1] - screen[0], e2 = screen[2] - screen[0];
+    triangle.depthA = (e1.z * e2.y - e2.z * e1.y) / area;
+    triangle.depthB = (e2.z * e1.x - e1.z * e2.x) / area;
+    triangle.depthC = screen[0].z - triangle.depthA * screen[0].x - triangle.depthB * screen[0].y;
+
+    triangles.push_back(triangle);
+}
+
+void OcclusionCuller::rasterizeBand(int firstRow, int lastRow)
+{
+    const SimdFloat lanes = simdLanes();
+    const SimdFloat half = simdSet(0.5f);
+
+    for (const Triangle &triangle : triangles)
+    {
+        int minY = std::max(triangle.minY, firstRow), maxY = std::min(triangle.maxY, lastRow);
+        if (minY > maxY)
+            continue;
+
+        int minX = triangle.minX / LANES * LANES;
+        SimdFloat stepX = simdSet(float(LANES));
+        SimdFloat edgeA[3], depthA = simdSet(triangle.depthA);
+        for (int i = 0; i < 3; i++)
+            edgeA[i] = simdSet(triangle.edgeA[i]);
+
+        for (int y = minY; y <= maxY; y++)
+        {
+            float centerY = y + 0.5f;
+            SimdFloat x = simdAdd(simdAdd(simdSet(float(minX)), lanes), half);
+
+            SimdFloat edge[3];
+            for (int i = 0; i < 3; i++)
+                edge[i] = simdAdd(simdMul(edgeA[i], x), simdSet(triangle.edgeB[i] * centerY + triangle.edgeC[i]));
+            SimdFloat z = simdAdd(simdMul(depthA, x), simdSet(triangle.depthB * centerY + triangle.depthC));
+
+            SimdFloat edgeStep[3];
+            for (int i = 0; i < 3; i++)
+                edgeStep[i] = simdMul(edgeA[i], stepX);
+            SimdFloat depthStep = simdMul(depthA, stepX);
+
+            float *row = depth.data() + static_cast<size_t>(y) * width;
+            for (int px = minX; px <= triangle.maxX; px += LANES)
+            {
+                SimdFloat inside = simdInside(edge[0], edge[1], edge[2]);
+                if (simdAny(inside))
+                {
+                    SimdFloat current = simdLoad(row + px);
+                    simdStore(row + px, simdSelect(inside, simdMin(current, z), current));
+                }
+                for (int i = 0; i < 3; i++)
+                    edge[i] = simdAdd(edge[i], edgeStep[i]);
+                z = simdAdd(z, depthStep);
+            }
+        }
+    }
+}
+
+void OcclusionCuller::buildTiles(int firstTileRow, int lastTileRow)
+{
+    for (int tileY = firstTileRow; tileY <= lastTileRow; tileY++)
+    {
+        for (int tileX = 0; tileX < tilesX; tileX++)
+        {
+            float farthest = 0.0f;
+            for (int y = 0; y < TILE_SIZE; y++)
+            {
+                const float *row = depth.data() + static_cast<size_t>(tileY * TILE_SIZE + y) * width + tileX * TILE_SIZE;
+                farthest = std::max(farthest, *std::max_element(row, row + TILE_SIZE));
+            }
+            tileMaxDepth[static_cast<size_t>(tileY) * tilesX + tileX] = farthest;
+        }
+    }
+}
+
+bool OcclusionCuller::isOccluded(Geometry *geometry, const glm::mat4 &viewProjection, bool &outside)
+{
+    outside = false;
+    for (const Occluder &occluder : occluders)
+    {
+        if (occluder.object->geometry.get() == geometry)
+            return false;
+    }
+
+    const Bounds &box = getBounds(geometry);
+    glm::mat4 modelViewProjection = viewProjection * geometry->getModelMatrix();
+
+    glm::vec2 minimum(INFINITY), maximum(-INFINITY);
+    float nearest = INFINITY;
+    for (int corner = 0; corner < 8; corner++)
+    {
+        glm::vec3 position((corner & 1) ? box.max.x : box.min.x, (corner & 2) ? box.max.y : box.min.y, (corner & 4) ? box.max.z : box.min.z);
+        glm::vec4 clip = modelViewProjection * glm::vec4(position, 1.0f);
+
+        // the box reaches behind the camera, it can not be hidden
+        if (clip.w < NEAR_W)
+            return false;
+
+        glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        minimum = glm::min(minimum, glm::vec2(ndc));
+        maximum = glm::max(maximum, glm::vec2(ndc));
+        nearest = std::min(nearest, ndc.z);
+    }
+
+    if (maximum.x < -1.0f || minimum.x > 1.0f || maximum.y < -1.0f || minimum.y > 1.0f || nearest > 1.0f)
+    {
+        outside = true;
+        return true;
+    }
+
+    int tileMinX = std::clamp(static_cast<int>((minimum.x * 0.5f + 0.5f) * width) / TILE_SIZE, 0, tilesX - 1);
+    int tileMaxX = std::clamp(static_cast<int>((maximum.x * 0.5f + 0.5f) * width) / TILE_SIZE, 0, tilesX - 1);
+    int tileMinY = std::clamp(static_cast<int>((minimum.y * 0.5f + 0.5f) * height) / TILE_SIZE, 0, tilesY - 1);
+    int tileMaxY = std::clamp(static_cast<int>((maximum.y * 0.5f + 0.5f) * height) / TILE_SIZE, 0, tilesY - 1);
+
+    // visible as soon as one covered tile has something farther away than the box' nearest point
+    for (int tileY = tileMinY; tileY <= tileMaxY; tileY++)
+    {
+        for (int tileX = tileMinX; tileX <= tileMaxX; tileX++)
+        {
+            if (tileMaxDepth[static_cast<size_t>(tileY) * tilesX + tileX] >= nearest)
+                return false;
+        }
+    }
+    return true;
+}
+
+const OcclusionCuller::Bounds &OcclusionCuller::getBounds(const Geometry *geometry)
+{
+    auto found = bounds.find(geometry);
+    if (found != bounds.end())
+        return found->second;
+
+    Bounds box = {glm::vec3(INFINITY), glm::vec3(-INFINITY)};
+    for (const glm::vec3 &position : geometry->getGeometryData().positions)
+    {
+        box.min = glm::min(box.min, position);
+        box.max = glm::max(box.max, position);
+    }
+    return bounds.emplace(geometry, box).first->second;
+}
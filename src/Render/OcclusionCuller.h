@@ -0,0 +1,91 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "SceneDrawLists.h"
+
+struct RenderObject;
+class Geometry;
+
+/*!
+ * CPU occlusion culling against a small software depth buffer.
+ * Designated occluders keep their mesh, or only its largest triangles when it is over budget,
+ * so an occluder never covers more than the object it stands for. Every frame these are
+ * rasterized with SIMD (AVX2 when compiled for it, SSE otherwise) into a low resolution depth
+ * buffer, split into horizontal bands that are filled in parallel. The buffer is reduced to the farthest depth per 8x8 tile, and an object whose
+ * bounding box is behind every tile it covers is left out of the camera passes. Nothing is read
+ * back from the GPU, so the test never stalls the pipeline. Shadow casters are not culled,
+ * hidden objects can still throw shadows into view.
+ */
+class OcclusionCuller
+{
+public:
+    static constexpr int TILE_SIZE = 8;
+
+    struct Stats
+    {
+        unsigned int occluders = 0, occluderTriangles = 0;
+        unsigned int tested = 0, occluded = 0, outsideView = 0;
+        float milliseconds = 0.0f;
+    };
+
+    /*!
+     * @param width: depth buffer width, the height follows the aspect ratio
+     */
+    OcclusionCuller(int width, float aspectRatio);
+
+    /*!
+     * Registers an object as occluder and copies its mesh.
+     * Occluders themselves are never culled, their own triangles would hide them.
+     * @param maxTriangles: meshes above this keep only their largest triangles, below it they are used as they are
+     */
+    void addOccluder(RenderObject *object, unsigned int maxTriangles = 2048);
+
+    /*!
+     * Rasterizes the occluders of the world and marks the occluded items of the current draw lists
+     */
+    void cull(SceneDrawLists &drawLists, uint32_t worldMask, const glm::mat4 &viewProjection);
+
+    const Stats &getStats() const { return stats; }
+
+private:
+    struct Occluder
+    {
+        RenderObject *object;
+        std::vector<glm::vec3> positions;
+        std::vector<unsigned int> indices;
+    };
+
+    struct Bounds
+    {
+        glm::vec3 min, max;
+    };
+
+    // screen space triangle with its edge functions and depth plane, set up once per frame
+    struct Triangle
+    {
+        float edgeA[3], edgeB[3], edgeC[3];
+        float depthA, depthB, depthC;
+        int minX, maxX, minY, maxY;
+    };
+
+    int width, height, tilesX, tilesY;
+    std::vector<float> depth;
+    std::vector<float> tileMaxDepth;
+    std::vector<Occluder> occluders;
+    std::unordered_map<const Geometry *, Bounds> bounds;
+    std::vector<Triangle> triangles;
+    Stats stats;
+
+    static void simplify(const std::vector<glm::vec3> &positions, const std::vector<unsigned int> &indices, unsigned int maxTriangles,
+                         std::vector<glm::vec3> &outPositions, std::vector<unsigned int> &outIndices);
+
+    void setupTriangles(uint32_t worldMask, const glm::mat4 &viewProjection);
+    void addTriangle(const glm::vec4 clip[3]);
+    void rasterizeBand(int firstRow, int lastRow);
+    void buildTiles(int firstTileRow, int lastTileRow);
+    bool isOccluded(Geometry *geometry, const glm::mat4 &viewProjection, bool &outside);
+    const Bounds &getBounds(const Geometry *geometry);
+};
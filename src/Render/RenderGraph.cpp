@@ -0,0 +1,477 @@
+#include "RenderGraph.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+RenderGraph::~RenderGraph()
+{
+    clear();
+    for (PhysicalTexture &physical : pool)
+        glDeleteTextures(1, &physical.texture);
+}
+
+RenderGraph::Resource RenderGraph::Builder::create(const std::string &name, const TextureDesc &desc)
+{
+    ResourceNode node;
+    node.name = name;
+    node.desc = desc;
+    graph.resources.push_back(node);
+    Resource resource = static_cast<Resource>(graph.resources.size() - 1);
+    write(resource);
+    return resource;
+}
+
+void RenderGraph::Builder::read(Resource resource, GLuint unit)
+{
+    graph.passes[pass].reads.push_back({resource, unit});
+}
+
+void RenderGraph::Builder::write(Resource resource)
+{
+    auto &writes = graph.passes[pass].writes;
+    if (std::find(writes.begin(), writes.end(), resource) == writes.end())
+        writes.push_back(resource);
+}
+
+GLuint RenderGraph::Context::getTexture(Resource resource) const
+{
+    return graph.resources[resource].texture;
+}
+
+void RenderGraph::Context::bindTarget() const
+{
+    const PassNode &node = graph.passes[pass];
+    glBindFramebuffer(GL_FRAMEBUFFER, node.fbo);
+    if (!node.writes.empty())
+    {
+        const TextureDesc &desc = graph.resources[node.writes.front()].desc;
+        glViewport(0, 0, desc.width, desc.height);
+    }
+}
+
+void RenderGraph::Context::resolve(Resource source, Resource target, int width, int height) const
+{
+    const ResourceNode &from = graph.resources[source];
+    const ResourceNode &to = graph.resources[target];
+    const PassNode &node = graph.passes[pass];
+    if (from.producer < 0)
+    {
+        std::cerr << "RenderGraph: " << from.name << " has no framebuffer to resolve from" << std::endl;
+        return;
+    }
+
+    GLenum readAttachment = graph.getAttachment(from.producer, source);
+    GLenum drawAttachment = graph.getAttachment(pass, target);
+    bool depth = isDepthFormat(from.desc.internalFormat);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, graph.passes[from.producer].fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, node.fbo);
+    if (!depth)
+    {
+        glReadBuffer(readAttachment);
+        glDrawBuffer(drawAttachment);
+    }
+    int regionWidth = width > 0 ? width : from.desc.width;
+    int regionHeight = height > 0 ? height : from.desc.height;
+    glBlitFramebuffer(0, 0, regionWidth, regionHeight, 0, 0, std::min(regionWidth, to.desc.width), std::min(regionHeight, to.desc.height),
+                      depth ? GL_DEPTH_BUFFER_BIT : GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+    // leave the pass' own framebuffer bound with all of its targets enabled again
+    glBindFramebuffer(GL_FRAMEBUFFER, node.fbo);
+    if (node.fbo != 0 && !node.drawBuffers.empty())
+        glDrawBuffers(static_cast<GLsizei>(node.drawBuffers.size()), node.drawBuffers.data());
+}
+
+RenderGraph::Resource RenderGraph::import(const std::string &name, GLuint texture, const TextureDesc &desc)
+{
+    ResourceNode node;
+    node.name = name;
+    node.desc = desc;
+    node.transient = false;
+    node.texture = texture;
+    resources.push_back(node);
+    return static_cast<Resource>(resources.size() - 1);
+}
+
+RenderGraph::Resource RenderGraph::importBackbuffer(int width, int height)
+{
+    Resource resource = import("backbuffer", 0, TextureDesc{width, height, GL_RGBA8});
+    resources[resource].backbuffer = true;
+    resources[resource].output = true;
+    return resource;
+}
+
+void RenderGraph::addPass(const std::string &name, const std::function<void(Builder &)> &setup,
+                          const std::function<void(const Context &)> &execute)
+{
+    PassNode node;
+    node.name = name;
+    node.execute = execute;
+    passes.push_back(node);
+
+    Builder builder(*this, static_cast<int>(passes.size() - 1));
+    setup(builder);
+}
+
+void RenderGraph::markOutput(Resource resource)
+{
+    resources[resource].output = true;
+}
+
+void RenderGraph::compile()
+{
+    cull();
+    sortPasses();
+
+    for (ResourceNode &resource : resources)
+        resource.firstUse = resource.lastUse = -1;
+    for (int position = 0; position < static_cast<int>(order.size()); position++)
+    {
+        const PassNode &pass = passes[order[position]];
+        auto touch = [&](Resource r)
+        {
+            ResourceNode &resource = resources[r];
+            if (resource.firstUse < 0)
+                resource.firstUse = position;
+            resource.lastUse = position;
+        };
+        for (const auto &read : pass.reads)
+            touch(read.first);
+        for (Resource write : pass.writes)
+            touch(write);
+    }
+
+    allocate();
+    createFramebuffers();
+
+    stats = Stats();
+    stats.passes = static_cast<int>(order.size());
+    stats.culledPasses = static_cast<int>(passes.size() - order.size());
+    for (const ResourceNode &resource : resources)
+    {
+        if (resource.transient && resource.firstUse >= 0)
+        {
+            stats.transientTargets++;
+            stats.unaliasedBytes += bytesPerPixel(resource.desc.internalFormat) * resource.desc.samples * resource.desc.width * resource.desc.height;
+        }
+    }
+    for (const PhysicalTexture &physical : pool)
+    {
+        stats.physicalTargets++;
+        stats.transientBytes += bytesPerPixel(physical.desc.internalFormat) * physical.desc.samples * physical.desc.width * physical.desc.height;
+    }
+}
+
+void RenderGraph::cull()
+{
+    // walk back from the outputs, a pass survives if something needs what it writes
+    std::vector<bool> needed(resources.size(), false);
+    for (size_t i = 0; i < resources.size(); i++)
+        needed[i] = resources[i].output;
+
+    for (int i = static_cast<int>(passes.size()) - 1; i >= 0; i--)
+    {
+        PassNode &pass = passes[i];
+        pass.culled = std::none_of(pass.writes.begin(), pass.writes.end(), [&](Resource r)
+                                   { return needed[r]; });
+        if (pass.culled)
+            continue;
+        for (const auto &read : pass.reads)
+            needed[read.first] = true;
+    }
+}
+
+void RenderGraph::sortPasses()
+{
+    // a pass depends on every earlier pass that writes something it reads or writes
+    size_t count = passes.size();
+    std::vector<std::vector<int>> dependents(count);
+    std::vector<int> dependencies(count, 0);
+    for (size_t j = 0; j < count; j++)
+    {
+        if (passes[j].culled)
+            continue;
+        for (size_t i = 0; i < j; i++)
+        {
+            if (passes[i].culled)
+                continue;
+            bool dependent = false;
+            for (Resource write : passes[i].writes)
+            {
+                for (const auto &read : passes[j].reads)
+                    dependent |= read.first == write;
+                for (Resource otherWrite : passes[j].writes)
+                    dependent |= otherWrite == write;
+            }
+            if (dependent)
+            {
+                dependents[i].push_back(static_cast<int>(j));
+                dependencies[j]++;
+            }
+        }
+    }
+
+    // Kahn's algorithm, ties are broken by declaration order
+    order.clear();
+    std::vector<bool> done(count, false);
+    while (true)
+    {
+        int next = -1;
+        for (size_t i = 0; i < count && next < 0; i++)
+        {
+            if (!passes[i].culled && !done[i] && dependencies[i] == 0)
+                next = static_cast<int>(i);
+        }
+        if (next < 0)
+            break;
+
+        done[next] = true;
+        order.push_back(next);
+        for (int dependent : dependents[next])
+            dependencies[dependent]--;
+    }
+}
+
+void RenderGraph::allocate()
+{
+    for (PhysicalTexture &physical : pool)
+    {
+        physical.busyUntil = -1;
+        physical.used = false;
+    }
+
+    std::vector<int> transients;
+    for (size_t i = 0; i < resources.size(); i++)
+    {
+        if (resources[i].transient && resources[i].firstUse >= 0)
+            transients.push_back(static_cast<int>(i));
+    }
+    std::stable_sort(transients.begin(), transients.end(), [&](int a, int b)
+                     { return resources[a].firstUse < resources[b].firstUse; });
+
+    for (int index : transients)
+    {
+        ResourceNode &resource = resources[index];
+
+        // a texture can be reused once its last reader is done, never by the pass that reads it
+        int slot = -1;
+        for (size_t p = 0; p < pool.size() && slot < 0; p++)
+        {
+            if (pool[p].desc == resource.desc && pool[p].busyUntil < resource.firstUse)
+                slot = static_cast<int>(p);
+        }
+        if (slot < 0)
+        {
+            PhysicalTexture physical;
+            physical.desc = resource.desc;
+            const TextureDesc &desc = resource.desc;
+            glGenTextures(1, &physical.texture);
+            if (desc.samples > 1)
+            {
+                glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, physical.texture);
+                glTexStorage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, desc.samples, desc.internalFormat, desc.width, desc.height, GL_TRUE);
+                glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+            }
+            else
+            {
+                glBindTexture(GL_TEXTURE_2D, physical.texture);
+                glTexStorage2D(GL_TEXTURE_2D, 1, desc.internalFormat, desc.width, desc.height);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, desc.filter);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, desc.filter);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                glBindTexture(GL_TEXTURE_2D, 0);
+            }
+            pool.push_back(physical);
+            slot = static_cast<int>(pool.size() - 1);
+        }
+
+        pool[slot].busyUntil = resource.lastUse;
+        pool[slot].used = true;
+        resource.physical = slot;
+        resource.texture = pool[slot].texture;
+    }
+
+    // textures left over from an earlier compile are freed
+    for (size_t p = 0; p < pool.size();)
+    {
+        if (pool[p].used)
+        {
+            p++;
+            continue;
+        }
+        glDeleteTextures(1, &pool[p].texture);
+        pool.erase(pool.begin() + p);
+        for (ResourceNode &resource : resources)
+        {
+            if (resource.physical > static_cast<int>(p))
+                resource.physical--;
+        }
+    }
+}
+
+void RenderGraph::createFramebuffers()
+{
+    for (PassNode &pass : passes)
+    {
+        if (pass.fbo != 0)
+            glDeleteFramebuffers(1, &pass.fbo);
+        pass.fbo = 0;
+        pass.attachments.assign(pass.writes.size(), GL_NONE);
+        pass.drawBuffers.clear();
+    }
+    for (ResourceNode &resource : resources)
+        resource.producer = -1;
+
+    for (int index : order)
+    {
+        PassNode &pass = passes[index];
+        for (Resource write : pass.writes)
+            resources[write].producer = index;
+
+        // passes that only fill imported textures (shadow map, water) bring their own framebuffer
+        bool writesBackbuffer = std::any_of(pass.writes.begin(), pass.writes.end(), [&](Resource r)
+                                            { return resources[r].backbuffer; });
+        bool writesTransient = std::any_of(pass.writes.begin(), pass.writes.end(), [&](Resource r)
+                                           { return resources[r].transient; });
+        if (writesBackbuffer || !writesTransient)
+            continue;
+
+        glGenFramebuffers(1, &pass.fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, pass.fbo);
+
+        std::vector<GLenum> &drawBuffers = pass.drawBuffers;
+        for (size_t i = 0; i < pass.writes.size(); i++)
+        {
+            const ResourceNode &resource = resources[pass.writes[i]];
+            GLenum attachment = isDepthFormat(resource.desc.internalFormat)
+                                    ? GL_DEPTH_ATTACHMENT
+                                    : GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(drawBuffers.size());
+            glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, textureTarget(resource.desc), resource.texture, 0);
+            if (attachment != GL_DEPTH_ATTACHMENT)
+                drawBuffers.push_back(attachment);
+            pass.attachments[i] = attachment;
+        }
+        if (drawBuffers.empty())
+            glDrawBuffer(GL_NONE);
+        else
+            glDrawBuffers(static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            std::cerr << "RenderGraph: framebuffer of pass " << pass.name << " not complete!" << std::endl;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void RenderGraph::execute()
+{
+    for (int index : order)
+    {
+        const PassNode &pass = passes[index];
+        for (const auto &read : pass.reads)
+        {
+            if (read.second == NO_UNIT)
+                continue;
+            const ResourceNode &resource = resources[read.first];
+            glActiveTexture(GL_TEXTURE0 + read.second);
+            glBindTexture(textureTarget(resource.desc), resource.texture);
+        }
+        glActiveTexture(GL_TEXTURE0);
+
+        pass.execute(Context(*this, index));
+    }
+}
+
+void RenderGraph::clear()
+{
+    for (PassNode &pass : passes)
+    {
+        if (pass.fbo != 0)
+            glDeleteFramebuffers(1, &pass.fbo);
+    }
+    passes.clear();
+    resources.clear();
+    order.clear();
+}
+
+void RenderGraph::printReport() const
+{
+    const double MB = 1024.0 * 1024.0;
+
+    std::cout << "Render graph: " << stats.passes << " passes, " << stats.culledPasses << " culled" << std::endl;
+    for (size_t position = 0; position < order.size(); position++)
+        std::cout << "  " << position << ": " << passes[order[position]].name << std::endl;
+    for (const PassNode &pass : passes)
+    {
+        if (pass.culled)
+            std::cout << "  culled: " << pass.name << std::endl;
+    }
+
+    for (const ResourceNode &resource : resources)
+    {
+        if (resource.firstUse < 0)
+            continue;
+        std::cout << "  " << std::left << std::setw(20) << resource.name << std::right
+                  << resource.desc.width << "x" << resource.desc.height;
+        if (resource.desc.samples > 1)
+            std::cout << " x" << resource.desc.samples;
+        if (resource.transient)
+            std::cout << "  passes " << resource.firstUse << "-" << resource.lastUse << "  texture #" << resource.physical;
+        else
+            std::cout << "  imported";
+        std::cout << std::endl;
+    }
+
+    std::cout << "  transient targets: " << stats.transientTargets << " in " << stats.physicalTargets << " textures, "
+              << std::fixed << std::setprecision(1) << stats.transientBytes / MB << " MB (" << stats.unaliasedBytes / MB
+              << " MB without aliasing)" << std::defaultfloat << std::endl;
+}
+
+GLenum RenderGraph::getAttachment(int pass, Resource resource) const
+{
+    const PassNode &node = passes[pass];
+    for (size_t i = 0; i < node.writes.size() && i < node.attachments.size(); i++)
+    {
+        if (node.writes[i] == resource)
+            return node.attachments[i];
+    }
+    return GL_NONE;
+}
+
+GLenum RenderGraph::textureTarget(const TextureDesc &desc)
+{
+    return desc.samples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+}
+
+size_t RenderGraph::bytesPerPixel(GLenum internalFormat)
+{
+    switch (internalFormat)
+    {
+    case GL_RGBA32F:
+        return 16;
+    case GL_RGBA16F:
+        return 8;
+    case GL_RGB16F:
+        return 6;
+    case GL_RG16F:
+    case GL_R32F:
+    case GL_RGBA8:
+    case GL_DEPTH_COMPONENT24:
+    case GL_DEPTH_COMPONENT32F:
+    case GL_DEPTH24_STENCIL8:
+        return 4;
+    case GL_RGB8:
+        return 3;
+    case GL_R16F:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+bool RenderGraph::isDepthFormat(GLenum internalFormat)
+{
+    return internalFormat == GL_DEPTH_COMPONENT16 || internalFormat == GL_DEPTH_COMPONENT24 ||
+           internalFormat == GL_DEPTH_COMPONENT32F || internalFormat == GL_DEPTH24_STENCIL8 ||
+           internalFormat == GL_DEPTH_COMPONENT;
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+/*!
+ * Frame graph of render passes.
+ * Passes declare the textures they read and write; compile() culls passes whose results are
+ * never used, orders the rest by their dependencies and places transient render targets in a
+ * pool where targets whose lifetimes do not overlap share one texture. Reads are bound to the
+ * texture unit the reading pass asks for right before it executes.
+ */
+class RenderGraph
+{
+public:
+    using Resource = int;
+    static constexpr Resource INVALID = -1;
+    // reads with this unit only order the passes, nothing is bound (e.g. resolve sources)
+    static constexpr GLuint NO_UNIT = ~0u;
+
+    struct TextureDesc
+    {
+        int width = 0, height = 0;
+        GLenum internalFormat = GL_RGBA16F;
+        // more than one sample makes a GL_TEXTURE_2D_MULTISAMPLE target
+        int samples = 1;
+        GLenum filter = GL_NEAREST;
+
+        bool operator==(const TextureDesc &other) const
+        {
+            return width == other.width && height == other.height && internalFormat == other.internalFormat &&
+                   samples == other.samples && filter == other.filter;
+        }
+    };
+
+    /*!
+     * Handed to a pass' setup callback to declare its resources
+     */
+    class Builder
+    {
+    public:
+        /*!
+         * Creates a transient render target that only lives as long as some pass uses it
+         */
+        Resource create(const std::string &name, const TextureDesc &desc);
+        /*!
+         * The texture is bound to the given unit while the pass executes
+         */
+        void read(Resource resource, GLuint unit);
+        void write(Resource resource);
+
+    private:
+        friend class RenderGraph;
+        Builder(RenderGraph &graph, int pass) : graph(graph), pass(pass) {}
+        RenderGraph &graph;
+        int pass;
+    };
+
+    /*!
+     * Handed to a pass' execute callback
+     */
+    class Context
+    {
+    public:
+        GLuint getTexture(Resource resource) const;
+        /*!
+         * Binds a framebuffer with the pass' written targets attached and sets the viewport to them
+         */
+        void bindTarget() const;
+        /*!
+         * Blits (and for multisampled sources resolves) a resource read by this pass into one it writes
+         * @param width, height: size of the region starting at the origin, 0 for the whole source
+         */
+        void resolve(Resource source, Resource target, int width = 0, int height = 0) const;
+
+    private:
+        friend class RenderGraph;
+        Context(const RenderGraph &graph, int pass) : graph(graph), pass(pass) {}
+        const RenderGraph &graph;
+        int pass;
+    };
+
+    struct Stats
+    {
+        int passes = 0, culledPasses = 0;
+        int transientTargets = 0, physicalTargets = 0;
+        size_t transientBytes = 0;   // memory actually allocated for transient targets
+        size_t unaliasedBytes = 0;   // what the same targets would need without aliasing
+    };
+
+    RenderGraph() = default;
+    ~RenderGraph();
+
+    RenderGraph(const RenderGraph &) = delete;
+    RenderGraph &operator=(const RenderGraph &) = delete;
+
+    /*!
+     * Makes a texture owned by someone else (e.g. the shadow map) usable in the graph
+     */
+    Resource import(const std::string &name, GLuint texture, const TextureDesc &desc);
+    /*!
+     * The default framebuffer, written by the last pass
+     */
+    Resource importBackbuffer(int width, int height);
+
+    void addPass(const std::string &name, const std::function<void(Builder &)> &setup,
+                 const std::function<void(const Context &)> &execute);
+
+    /*!
+     * Resources that must be produced even though no pass reads them
+     */
+    void markOutput(Resource resource);
+
+    /*!
+     * Culls, orders, computes lifetimes and (re)allocates the transient targets
+     */
+    void compile();
+    void execute();
+
+    /*!
+     * Drops all passes and resources, pooled textures are kept for the next compile
+     */
+    void clear();
+
+    void printReport() const;
+    const Stats &getStats() const { return stats; }
+
+private:
+    struct ResourceNode
+    {
+        std::string name;
+        TextureDesc desc;
+        bool transient = true;
+        bool backbuffer = false;
+        bool output = false;
+        GLuint texture = 0;
+        int physical = -1;
+        int firstUse = -1, lastUse = -1;
+        int producer = -1;
+    };
+
+    struct PassNode
+    {
+        std::string name;
+        std::function<void(const Context &)> execute;
+        std::vector<std::pair<Resource, GLuint>> reads;
+        std::vector<Resource> writes;
+        // framebuffer attachment of each write, GL_NONE if it is not attached
+        std::vector<GLenum> attachments;
+        std::vector<GLenum> drawBuffers;
+        bool culled = false;
+        GLuint fbo = 0;
+    };
+
+    struct PhysicalTexture
+    {
+        TextureDesc desc;
+        GLuint texture = 0;
+        int busyUntil = -1;
+        bool used = false;
+    };
+
+    std::vector<ResourceNode> resources;
+    std::vector<PassNode> passes;
+    std::vector<int> order;
+    std::vector<PhysicalTexture> pool;
+    Stats stats;
+
+    void cull();
+    void sortPasses();
+    void allocate();
+    void createFramebuffers();
+    GLenum getAttachment(int pass, Resource resource) const;
+    static GLenum textureTarget(const TextureDesc &desc);
+    static size_t bytesPerPixel(GLenum internalFormat);
+    static bool isDepthFormat(GLenum internalFormat);
+};
@@ -6,16 +6,15 @@
 #include "../Geometry.h"
 #include "../Shader.h"
 #include "../TessellationShader.h"
+#include "../PreprocessedShader.h"
 #include "../RenderObject.h"
+#include "SceneDrawLists.h"
 
 class RenderPass
 {
 public:
-    RenderPass(int width, int height, std::vector<std::shared_ptr<RenderObject>> &renderObjects)
-        : width(width), height(height), renderObjects(&renderObjects) {}
-
     RenderPass(int width, int height)
-        : width(width), height(height), renderObjects(nullptr) {}
+        : width(width), height(height) {}
 
     virtual ~RenderPass()
     {
@@ -27,25 +26,21 @@ public:
 
     virtual void Execute() = 0;
 
+    GLuint getTexture() const { return map; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
 protected:
-    GLuint fbo, map;
+    GLuint fbo = 0, map = 0;
     int width, height;
-    std::vector<std::shared_ptr<RenderObject>> *renderObjects = nullptr;
 
     bool useModelMatrix = false;
-    GLuint textureUnit;
     void BindFramebuffer()
     {
         glBindFramebuffer(GL_FRAMEBUFFER, fbo);
         glViewport(0, 0, width, height);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     }
-    void BindTexture()
-    {
-        glActiveTexture(GL_TEXTURE0 + textureUnit);
-        glBindTexture(GL_TEXTURE_2D, map);
-    }
-
     void UnbindFramebuffer()
     {
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
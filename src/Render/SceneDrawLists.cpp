@@ -0,0 +1,69 @@
+#include "SceneDrawLists.h"
+#include "../RenderObject.h"
+#include <algorithm>
+#include <functional>
+#include <iostream>
+
+void SceneDrawLists::update(const std::vector<std::shared_ptr<RenderObject>> &renderObjects, uint32_t worldMask, bool underwater)
+{
+    current = &lists[(worldMask == WORLD_BLOOM ? 0 : 2) + (underwater ? 1 : 0)];
+
+    bool stale = !current->built || current->version != RenderObject::sceneVersion ||
+                 current->objects != renderObjects.data() || current->objectCount != renderObjects.size();
+    if (stale)
+        build(*current, renderObjects, worldMask, underwater);
+}
+
+void SceneDrawLists::build(Lists &lists, const std::vector<std::shared_ptr<RenderObject>> &renderObjects, uint32_t worldMask, bool underwater)
+{
+    lists.visible.clear();
+    lists.prepassable.clear();
+    lists.remaining.clear();
+    lists.shadowCasters.clear();
+
+    for (const auto &renderObject : renderObjects)
+    {
+        Geometry *geometry = renderObject->geometry.get();
+        if (!renderObject->isRendered || (geometry->getWorldMask() & worldMask) == 0)
+            continue;
+
+        Material *material = geometry->getMaterialForWorld(worldMask, underwater);
+        DrawItem item = {geometry, material, material ? material->getShaderPermutations() : nullptr};
+        lists.visible.push_back(item);
+
+        if (renderObject->hasTag(TAG_CASTS_SHADOW))
+            lists.shadowCasters.push_back(geometry);
+
+        if (!material)
+        {
+            std::cerr << "[SceneDrawLists] Warning: no material for object " << renderObject->getIdentifier() << " in world " << worldMask << "\n";
+            continue;
+        }
+        Shader *shader = material->getShader();
+        if (!shader)
+        {
+            std::cerr << "[SceneDrawLists] Warning: material of object " << renderObject->getIdentifier() << " has no shader\n";
+            continue;
+        }
+
+        if (material->usesDepthPrepass() && !shader->isTessellationShader())
+            lists.prepassable.push_back(item);
+        else
+            lists.remaining.push_back(item);
+    }
+
+    // neighbours share a program and mostly a material, so the passes rarely switch state
+    auto byState = [](const DrawItem &a, const DrawItem &b)
+    {
+        return a.shader != b.shader ? std::less<ShaderPermutations *>()(a.shader, b.shader)
+                                    : std::less<Material *>()(a.material, b.material);
+    };
+    std::stable_sort(lists.prepassable.begin(), lists.prepassable.end(), byState);
+    std::stable_sort(lists.remaining.begin(), lists.remaining.end(), byState);
+
+    lists.built = true;
+    lists.version = RenderObject::sceneVersion;
+    lists.objects = renderObjects.data();
+    lists.objectCount = renderObjects.size();
+    rebuilds++;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct RenderObject;
+class Geometry;
+class Material;
+class ShaderPermutations;
+
+/*!
+ * Flat, pre-filtered draw lists of the scene, one set per world and underwater state.
+ * A set is only rebuilt when RenderObject::sceneVersion or the object list changed since it
+ * was built, so switching worlds picks an already built set and the passes just walk an array
+ * instead of testing world masks and resolving materials for every object every frame.
+ */
+class SceneDrawLists
+{
+public:
+    struct DrawItem
+    {
+        Geometry *geometry;
+        Material *material;
+        ShaderPermutations *shader;
+        bool occluded = false;
+    };
+
+    /*!
+     * Selects the set for the given world and rebuilds it if the scene changed
+     */
+    void update(const std::vector<std::shared_ptr<RenderObject>> &renderObjects, uint32_t worldMask, bool underwater);
+
+    /*!
+     * Every rendered object of the world, material may be nullptr
+     */
+    const std::vector<DrawItem> &getVisible() const { return current->visible; }
+    /*!
+     * Drawable objects that may go through the depth pre-pass, sorted by shader and material
+     */
+    const std::vector<DrawItem> &getPrepassable() const { return current->prepassable; }
+    /*!
+     * Drawable objects that are always depth tested as usual (displaced, tessellated), sorted the same way
+     */
+    const std::vector<DrawItem> &getRemaining() const { return current->remaining; }
+    const std::vector<Geometry *> &getShadowCasters() const { return current->shadowCasters; }
+
+    /*!
+     * Sets DrawItem::occluded of the camera lists (pre-passable and remaining) of the current set
+     * @param test: callable taking a const DrawItem & and returning true when the item is hidden
+     */
+    template <typename Test>
+    void markOccluded(Test test)
+    {
+        for (DrawItem &item : current->prepassable)
+            item.occluded = test(item);
+        for (DrawItem &item : current->remaining)
+            item.occluded = test(item);
+    }
+
+    unsigned int getRebuildCount() const { return rebuilds; }
+
+private:
+    struct Lists
+    {
+        std::vector<DrawItem> visible, prepassable, remaining;
+        std::vector<Geometry *> shadowCasters;
+        bool built = false;
+        uint32_t version = 0;
+        const void *objects = nullptr;
+        size_t objectCount = 0;
+    };
+
+    // bloom and dither world, each above and under water
+    Lists lists[4];
+    Lists *current = &lists[0];
+    unsigned int rebuilds = 0;
+
+    void build(Lists &lists, const std::vector<std::shared_ptr<RenderObject>> &renderObjects, uint32_t worldMask, bool underwater);
+};
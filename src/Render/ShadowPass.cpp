@@ -1,9 +1,8 @@
 #include "ShadowPass.h"
 
-ShadowPass::ShadowPass(Shader *shader, int width, int height, std::vector<std::shared_ptr<RenderObject>> &renderObjects, bool &inBloomyWorld)
-    : RenderPass(width, height, renderObjects), shader(shader), inBloomyWorld(inBloomyWorld)
+ShadowPass::ShadowPass(Shader *shader, int width, int height, const SceneDrawLists &drawLists)
+    : RenderPass(width, height), shader(shader), drawLists(drawLists)
 {
-    textureUnit = 5;
     Init();
 }
 
@@ -34,20 +33,8 @@ void ShadowPass::Execute()
     BindFramebuffer();
     shader->use();
 
-    for (const auto &renderObject : *renderObjects)
-    {
-        uint32_t mask = renderObject->geometry->getWorldMask();
-        bool doRenderObj = ((mask & WORLD_BLOOM) && inBloomyWorld) || ((mask & WORLD_DITHER) && !inBloomyWorld);
-        if (renderObject->isRendered == true && doRenderObj && renderObject->id != "floor")
-        {
-            renderObject->geometry->draw(shader);
-        }
-    }
+    for (Geometry *geometry : drawLists.getShadowCasters())
+        geometry->draw(shader);
 
     UnbindFramebuffer();
-    BindTexture();
-
-    glViewport(0, 0, width, height);
-    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
@@ -5,12 +5,12 @@
 class ShadowPass : public RenderPass
 {
 public:
-    ShadowPass(Shader *shader, int width, int height, std::vector<std::shared_ptr<RenderObject>> &renderObjects, bool &inBloomyWorld);
+    ShadowPass(Shader *shader, int width, int height, const SceneDrawLists &drawLists);
 
     void Init() override;
     void Execute() override;
 
 private:
     Shader *shader;
-    bool &inBloomyWorld;
+    const SceneDrawLists &drawLists;
 };
\ No newline at end of file
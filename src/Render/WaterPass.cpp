@@ -0,0 +1,70 @@
+#include "WaterPass.h"
+#include <algorithm>
+#include <cmath>
+
+WaterPass::WaterPass(int resolution, float tileSize, float updateRate, float &time)
+    : RenderPass(resolution, resolution), tileSize(std::max(std::round(tileSize), 1.0f)),
+      updateInterval(updateRate > 0.0f ? 1.0f / updateRate : 0.0f), time(time)
+{
+    Init();
+}
+
+WaterPass::~WaterPass()
+{
+    glDeleteVertexArrays(1, &vao);
+}
+
+void WaterPass::Init()
+{
+    glGenFramebuffers(1, &fbo);
+
+    glGenTextures(1, &map);
+    glBindTexture(GL_TEXTURE_2D, map);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, map, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cerr << "WaterPass FBO not complete!" << std::endl;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // the full screen triangle is generated from gl_VertexID, core profile still needs a VAO bound
+    glGenVertexArrays(1, &vao);
+}
+
+void WaterPass::Execute()
+{
+    bool due = !hasData || updateInterval == 0.0f || time - lastUpdate >= updateInterval;
+    if (due)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glViewport(0, 0, width, height);
+        glDisable(GL_DEPTH_TEST);
+
+        shader->use();
+        shader->setUniform("u_time", time);
+        shader->setUniform("waterTileSize", tileSize);
+        shader->setUniform("waterResolution", float(width));
+
+        glBindVertexArray(vao);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glBindVertexArray(0);
+
+        glEnable(GL_DEPTH_TEST);
+        UnbindFramebuffer();
+
+        lastUpdate = time;
+        hasData = true;
+    }
+}
+
+void WaterPass::setUniforms(Shader *shader, GLuint unit) const
+{
+    shader->use();
+    shader->setUniform("waterHeightfield", int(unit));
+    shader->setUniform("waterTileSize", tileSize);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "RenderPass.h"
+
+/*!
+ * Renders the water's domain warped fbm height and its gradient into a tiling texture.
+ * The water shaders sample it instead of evaluating the noise per vertex and fragment,
+ * so their cost no longer depends on the water mesh resolution.
+ */
+class WaterPass : public RenderPass
+{
+public:
+    /*!
+     * @param resolution: width and height of the heightfield texture
+     * @param tileSize: wave space covered by one texture tile, rounded to a whole number
+     * @param updateRate: heightfield updates per second, 0 updates every frame
+     * @param time: the game time the waves are animated with
+     */
+    WaterPass(int resolution, float tileSize, float updateRate, float &time);
+    ~WaterPass();
+
+    void Init() override;
+    void Execute() override;
+
+    /*!
+     * Sets the sampler and tile size uniforms of a shader that reads the heightfield from the given unit
+     */
+    void setUniforms(Shader *shader, GLuint unit) const;
+
+private:
+    std::shared_ptr<Shader> shader = std::make_shared<PreprocessedShader>("assets/shaders/waterHeightfield.vert", "assets/shaders/waterHeightfield.frag");
+    GLuint vao = 0;
+    float tileSize;
+    float updateInterval;
+    float &time;
+    float lastUpdate = 0.0f;
+    bool hasData = false;
+};
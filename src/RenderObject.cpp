@@ -86,10 +86,17 @@ void RenderObject::setPosition(const glm::vec3 &position)
 }
 void RenderObject::setAsPickable()
 {
-    isPickable = true;
+    addTag(TAG_PICKABLE);
 }
 
-void RenderObject::setIdentifier(std::string name)
+void RenderObject::setIdentifier(const std::string &name)
 {
-    id = name;
+    entity.name = NameTable::intern(name);
+}
+
+void RenderObject::setTags(uint32_t tags)
+{
+    if (entity.tags != tags)
+        sceneVersion++;
+    entity.tags = tags;
 }
@@ -2,6 +2,7 @@
 #include <memory>
 #include <PxPhysicsAPI.h>
 #include "Geometry.h"
+#include "EntityInfo.h"
 #include <string>
 
 // Enum für die Typen der Rigid Bodies
@@ -14,39 +15,53 @@ enum class RigidBodyType
 
 struct RenderObject
 {
-    std::string id;
+    /*!
+     * Name and tags, the userData of the rigid body points here
+     */
+    EntityInfo entity;
     std::shared_ptr<Geometry> geometry;
     physx::PxRigidDynamic *dynamicBody;
     physx::PxRigidStatic *staticBody;
     RigidBodyType bodyType;
-    bool isPickable = false;
+    /*!
+     * Read only, change it with setRendered so cached draw lists notice
+     */
     bool isRendered = true;
+
+    /*!
+     * Bumped whenever anything the draw lists depend on changes (visibility, tags)
+     */
+    inline static uint32_t sceneVersion = 0;
     void RenderObject::setTransform(const glm::vec3 &position, const glm::vec3 &forward, bool spin);
     // Konstruktor für das RenderObject
     RenderObject(std::shared_ptr<Geometry> geom, physx::PxRigidDynamic *body)
-        : geometry(geom), dynamicBody(body), staticBody(nullptr), bodyType(RigidBodyType::DYNAMIC), isPickable(false), isRendered(true)
+        : geometry(geom), dynamicBody(body), staticBody(nullptr), bodyType(RigidBodyType::DYNAMIC), isRendered(true)
     {
+        entity.tags = TAG_CASTS_SHADOW;
+        entity.renderObject = this;
         if (!dynamicBody)
         {
             std::cerr << "Error: dynamicBody is nullptr!" << std::endl;
         }
         else
         {
-            dynamicBody->userData = this;
+            dynamicBody->userData = &entity;
             setCollisionFilter(geom->getWorldMask(), geom->getWorldMask() | WORLD_REMOTE);
         }
     }
 
     RenderObject(std::shared_ptr<Geometry> geom, physx::PxRigidStatic *body)
-        : geometry(geom), dynamicBody(nullptr), staticBody(body), bodyType(RigidBodyType::STATIC), isPickable(false), isRendered(true)
+        : geometry(geom), dynamicBody(nullptr), staticBody(body), bodyType(RigidBodyType::STATIC), isRendered(true)
     {
+        entity.tags = TAG_CASTS_SHADOW;
+        entity.renderObject = this;
         if (!staticBody)
         {
             std::cerr << "Error: dynamicBody is nullptr!" << std::endl;
         }
         else
         {
-            staticBody->userData = this;
+            staticBody->userData = &entity;
             setCollisionFilter(geom->getWorldMask(), geom->getWorldMask() | WORLD_REMOTE);
         }
     }
@@ -54,8 +69,14 @@ struct RenderObject
     RenderObject(std::shared_ptr<Geometry> geom)
         : geometry(geom), dynamicBody(nullptr), staticBody(nullptr), bodyType(RigidBodyType::NONE), isRendered(true)
     {
+        entity.tags = TAG_CASTS_SHADOW;
+        entity.renderObject = this;
     }
 
+    // the entity points back at this object
+    RenderObject(const RenderObject &) = delete;
+    RenderObject &operator=(const RenderObject &) = delete;
+
     RigidBodyType getBodyType() const
     {
         return bodyType;
@@ -70,7 +91,20 @@ struct RenderObject
 
     void setPosition(const glm::vec3 &position);
 
-    void setIdentifier(std::string name);
+    void setIdentifier(const std::string &name);
+    const std::string &getIdentifier() const { return NameTable::lookup(entity.name); }
+
+    bool hasTag(uint32_t tag) const { return entity.hasTag(tag); }
+    void setTags(uint32_t tags);
+    void addTag(uint32_t tag) { setTags(entity.tags | tag); }
+    void removeTag(uint32_t tag) { setTags(entity.tags & ~tag); }
+
+    void setRendered(bool rendered)
+    {
+        if (isRendered != rendered)
+            sceneVersion++;
+        isRendered = rendered;
+    }
 
     void setAsPickable();
 
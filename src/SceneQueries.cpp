@@ -0,0 +1,140 @@
+#include "SceneQueries.h"
+#include <algorithm>
+#include <chrono>
+#include <execution>
+#include <numeric>
+
+SceneQueries::SceneQueries(physx::PxScene *scene) : scene(scene)
+{
+}
+
+SceneQueries::Ticket SceneQueries::raycast(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance,
+                                           const physx::PxQueryFilterData &filter, Callback callback)
+{
+    Query query;
+    query.type = Type::RAYCAST;
+    query.pose = physx::PxTransform(physx::PxVec3(origin.x, origin.y, origin.z));
+    query.direction = physx::PxVec3(direction.x, direction.y, direction.z).getNormalized();
+    query.maxDistance = maxDistance;
+    query.filter = filter;
+    query.callback = std::move(callback);
+    return enqueue(std::move(query));
+}
+
+SceneQueries::Ticket SceneQueries::sweep(const physx::PxGeometry &geometry, const physx::PxTransform &pose, const glm::vec3 &direction,
+                                         float maxDistance, const physx::PxQueryFilterData &filter, Callback callback)
+{
+    Query query;
+    query.type = Type::SWEEP;
+    query.geometry.storeAny(geometry);
+    query.pose = pose;
+    query.direction = physx::PxVec3(direction.x, direction.y, direction.z).getNormalized();
+    query.maxDistance = maxDistance;
+    query.filter = filter;
+    query.callback = std::move(callback);
+    return enqueue(std::move(query));
+}
+
+SceneQueries::Ticket SceneQueries::overlap(const physx::PxGeometry &geometry, const physx::PxTransform &pose,
+                                           const physx::PxQueryFilterData &filter, Callback callback)
+{
+    Query query;
+    query.type = Type::OVERLAP;
+    query.geometry.storeAny(geometry);
+    query.pose = pose;
+    query.maxDistance = 0.0f;
+    query.filter = filter;
+    query.callback = std::move(callback);
+    return enqueue(std::move(query));
+}
+
+SceneQueries::Ticket SceneQueries::enqueue(Query query)
+{
+    // tickets index the results of the coming batch
+    queries.push_back(std::move(query));
+    return static_cast<Ticket>(queries.size() - 1);
+}
+
+void SceneQueries::execute()
+{
+    auto start = std::chrono::steady_clock::now();
+
+    results.assign(queries.size(), Result());
+    if (queries.size() < PARALLEL_THRESHOLD)
+    {
+        for (size_t i = 0; i < queries.size(); i++)
+            run(queries[i], results[i]);
+    }
+    else
+    {
+        // scene queries only read the scene, chunks keep the scheduling overhead below the query cost
+        std::vector<size_t> chunks((queries.size() + CHUNK_SIZE - 1) / CHUNK_SIZE);
+        std::iota(chunks.begin(), chunks.end(), 0);
+        std::for_each(std::execution::par, chunks.begin(), chunks.end(), [this](size_t chunk)
+                      {
+                          size_t end = std::min(queries.size(), (chunk + 1) * CHUNK_SIZE);
+                          for (size_t i = chunk * CHUNK_SIZE; i < end; i++)
+                              run(queries[i], results[i]);
+                      });
+    }
+
+    // callbacks may enqueue queries for the next batch
+    std::vector<Query> batch;
+    batch.swap(queries);
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+        if (batch[i].callback)
+            batch[i].callback(results[i]);
+    }
+
+    lastBatchSize = static_cast<unsigned int>(batch.size());
+    lastBatchMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void SceneQueries::run(const Query &query, Result &result) const
+{
+    const physx::PxHitFlags hitFlags = physx::PxHitFlag::ePOSITION | physx::PxHitFlag::eNORMAL;
+
+    auto storeBlock = [&result](const auto &hit)
+    {
+        result.hasBlock = true;
+        result.actor = hit.actor;
+        result.shape = hit.shape;
+        result.position = glm::vec3(hit.position.x, hit.position.y, hit.position.z);
+        result.normal = glm::vec3(hit.normal.x, hit.normal.y, hit.normal.z);
+        result.distance = hit.distance;
+    };
+
+    switch (query.type)
+    {
+    case Type::RAYCAST:
+    {
+        physx::PxRaycastBuffer hit;
+        if (scene->raycast(query.pose.p, query.direction, query.maxDistance, hit, hitFlags, query.filter) && hit.hasBlock)
+            storeBlock(hit.block);
+        break;
+    }
+    case Type::SWEEP:
+    {
+        physx::PxSweepBuffer hit;
+        if (scene->sweep(query.geometry.any(), query.pose, query.direction, query.maxDistance, hit, hitFlags, query.filter) && hit.hasBlock)
+            storeBlock(hit.block);
+        break;
+    }
+    case Type::OVERLAP:
+    {
+        // overlaps report touches, filters that block would stop at the first actor
+        physx::PxOverlapHit touches[MAX_OVERLAPS];
+        physx::PxOverlapBuffer hit(touches, MAX_OVERLAPS);
+        physx::PxQueryFilterData filter = query.filter;
+        filter.flags |= physx::PxQueryFlag::eNO_BLOCK;
+        if (scene->overlap(query.geometry.any(), query.pose, hit, filter))
+        {
+            result.overlapCount = hit.getNbTouches();
+            for (unsigned int i = 0; i < result.overlapCount; i++)
+                result.overlaps[i] = hit.getTouch(i).actor;
+        }
+        break;
+    }
+    }
+}
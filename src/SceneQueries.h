@@ -0,0 +1,89 @@
+#pragma once
+
+#include <PxPhysicsAPI.h>
+#include <glm/glm.hpp>
+#include <functional>
+#include <vector>
+
+/*!
+ * Batched raycasts, sweeps and overlaps against the physics scene.
+ * Systems enqueue queries during the frame, execute() runs them all at once, split into chunks
+ * that run in parallel, and then hands every result to its callback on the calling thread in the
+ * order the queries were enqueued. Results stay readable through getResult until the next execute.
+ * The scene must not be simulating or written to while execute() runs.
+ */
+class SceneQueries
+{
+public:
+    using Ticket = unsigned int;
+
+    static constexpr unsigned int MAX_OVERLAPS = 16;
+
+    struct Result
+    {
+        // closest blocking hit of a raycast or sweep
+        bool hasBlock = false;
+        physx::PxRigidActor *actor = nullptr;
+        physx::PxShape *shape = nullptr;
+        glm::vec3 position = glm::vec3(0.0f);
+        glm::vec3 normal = glm::vec3(0.0f);
+        float distance = 0.0f;
+
+        // actors touched by an overlap, at most MAX_OVERLAPS
+        unsigned int overlapCount = 0;
+        physx::PxRigidActor *overlaps[MAX_OVERLAPS] = {};
+    };
+
+    using Callback = std::function<void(const Result &)>;
+
+    explicit SceneQueries(physx::PxScene *scene);
+
+    Ticket raycast(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance,
+                   const physx::PxQueryFilterData &filter = physx::PxQueryFilterData(), Callback callback = nullptr);
+    Ticket sweep(const physx::PxGeometry &geometry, const physx::PxTransform &pose, const glm::vec3 &direction, float maxDistance,
+                 const physx::PxQueryFilterData &filter = physx::PxQueryFilterData(), Callback callback = nullptr);
+    Ticket overlap(const physx::PxGeometry &geometry, const physx::PxTransform &pose,
+                   const physx::PxQueryFilterData &filter = physx::PxQueryFilterData(), Callback callback = nullptr);
+
+    /*!
+     * Runs every enqueued query and delivers the results
+     */
+    void execute();
+
+    const Result &getResult(Ticket ticket) const { return results[ticket]; }
+
+    unsigned int getLastBatchSize() const { return lastBatchSize; }
+    float getLastBatchMilliseconds() const { return lastBatchMilliseconds; }
+
+private:
+    enum class Type
+    {
+        RAYCAST,
+        SWEEP,
+        OVERLAP
+    };
+
+    struct Query
+    {
+        Type type;
+        physx::PxGeometryHolder geometry;
+        physx::PxTransform pose;
+        physx::PxVec3 direction;
+        float maxDistance;
+        physx::PxQueryFilterData filter;
+        Callback callback;
+    };
+
+    // below this many queries a batch runs on the calling thread
+    static constexpr size_t PARALLEL_THRESHOLD = 32;
+    static constexpr size_t CHUNK_SIZE = 16;
+
+    physx::PxScene *scene;
+    std::vector<Query> queries;
+    std::vector<Result> results;
+    unsigned int lastBatchSize = 0;
+    float lastBatchMilliseconds = 0.0f;
+
+    Ticket enqueue(Query query);
+    void run(const Query &query, Result &result) const;
+};
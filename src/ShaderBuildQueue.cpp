@@ -0,0 +1,69 @@
+#include "ShaderBuildQueue.h"
+#include "PreprocessedShader.h"
+#include "ProgramCache.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+bool ShaderBuildQueue::parallelCompile = false;
+bool ShaderBuildQueue::open = false;
+std::vector<PreprocessedShader *> ShaderBuildQueue::pending;
+
+void ShaderBuildQueue::init()
+{
+    // 0xFFFFFFFF lets the implementation pick its own thread count
+    if (GLEW_KHR_parallel_shader_compile)
+    {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        parallelCompile = true;
+    }
+    else if (GLEW_ARB_parallel_shader_compile)
+    {
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+        parallelCompile = true;
+    }
+
+    std::cout << "Parallel shader compile: " << (parallelCompile ? "yes" : "no") << std::endl;
+}
+
+void ShaderBuildQueue::begin()
+{
+    open = true;
+}
+
+void ShaderBuildQueue::finish()
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    while (!pending.empty())
+    {
+        // take everything that is done, finalize() on a busy program would block on it
+        auto ready = std::stable_partition(pending.begin(), pending.end(),
+                                           [](PreprocessedShader *shader)
+                                           { return !shader->isReady(); });
+        if (ready == pending.end())
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            continue;
+        }
+
+        std::vector<PreprocessedShader *> done(ready, pending.end());
+        pending.erase(ready, pending.end());
+        for (PreprocessedShader *shader : done)
+            shader->finalize();
+    }
+    open = false;
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+    ProgramCache::addBuildTime(elapsed.count());
+}
+
+void ShaderBuildQueue::add(PreprocessedShader *shader)
+{
+    pending.push_back(shader);
+}
+
+void ShaderBuildQueue::remove(PreprocessedShader *shader)
+{
+    pending.erase(std::remove(pending.begin(), pending.end(), shader), pending.end());
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <vector>
+
+class PreprocessedShader;
+
+/*!
+ * Defers shader status checks so all compiles and links can be submitted up front.
+ * While the queue is open, PreprocessedShaders only submit their work; finish() then
+ * polls them with GL_COMPLETION_STATUS (KHR/ARB_parallel_shader_compile) and finalizes
+ * each program as the driver's compiler threads complete it. Without the extension the
+ * programs are finalized in submission order, which still lets the driver overlap them.
+ */
+class ShaderBuildQueue
+{
+public:
+    /*!
+     * Detects parallel compile support and hands the driver all compiler threads it wants
+     */
+    static void init();
+
+    static bool hasParallelCompile() { return parallelCompile; }
+
+    /*!
+     * Shaders created after this call are only submitted, they must not be used before finish()
+     */
+    static void begin();
+
+    /*!
+     * Blocks until every submitted program is linked and checked, then closes the queue
+     */
+    static void finish();
+
+    static bool isOpen() { return open; }
+
+    static void add(PreprocessedShader *shader);
+    static void remove(PreprocessedShader *shader);
+
+private:
+    static bool parallelCompile;
+    static bool open;
+    static std::vector<PreprocessedShader *> pending;
+};
@@ -0,0 +1,43 @@
+#include "ShaderPermutations.h"
+
+uint32_t ShaderPermutations::activeFeatures = SHADER_FEATURE_NONE;
+uint32_t ShaderPermutations::availableFeatures = ~uint32_t(SHADER_FEATURE_BINDLESS_TEXTURES);
+
+ShaderPermutations::ShaderPermutations(const std::string &vs, const std::string &fs, uint32_t supportedFeatures)
+    : vs(vs), fs(fs), supportedFeatures(supportedFeatures)
+{
+    // compile every variant up front, toggling a feature must not stall a frame
+    uint32_t features = supportedFeatures & availableFeatures;
+    uint32_t subset = features;
+    do
+    {
+        get(subset);
+        subset = (subset - 1) & features;
+    } while (subset != features);
+}
+
+Shader *ShaderPermutations::get(uint32_t features)
+{
+    features &= supportedFeatures & availableFeatures;
+
+    auto it = variants.find(features);
+    if (it != variants.end())
+        return it->second.get();
+
+    auto shader = std::make_unique<PreprocessedShader>(vs, fs, getDefines(features));
+    Shader *result = shader.get();
+    variants.emplace(features, std::move(shader));
+    return result;
+}
+
+std::vector<std::string> ShaderPermutations::getDefines(uint32_t features)
+{
+    std::vector<std::string> defines;
+    if (features & SHADER_FEATURE_NORMAL_MAP)
+        defines.push_back("NORMAL_MAP");
+    if (features & SHADER_FEATURE_BLOOMY_WORLD)
+        defines.push_back("BLOOMY_WORLD");
+    if (features & SHADER_FEATURE_BINDLESS_TEXTURES)
+        defines.push_back("BINDLESS_TEXTURES");
+    return defines;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "PreprocessedShader.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/*!
+ * Compile-time shader features, each one becomes a #define in the shader source
+ */
+enum ShaderFeature : uint32_t
+{
+    SHADER_FEATURE_NONE = 0,
+    SHADER_FEATURE_NORMAL_MAP = 1 << 0,   // NORMAL_MAP
+    SHADER_FEATURE_BLOOMY_WORLD = 1 << 1, // BLOOMY_WORLD
+    SHADER_FEATURE_BINDLESS_TEXTURES = 1 << 2, // BINDLESS_TEXTURES, needs ARB_bindless_texture
+};
+
+/*!
+ * Cache of all variants of one vertex/fragment shader pair.
+ * Variants are keyed by their feature bits, features a shader does not support
+ * are masked out so they share one program.
+ */
+class ShaderPermutations
+{
+public:
+    /*!
+     * @param vs: path to the vertex shader
+     * @param fs: path to the fragment shader
+     * @param supportedFeatures: ShaderFeature bits the shader source reacts to
+     */
+    ShaderPermutations(const std::string &vs, const std::string &fs, uint32_t supportedFeatures = SHADER_FEATURE_NONE);
+
+    /*!
+     * @return the variant for the given features, compiled if needed
+     */
+    Shader *get(uint32_t features);
+
+    /*!
+     * @return the variant for the globally active features
+     */
+    Shader *getActive() { return get(activeFeatures); }
+
+    uint32_t getSupportedFeatures() const { return supportedFeatures; }
+    size_t getVariantCount() const { return variants.size(); }
+
+    /*!
+     * Sets the features the renderer currently draws with (e.g. normal mapping, bloomy world)
+     */
+    static void setActiveFeatures(uint32_t features) { activeFeatures = features; }
+    static uint32_t getActiveFeatures() { return activeFeatures; }
+
+    /*!
+     * Features the driver can compile, variants using others are never built
+     */
+    static void setAvailableFeatures(uint32_t features) { availableFeatures = features; }
+
+    /*!
+     * @return the #define names for the given feature bits
+     */
+    static std::vector<std::string> getDefines(uint32_t features);
+
+private:
+    std::string vs, fs;
+    uint32_t supportedFeatures;
+    std::unordered_map<uint32_t, std::unique_ptr<PreprocessedShader>> variants;
+
+    static uint32_t activeFeatures;
+    static uint32_t availableFeatures;
+};
@@ -0,0 +1,147 @@
+#include "ShaderPreprocessor.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+bool ShaderPreprocessor::readFile(const std::string &file, std::string &content, std::string &path)
+{
+    std::vector<std::string> searchPaths = {
+        "",
+        "../",
+        "../../",
+        "../../../",
+        "assets/",
+        "../assets/",
+        "../../assets/"};
+
+    std::ifstream in;
+    for (const auto &prefix : searchPaths)
+    {
+        fs::path tryPath = prefix + file;
+        in.open(tryPath, std::ios::in | std::ios::binary);
+        if (in)
+        {
+            path = tryPath.lexically_normal().generic_string();
+            break;
+        }
+    }
+
+    if (!in)
+        return false;
+
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    content = buffer.str();
+
+    // Remove BOM if present (EF BB BF)
+    if (content.size() >= 3 &&
+        (unsigned char)content[0] == 0xEF &&
+        (unsigned char)content[1] == 0xBB &&
+        (unsigned char)content[2] == 0xBF)
+    {
+        content = content.substr(3);
+    }
+
+    return true;
+}
+
+bool ShaderPreprocessor::load(const std::string &file, const std::vector<std::string> &defines, std::string &source, std::string &path,
+                              std::vector<std::string> *files)
+{
+    std::string content;
+    if (!readFile(file, content, path))
+    {
+        std::cerr << "Cannot open shader file: " << file << std::endl;
+        return false;
+    }
+
+    std::unordered_set<std::string> included = {path};
+    std::vector<std::string> sourceFiles = {path};
+    std::string body;
+    if (!expand(path, content, body, included, sourceFiles))
+        return false;
+    if (files)
+        *files = sourceFiles;
+
+    // #version has to stay the first statement, the defines go right after it
+    std::istringstream lines(body);
+    std::string line;
+    std::ostringstream out;
+    bool versionFound = false;
+    int lineNumber = 0;
+    while (std::getline(lines, line))
+    {
+        lineNumber++;
+        out << line << "\n";
+        if (!versionFound && line.find("#version") != std::string::npos)
+        {
+            versionFound = true;
+            for (const std::string &define : defines)
+                out << "#define " << define << "\n";
+            out << "#line " << lineNumber + 1 << " 0\n";
+        }
+    }
+
+    if (!versionFound)
+    {
+        std::cerr << "Shader has no #version directive: " << path << std::endl;
+        return false;
+    }
+
+    source = out.str();
+    return true;
+}
+
+bool ShaderPreprocessor::expand(const std::string &path, const std::string &content, std::string &out,
+                                std::unordered_set<std::string> &included, std::vector<std::string> &files)
+{
+    // GLSL #line only takes a number as source name, use the index of the file
+    int fileIndex = static_cast<int>(files.size()) - 1;
+    fs::path directory = fs::path(path).parent_path();
+
+    std::istringstream lines(content);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(lines, line))
+    {
+        lineNumber++;
+
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line.compare(start, 8, "#include") != 0)
+        {
+            out += line + "\n";
+            continue;
+        }
+
+        size_t open = line.find('"', start);
+        size_t close = open == std::string::npos ? std::string::npos : line.find('"', open + 1);
+        if (close == std::string::npos)
+        {
+            std::cerr << path << "(" << lineNumber << "): malformed #include" << std::endl;
+            return false;
+        }
+        std::string name = line.substr(open + 1, close - open - 1);
+
+        std::string includeContent, includePath;
+        if (!readFile((directory / name).generic_string(), includeContent, includePath) &&
+            !readFile((directory / "include" / name).generic_string(), includeContent, includePath))
+        {
+            std::cerr << path << "(" << lineNumber << "): cannot open include file " << name << std::endl;
+            return false;
+        }
+
+        if (included.insert(includePath).second)
+        {
+            files.push_back(includePath);
+            out += "#line 1 " + std::to_string(files.size() - 1) + "\n";
+            if (!expand(includePath, includeContent, out, included, files))
+                return false;
+        }
+        out += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(fileIndex) + "\n";
+    }
+
+    return true;
+}
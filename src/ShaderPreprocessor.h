@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/*!
+ * Resolves `#include "file"` directives and injects `#define`s into GLSL sources.
+ * Includes are searched next to the including file and in its `include/` folder,
+ * every file is only included once per shader stage.
+ */
+class ShaderPreprocessor
+{
+public:
+    /*!
+     * Loads a shader file and preprocesses it
+     * @param file: path to the shader, searched like the framework searches assets
+     * @param defines: names defined right after the #version line, e.g. "NORMAL_MAP"
+     * @param source: receives the preprocessed source
+     * @param path: receives the path the shader was found at
+     * @param files: optionally receives all files that went into the source, compile errors
+     *               refer to them by their index (e.g. "2(14)" is line 14 of files[2])
+     * @return if the shader and all its includes could be read
+     */
+    static bool load(const std::string &file, const std::vector<std::string> &defines, std::string &source, std::string &path,
+                     std::vector<std::string> *files = nullptr);
+
+    /*!
+     * Reads a file from the working directory or one of its parents
+     * @return if the file could be read
+     */
+    static bool readFile(const std::string &file, std::string &content, std::string &path);
+
+private:
+    static bool expand(const std::string &path, const std::string &content, std::string &out,
+                       std::unordered_set<std::string> &included, std::vector<std::string> &files);
+};
@@ -1,7 +1,7 @@
 #include "Skybox.h"
 
 Skybox::Skybox()
-    : skyShader("assets/shaders/sky.vert", "assets/shaders/sky.frag")
+    : skyShaders("assets/shaders/sky.vert", "assets/shaders/sky.frag", SHADER_FEATURE_BLOOMY_WORLD)
 {
     float skyboxVertices[] = {
         -1.0f, 1.0f, -1.0f,
@@ -70,12 +70,12 @@ void Skybox::draw(const glm::mat4 &viewProjMatrix, bool inBloomyWorld)
 
     glDepthFunc(GL_LEQUAL);
     glDepthMask(GL_FALSE);
-    skyShader.use();
+    Shader *skyShader = skyShaders.get(inBloomyWorld ? SHADER_FEATURE_BLOOMY_WORLD : SHADER_FEATURE_NONE);
+    skyShader->use();
 
-    skyShader.setUniform("addNoise", inBloomyWorld);
-    skyShader.setUniform("viewProjMatrix", viewProjMatrix);
-    skyShader.setUniform("fogColor", fogColor);
-    skyShader.setUniform("skyColor", skyColor);
+    skyShader->setUniform("viewProjMatrix", viewProjMatrix);
+    skyShader->setUniform("fogColor", fogColor);
+    skyShader->setUniform("skyColor", skyColor);
 
     glBindVertexArray(vao);
 
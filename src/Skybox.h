@@ -1,7 +1,7 @@
 #pragma once
 #include <glm/glm.hpp>
 #include <GL/glew.h>
-#include "Shader.h"
+#include "ShaderPermutations.h"
 class Skybox
 {
 public:
@@ -11,5 +11,5 @@ public:
 
 private:
   GLuint vao, vbo;
-  Shader skyShader;
+  ShaderPermutations skyShaders;
 };
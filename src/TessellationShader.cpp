@@ -1,4 +1,5 @@
 #include "TessellationShader.h"
+#include "ShaderPreprocessor.h"
 
 TessellationShader::TessellationShader(
     const std::string &vs,
@@ -66,52 +67,9 @@ TessellationShader::TessellationShader(
 
 bool TessellationShader::loadShader(const std::string &file, GLenum shaderType, GLuint &handle)
 {
-    namespace fs = std::filesystem;
-
-    std::vector<std::string> searchPaths = {
-        "",
-        "../",
-        "../../",
-        "../../../",
-        "assets/",
-        "../assets/",
-        "../../assets/"};
-
-    std::ifstream in;
-    std::string fullPath;
-
-    for (const auto &prefix : searchPaths)
-    {
-        fs::path tryPath = prefix + file;
-        in.open(tryPath, std::ios::in | std::ios::binary);
-        if (in)
-        {
-            fullPath = tryPath.string();
-            break;
-        }
-    }
-
-    if (!in)
-    {
-        std::cerr << "Cannot open shader file: " << file << std::endl;
+    std::string source, fullPath;
+    if (!ShaderPreprocessor::load(file, {}, source, fullPath))
         return false;
-    }
-
-    std::string source;
-    in.seekg(0, std::ios::end);
-    source.resize(in.tellg());
-    in.seekg(0, std::ios::beg);
-    in.read(&source[0], source.size());
-    in.close();
-
-    // Remove BOM if present (EF BB BF)
-    if (source.size() >= 3 &&
-        (unsigned char)source[0] == 0xEF &&
-        (unsigned char)source[1] == 0xBB &&
-        (unsigned char)source[2] == 0xBF)
-    {
-        source = source.substr(3);
-    }
 
     const char *src = source.c_str();
     handle = glCreateShader(shaderType);
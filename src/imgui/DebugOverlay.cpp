@@ -0,0 +1,67 @@
+#include "DebugOverlay.h"
+
+void DebugOverlay::Render(const FrameStats &stats)
+{
+    ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_Always);
+    ImGui::SetNextWindowBgAlpha(0.3f);
+
+    ImGui::Begin("Performance", nullptr,
+                 ImGuiWindowFlags_NoTitleBar |
+                     ImGuiWindowFlags_AlwaysAutoResize |
+                     ImGuiWindowFlags_NoResize |
+                     ImGuiWindowFlags_NoMove |
+                     ImGuiWindowFlags_NoSavedSettings |
+                     ImGuiWindowFlags_NoFocusOnAppearing);
+
+    ImGui::Text("%.0f FPS (%.2f ms)", stats.fps, stats.frameMs);
+    ImGui::Text("Input latency ~%.1f ms", stats.latencyMs);
+    if (stats.fpsLimit > 0)
+        ImGui::Text("  vsync %s, limit %d fps, low latency %s", stats.vsync, stats.fpsLimit, stats.lowLatency ? "on" : "off");
+    else
+        ImGui::Text("  vsync %s, no limit, low latency %s", stats.vsync, stats.lowLatency ? "on" : "off");
+    ImGui::Separator();
+
+    ImGui::Text("Depth pre-pass: %s", stats.depthPrepassEnabled ? "on" : "off");
+    if (stats.depthPrepassEnabled)
+        ImGui::Text("  pre-pass     %.2f ms", stats.depthPrepassMs);
+    ImGui::Text("  color pass   %.2f ms", stats.colorPassMs);
+
+    // both modes need a measurement before the savings can be estimated
+    if (stats.colorPassMsWithPrepass > 0.0f && stats.colorPassMsWithoutPrepass > 0.0f)
+    {
+        float withPrepass = stats.colorPassMsWithPrepass + stats.depthPrepassMs;
+        ImGui::Text("  saved        %.2f ms", stats.colorPassMsWithoutPrepass - withPrepass);
+    }
+    else
+    {
+        ImGui::TextDisabled("  toggle the pre-pass to measure savings");
+    }
+
+    ImGui::Separator();
+    ImGui::Text("Point lights: %u (%u cluster entries)", stats.lightCount, stats.lightAssignments);
+    ImGui::Text("Draw records: %u (%s)", stats.drawRecords, stats.drawDataPersistent ? "persistent" : "mapped per frame");
+    ImGui::Text("Draw list rebuilds: %u", stats.drawListRebuilds);
+    ImGui::Text("Scene queries: %u (%.3f ms)", stats.sceneQueries, stats.sceneQueryMs);
+    if (stats.checkpointBytes)
+        ImGui::Text("Checkpoint: %u bytes (%.3f ms)", stats.checkpointBytes, stats.checkpointMs);
+    if (stats.occlusionCulling)
+    {
+        ImGui::Text("Occlusion: %u of %u hidden, %u outside view", stats.occlusionCulled, stats.occlusionTested, stats.outsideView);
+        ImGui::Text("  occluders    %u (%u triangles), %.2f ms CPU", stats.occluders, stats.occluderTriangles, stats.occlusionMs);
+    }
+    else
+    {
+        ImGui::TextDisabled("Occlusion culling off");
+    }
+    if (stats.msaaSamples > 0)
+        ImGui::Text("Anti-aliasing: %s %dx", stats.antialiasing, stats.msaaSamples);
+    else
+        ImGui::Text("Anti-aliasing: %s", stats.antialiasing);
+    ImGui::Text("Render size: %dx%d (%s)", stats.renderWidth, stats.renderHeight, stats.dynamicResolution ? "dynamic" : "fixed");
+    ImGui::Text("  GPU frame    %.2f ms (target %.2f ms)", stats.gpuFrameMs, stats.targetFrameMs);
+    ImGui::Text("Render graph: %d passes (%d culled)", stats.graphPasses, stats.graphCulledPasses);
+    ImGui::Text("  targets      %d, %.1f MB (%.1f MB unaliased)", stats.renderTargets,
+                stats.renderTargetBytes / (1024.0f * 1024.0f), stats.renderTargetBytesUnaliased / (1024.0f * 1024.0f));
+
+    ImGui::End();
+}
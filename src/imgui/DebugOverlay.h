@@ -0,0 +1,9 @@
+#pragma once
+#include <imgui.h>
+#include "../Render/FrameStats.h"
+
+class DebugOverlay
+{
+public:
+    void Render(const FrameStats &stats);
+};
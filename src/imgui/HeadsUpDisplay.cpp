@@ -33,7 +33,7 @@ void HeadsUpDisplay::RenderControlsGuide()
 {
     ImGuiIO &io = ImGui::GetIO();
 
-    ImVec2 windowSize(300, 200);
+    ImVec2 windowSize(300, 240);
     ImVec2 centerPos = ImVec2(
         (io.DisplaySize.x - windowSize.x) * 0.5f,
         (io.DisplaySize.y - windowSize.y) * 0.5f);
@@ -62,6 +62,13 @@ void HeadsUpDisplay::RenderControlsGuide()
     ImGui::Text("ESC - toggle pause");
     ImGui::Text("Q - toggle controls guide");
     ImGui::Text("N - toggle normal mapping");
+    ImGui::Text("F1 - toggle performance overlay");
+    ImGui::Text("F2 - toggle depth pre-pass");
+    ImGui::Text("F3 - cycle anti-aliasing (off, MSAA, FXAA)");
+    ImGui::Text("F4 - toggle dynamic resolution");
+    ImGui::Text("F5 - save checkpoint");
+    ImGui::Text("F6 - toggle physics panel (F7 dump, F8 record CSV)");
+    ImGui::Text("F9 - load checkpoint");
 
     ImGui::End();
 }
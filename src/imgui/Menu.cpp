@@ -179,13 +179,24 @@ void Menu::RenderGameOverMenu()
     ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(1.0f, 1.0f, 1.0f, 1.0f));
     ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.7f, 0.7f, 0.7f, 1.0f));
 
-    ImGui::SetCursorPos(ImVec2(center.x - buttonWidth * 0.5f, blockStartY));
+    float buttonY = blockStartY;
+    if (canRetryCheckpoint)
+    {
+        ImGui::SetCursorPos(ImVec2(center.x - buttonWidth * 0.5f, buttonY));
+        if (ImGui::Button("Retry from Checkpoint", ImVec2(buttonWidth, buttonHeight)))
+        {
+            g_GameState = GameState::RetryingCheckpoint;
+        }
+        buttonY += buttonHeight + buttonSpacing;
+    }
+
+    ImGui::SetCursorPos(ImVec2(center.x - buttonWidth * 0.5f, buttonY));
     if (ImGui::Button("New Game", ImVec2(buttonWidth, buttonHeight)))
     {
         g_GameState = GameState::Restarting;
     }
 
-    ImGui::SetCursorPos(ImVec2(center.x - buttonWidth * 0.5f, blockStartY + buttonHeight + buttonSpacing));
+    ImGui::SetCursorPos(ImVec2(center.x - buttonWidth * 0.5f, buttonY + buttonHeight + buttonSpacing));
 
     if (ImGui::Button("Quit", ImVec2(buttonWidth, buttonHeight)))
     {
@@ -244,14 +255,25 @@ void Menu::RenderPauseMenu()
         g_GameState = GameState::Playing;
     }
 
-    ImGui::SetCursorPos(ImVec2(center.x - buttonWidth * 0.5f, blockStartY + buttonHeight + buttonSpacing));
+    float buttonY = blockStartY + buttonHeight + buttonSpacing;
+    if (canRetryCheckpoint)
+    {
+        ImGui::SetCursorPos(ImVec2(center.x - buttonWidth * 0.5f, buttonY));
+        if (ImGui::Button("Retry from Checkpoint", ImVec2(buttonWidth, buttonHeight)))
+        {
+            g_GameState = GameState::RetryingCheckpoint;
+        }
+        buttonY += buttonHeight + buttonSpacing;
+    }
+
+    ImGui::SetCursorPos(ImVec2(center.x - buttonWidth * 0.5f, buttonY));
 
     if (ImGui::Button("Restart", ImVec2(buttonWidth, buttonHeight)))
     {
         g_GameState = GameState::Restarting;
     }
 
-    ImGui::SetCursorPos(ImVec2(center.x - buttonWidth * 0.5f, blockStartY + buttonHeight * 2 + buttonSpacing * 2));
+    ImGui::SetCursorPos(ImVec2(center.x - buttonWidth * 0.5f, buttonY + buttonHeight + buttonSpacing));
     if (ImGui::Button("Quit", ImVec2(buttonWidth, buttonHeight)))
     {
         g_GameState = GameState::Quitting;
@@ -11,6 +11,8 @@ public:
     void Render();
     bool startGame = false;
     bool quitGame = false;
+    // the game over and pause menus offer a retry from the last checkpoint when there is one
+    bool canRetryCheckpoint = false;
 
 private:
     void RenderGameOverMenu();
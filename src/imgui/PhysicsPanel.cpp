@@ -0,0 +1,69 @@
+#include "PhysicsPanel.h"
+#include "../PhysicsTelemetry.h"
+#include <cfloat>
+#include <cstdio>
+
+namespace
+{
+    template <typename T>
+    void plot(const char *label, T PhysicsTelemetry::Sample::*field)
+    {
+        auto getter = [](void *data, int index) -> float
+        {
+            auto member = *static_cast<T PhysicsTelemetry::Sample::**>(data);
+            return static_cast<float>(PhysicsTelemetry::getSample(index).*member);
+        };
+
+        char overlay[32];
+        std::snprintf(overlay, sizeof(overlay), "%.2f", static_cast<float>(PhysicsTelemetry::getLatest().*field));
+        ImGui::PlotLines(label, getter, &field, PhysicsTelemetry::getCount(), 0, overlay, 0.0f, FLT_MAX, ImVec2(0, 40));
+    }
+}
+
+void PhysicsPanel::Render()
+{
+    ImGui::SetNextWindowPos(ImVec2(ImGui::GetIO().DisplaySize.x - 10, 10), ImGuiCond_Always, ImVec2(1.0f, 0.0f));
+    ImGui::SetNextWindowBgAlpha(0.3f);
+
+    ImGui::Begin("Physics", nullptr,
+                 ImGuiWindowFlags_NoTitleBar |
+                     ImGuiWindowFlags_AlwaysAutoResize |
+                     ImGuiWindowFlags_NoResize |
+                     ImGuiWindowFlags_NoMove |
+                     ImGuiWindowFlags_NoSavedSettings |
+                     ImGuiWindowFlags_NoFocusOnAppearing);
+
+    if (PhysicsTelemetry::getCount() == 0)
+    {
+        ImGui::TextDisabled("waiting for the first step");
+        ImGui::End();
+        return;
+    }
+
+    const PhysicsTelemetry::Sample &latest = PhysicsTelemetry::getLatest();
+    ImGui::Text("Step: simulate %.3f ms, fetchResults %.3f ms", latest.simulateMs, latest.fetchResultsMs);
+    ImGui::Text("Bodies: %u of %u dynamic active, %u static", latest.activeDynamicBodies, latest.dynamicBodies, latest.staticBodies);
+    ImGui::Text("Broadphase: %u added, %u removed", latest.broadPhaseAdds, latest.broadPhaseRemoves);
+    ImGui::Text("Contact pairs: %u (%u touching), %u new / %u lost touches", latest.contactPairs, latest.contactPairsTouching,
+                latest.newTouches, latest.lostTouches);
+    ImGui::Text("Filter shader: %u pairs killed", latest.killedPairs);
+    ImGui::Text("Solver partitions: %u", latest.partitions);
+    ImGui::Text("Controller moves: %u, scene queries: %u", latest.controllerMoves, latest.sceneQueries);
+
+    ImGui::Separator();
+    plot("simulate ms", &PhysicsTelemetry::Sample::simulateMs);
+    plot("fetchResults ms", &PhysicsTelemetry::Sample::fetchResultsMs);
+    plot("active bodies", &PhysicsTelemetry::Sample::activeDynamicBodies);
+    plot("contact pairs", &PhysicsTelemetry::Sample::contactPairs);
+    plot("killed pairs", &PhysicsTelemetry::Sample::killedPairs);
+    plot("scene queries", &PhysicsTelemetry::Sample::sceneQueries);
+
+    ImGui::Separator();
+    // the cursor is captured while playing, so the CSV output is driven by keys
+    if (PhysicsTelemetry::isWritingCsv())
+        ImGui::Text("F7 - dump history, F8 - stop recording CSV");
+    else
+        ImGui::Text("F7 - dump history, F8 - record CSV");
+
+    ImGui::End();
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include <imgui.h>
+
+/*!
+ * Physics telemetry of the last steps, see PhysicsTelemetry
+ */
+class PhysicsPanel
+{
+public:
+    void Render();
+};